@@ -0,0 +1,93 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Generates a perfect hash table header from a list of names. Runs as a custom
+* build step in Utilities for every *.txt name list, e.g.
+* HashTableGenerator EventTypes.txt EVENT_TYPES EventTypes.h
+* The list has one name per line, empty lines and lines starting with # are
+* skipped. Returns a non-zero exit code, which fails the build, if two names
+* collide or the header couldn't be written.
+*/
+
+#include "../Utilities/PerfectHash.h"
+#include "../Utilities/Macros.h"
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace utilities;
+
+namespace
+{
+/** Characters that are trimmed from the start and end of a line */
+const char* const WHITESPACE = " \t\r";
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 4)
+	{
+		std::cerr << "Usage: HashTableGenerator <name list> <table name> <header>" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const char* pListPath = argv[1];
+	const char* pTableName = argv[2];
+	const char* pHeaderPath = argv[3];
+
+	std::ifstream file(pListPath);
+	if (!file.is_open())
+	{
+		ERROR_MESSAGE("HashTableGenerator: Couldn't open " << pListPath);
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::string> names;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		size_t first = line.find_first_not_of(WHITESPACE);
+		if (first == std::string::npos || line[first] == '#')
+		{
+			continue;
+		}
+		size_t last = line.find_last_not_of(WHITESPACE);
+		names.push_back(line.substr(first, last - first + 1));
+	}
+
+	std::vector<const char*> nameStrings(names.size());
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		nameStrings[i] = names[i].c_str();
+	}
+
+	// An empty list gives a header with an #error, which also fails the build
+	const char* const* ppNames = nameStrings.empty() ? NULL : &nameStrings[0];
+	if (!PerfectHashTable::writeHeader(ppNames, static_cast<int>(names.size()), pTableName, pHeaderPath))
+	{
+		ERROR_MESSAGE("HashTableGenerator: " << pListPath << ": Couldn't generate " << pHeaderPath);
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "HashTableGenerator: " << pHeaderPath << " has " << names.size() << " names" << std::endl;
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
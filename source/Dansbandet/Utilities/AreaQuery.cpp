@@ -0,0 +1,331 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Area of effect tests for weapons: a cone for the flamethrower, a cylinder for
+* the pulse cannon and a line for the beam cannon.
+*/
+
+#include "AreaQuery.h"
+#include "SpatialGrid.h"
+#include "CoordinateConversion.h"
+#include <emmintrin.h>
+#include <cmath>
+
+using namespace utilities;
+
+namespace
+{
+/**
+* Returns the direction projected to the xz-plane and normalized
+*/
+Vec3Float getXZDirection(const Vec3Float& direction)
+{
+	Vec3Float xzDirection(direction.x, 0.0f, direction.z);
+	xzDirection.normalize();
+	return xzDirection;
+}
+
+/**
+* Loads the last positions that don't fill a whole register, the rest is set to 0
+*/
+inline __m128 loadPartial(const float* pValues, int cValues)
+{
+	float values[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	for (int i = 0; i < cValues; i++)
+	{
+		values[i] = pValues[i];
+	}
+	return _mm_loadu_ps(values);
+}
+
+/**
+* The kernels test four positions relative to an area and return a mask that
+* is all ones for the positions inside. getBounds() returns a box that contains
+* the whole area, used to select the cells of a SpatialGrid.
+*/
+class ConeKernel
+{
+public:
+	ConeKernel(const ConeArea& area) : mArea(area)
+	{
+		mOriginX = _mm_set1_ps(area.origin.x);
+		mOriginZ = _mm_set1_ps(area.origin.z);
+		mDirectionX = _mm_set1_ps(area.direction.x);
+		mDirectionZ = _mm_set1_ps(area.direction.z);
+		mLengthSquared = _mm_set1_ps(area.length * area.length);
+		mCosSquared = _mm_set1_ps(area.cosHalfAngle * area.cosHalfAngle);
+		mWide = area.cosHalfAngle < 0.0f;
+	}
+
+	inline __m128 test(__m128 x, __m128 z) const
+	{
+		__m128 diffX = _mm_sub_ps(x, mOriginX);
+		__m128 diffZ = _mm_sub_ps(z, mOriginZ);
+		__m128 distanceSquared = _mm_add_ps(_mm_mul_ps(diffX, diffX), _mm_mul_ps(diffZ, diffZ));
+		__m128 dot = _mm_add_ps(_mm_mul_ps(diffX, mDirectionX), _mm_mul_ps(diffZ, mDirectionZ));
+
+		// dot >= cos * distance without the square root, squaring flips the
+		// comparison for the negative side of a cone wider than 180 degrees
+		__m128 inFront = _mm_cmpge_ps(dot, _mm_setzero_ps());
+		__m128 dotSquared = _mm_mul_ps(dot, dot);
+		__m128 limit = _mm_mul_ps(mCosSquared, distanceSquared);
+		__m128 inAngle = mWide ?
+			_mm_or_ps(inFront, _mm_cmple_ps(dotSquared, limit)) :
+			_mm_and_ps(inFront, _mm_cmpge_ps(dotSquared, limit));
+		return _mm_and_ps(inAngle, _mm_cmple_ps(distanceSquared, mLengthSquared));
+	}
+
+	void getBounds(Vec3Float& min, Vec3Float& max) const
+	{
+		min = Vec3Float(mArea.origin.x - mArea.length, 0.0f, mArea.origin.z - mArea.length);
+		max = Vec3Float(mArea.origin.x + mArea.length, 0.0f, mArea.origin.z + mArea.length);
+	}
+
+private:
+	const ConeArea& mArea;
+	__m128 mOriginX;
+	__m128 mOriginZ;
+	__m128 mDirectionX;
+	__m128 mDirectionZ;
+	__m128 mLengthSquared;
+	__m128 mCosSquared;
+	bool mWide;
+
+	// Not assignable
+	ConeKernel& operator=(const ConeKernel&);
+};
+
+/**
+* Base for the kernels of CylinderArea and LineArea, which have the same shape
+* parameters
+*/
+class SegmentKernel
+{
+public:
+	SegmentKernel(const Vec3Float& origin, const Vec3Float& direction, float length, float radius) :
+		mStart(origin), mEnd(origin + direction * length), mRadius(radius)
+	{
+		mOriginX = _mm_set1_ps(origin.x);
+		mOriginZ = _mm_set1_ps(origin.z);
+		mDirectionX = _mm_set1_ps(direction.x);
+		mDirectionZ = _mm_set1_ps(direction.z);
+		mLength = _mm_set1_ps(length);
+		mRadiusSquared = _mm_set1_ps(radius * radius);
+	}
+
+	void getBounds(Vec3Float& min, Vec3Float& max) const
+	{
+		min = Vec3Float((std::min)(mStart.x, mEnd.x) - mRadius, 0.0f, (std::min)(mStart.z, mEnd.z) - mRadius);
+		max = Vec3Float((std::max)(mStart.x, mEnd.x) + mRadius, 0.0f, (std::max)(mStart.z, mEnd.z) + mRadius);
+	}
+
+protected:
+	Vec3Float mStart;
+	Vec3Float mEnd;
+	float mRadius;
+	__m128 mOriginX;
+	__m128 mOriginZ;
+	__m128 mDirectionX;
+	__m128 mDirectionZ;
+	__m128 mLength;
+	__m128 mRadiusSquared;
+};
+
+class CylinderKernel : public SegmentKernel
+{
+public:
+	CylinderKernel(const CylinderArea& area) : SegmentKernel(area.origin, area.direction, area.length, area.radius) {}
+
+	inline __m128 test(__m128 x, __m128 z) const
+	{
+		__m128 diffX = _mm_sub_ps(x, mOriginX);
+		__m128 diffZ = _mm_sub_ps(z, mOriginZ);
+		__m128 along = _mm_add_ps(_mm_mul_ps(diffX, mDirectionX), _mm_mul_ps(diffZ, mDirectionZ));
+		__m128 side = _mm_sub_ps(_mm_mul_ps(diffX, mDirectionZ), _mm_mul_ps(diffZ, mDirectionX));
+		__m128 inLength = _mm_and_ps(_mm_cmpge_ps(along, _mm_setzero_ps()), _mm_cmple_ps(along, mLength));
+		return _mm_and_ps(inLength, _mm_cmple_ps(_mm_mul_ps(side, side), mRadiusSquared));
+	}
+};
+
+class LineKernel : public SegmentKernel
+{
+public:
+	LineKernel(const LineArea& area) : SegmentKernel(area.origin, area.direction, area.length, area.radius) {}
+
+	inline __m128 test(__m128 x, __m128 z) const
+	{
+		// Distance to the closest point on the segment
+		__m128 diffX = _mm_sub_ps(x, mOriginX);
+		__m128 diffZ = _mm_sub_ps(z, mOriginZ);
+		__m128 along = _mm_add_ps(_mm_mul_ps(diffX, mDirectionX), _mm_mul_ps(diffZ, mDirectionZ));
+		along = _mm_min_ps(_mm_max_ps(along, _mm_setzero_ps()), mLength);
+		__m128 closestX = _mm_sub_ps(diffX, _mm_mul_ps(along, mDirectionX));
+		__m128 closestZ = _mm_sub_ps(diffZ, _mm_mul_ps(along, mDirectionZ));
+		__m128 distanceSquared = _mm_add_ps(_mm_mul_ps(closestX, closestX), _mm_mul_ps(closestZ, closestZ));
+		return _mm_cmple_ps(distanceSquared, mRadiusSquared);
+	}
+};
+
+template <typename Kernel>
+void getHitMaskWithKernel(const Kernel& kernel, const float* pX, const float* pZ, int cPositions, unsigned int* pHitMask)
+{
+	int cWords = (cPositions + 31) / 32;
+	for (int i = 0; i < cWords; i++)
+	{
+		pHitMask[i] = 0;
+	}
+
+	int cBatched = cPositions & ~3;
+	for (int i = 0; i < cBatched; i += 4)
+	{
+		unsigned int hits = _mm_movemask_ps(kernel.test(_mm_loadu_ps(pX + i), _mm_loadu_ps(pZ + i)));
+		pHitMask[i >> 5] |= hits << (i & 31);
+	}
+
+	if (cBatched < cPositions)
+	{
+		int cLeft = cPositions - cBatched;
+		unsigned int hits = _mm_movemask_ps(kernel.test(loadPartial(pX + cBatched, cLeft), loadPartial(pZ + cBatched, cLeft)));
+		hits &= (1u << cLeft) - 1;
+		pHitMask[cBatched >> 5] |= hits << (cBatched & 31);
+	}
+}
+
+/**
+* Writes the indices, or the handles if pHandles isn't NULL, of the positions
+* inside the area to pHits
+*/
+template <typename Kernel>
+int findHitsWithKernel(const Kernel& kernel, const float* pX, const float* pZ, int cPositions, const int* pHandles, int* pHits)
+{
+	int cHits = 0;
+	for (int i = 0; i < cPositions; i += 4)
+	{
+		int cLeft = cPositions - i;
+		int hits = 0;
+		if (cLeft >= 4)
+		{
+			hits = _mm_movemask_ps(kernel.test(_mm_loadu_ps(pX + i), _mm_loadu_ps(pZ + i)));
+		}
+		else
+		{
+			hits = _mm_movemask_ps(kernel.test(loadPartial(pX + i, cLeft), loadPartial(pZ + i, cLeft)));
+			hits &= (1 << cLeft) - 1;
+		}
+
+		for (int lane = 0; hits != 0; lane++, hits >>= 1)
+		{
+			if (hits & 1)
+			{
+				pHits[cHits] = pHandles != NULL ? pHandles[i + lane] : i + lane;
+				cHits++;
+			}
+		}
+	}
+	return cHits;
+}
+
+template <typename Kernel>
+int findHitsInGrid(const Kernel& kernel, const SpatialGrid& grid, std::vector<int>& handles)
+{
+	Vec3Float minBounds;
+	Vec3Float maxBounds;
+	kernel.getBounds(minBounds, maxBounds);
+	SpatialGrid::SpanIterator it = grid.queryRectangle(minBounds.convertToMapCoordinates(), maxBounds.convertToMapCoordinates());
+
+	// Each row of cells is contiguous in the grid, room is made for all of
+	// them before testing and the handles are then shrunk to the hits.
+	handles.clear();
+	int cHits = 0;
+	int begin = 0;
+	int end = 0;
+	while (it.next(begin, end))
+	{
+		handles.resize(cHits + end - begin);
+		cHits += findHitsWithKernel(kernel, grid.getX() + begin, grid.getZ() + begin, end - begin, grid.getHandles() + begin, &handles[cHits]);
+	}
+	handles.resize(cHits);
+	return cHits;
+}
+}
+
+ConeArea::ConeArea(const Vec3Float& origin, const Vec3Float& direction, float length, float halfAngle) :
+	origin(origin), direction(getXZDirection(direction)), length(length), cosHalfAngle(cosf(halfAngle))
+{
+}
+
+CylinderArea::CylinderArea(const Vec3Float& origin, const Vec3Float& direction, float length, float radius) :
+	origin(origin), direction(getXZDirection(direction)), length(length), radius(radius)
+{
+}
+
+LineArea::LineArea(const Vec3Float& start, const Vec3Float& end, float radius) :
+	origin(start), direction(getXZDirection(end - start)), radius(radius)
+{
+	float diffX = end.x - start.x;
+	float diffZ = end.z - start.z;
+	length = sqrtf(diffX * diffX + diffZ * diffZ);
+}
+
+void utilities::getHitMask(const ConeArea& area, const float* pX, const float* pZ, int cPositions, unsigned int* pHitMask)
+{
+	getHitMaskWithKernel(ConeKernel(area), pX, pZ, cPositions, pHitMask);
+}
+
+void utilities::getHitMask(const CylinderArea& area, const float* pX, const float* pZ, int cPositions, unsigned int* pHitMask)
+{
+	getHitMaskWithKernel(CylinderKernel(area), pX, pZ, cPositions, pHitMask);
+}
+
+void utilities::getHitMask(const LineArea& area, const float* pX, const float* pZ, int cPositions, unsigned int* pHitMask)
+{
+	getHitMaskWithKernel(LineKernel(area), pX, pZ, cPositions, pHitMask);
+}
+
+int utilities::findHits(const ConeArea& area, const Vec3FloatArray& positions, int* pHitIndices)
+{
+	return findHitsWithKernel(ConeKernel(area), positions.getX(), positions.getZ(), positions.size(), NULL, pHitIndices);
+}
+
+int utilities::findHits(const CylinderArea& area, const Vec3FloatArray& positions, int* pHitIndices)
+{
+	return findHitsWithKernel(CylinderKernel(area), positions.getX(), positions.getZ(), positions.size(), NULL, pHitIndices);
+}
+
+int utilities::findHits(const LineArea& area, const Vec3FloatArray& positions, int* pHitIndices)
+{
+	return findHitsWithKernel(LineKernel(area), positions.getX(), positions.getZ(), positions.size(), NULL, pHitIndices);
+}
+
+int utilities::findHits(const ConeArea& area, const SpatialGrid& grid, std::vector<int>& handles)
+{
+	return findHitsInGrid(ConeKernel(area), grid, handles);
+}
+
+int utilities::findHits(const CylinderArea& area, const SpatialGrid& grid, std::vector<int>& handles)
+{
+	return findHitsInGrid(CylinderKernel(area), grid, handles);
+}
+
+int utilities::findHits(const LineArea& area, const SpatialGrid& grid, std::vector<int>& handles)
+{
+	return findHitsInGrid(LineKernel(area), grid, handles);
+}
\ No newline at end of file
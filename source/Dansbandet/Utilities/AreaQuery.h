@@ -0,0 +1,164 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Area of effect tests for weapons: a cone for the flamethrower, a cylinder for
+* the pulse cannon and a line for the beam cannon.
+*/
+
+#ifndef __AREA_QUERY_H__
+#define __AREA_QUERY_H__
+
+#include "Vec3FloatArray.h"
+#include <vector>
+
+namespace utilities
+{
+
+class SpatialGrid;
+
+/**
+* A cone in the xz-plane, i.e. a circle sector. A position is inside if it's
+* within length of the origin and within the half angle of the direction.
+*/
+struct ConeArea
+{
+	Vec3Float origin;		/**< The tip of the cone */
+	Vec3Float direction;	/**< Normalized direction in the xz-plane */
+	float length;			/**< Distance from the tip to the end of the cone */
+	float cosHalfAngle;		/**< Cosine of the angle between the direction and the side */
+
+	/**
+	* Constructor
+	* @param origin the tip of the cone
+	* @param direction the direction of the cone, doesn't need to be normalized
+	* @param length distance from the tip to the end of the cone
+	* @param halfAngle angle between the direction and the side in radians, 0 to PI
+	*/
+	ConeArea(const Vec3Float& origin, const Vec3Float& direction, float length, float halfAngle);
+};
+
+/**
+* A cylinder lying in the xz-plane in front of its origin, seen from above it's
+* a rectangle. A position is inside if it's within length along the direction
+* and within radius to the side.
+*/
+struct CylinderArea
+{
+	Vec3Float origin;		/**< Center of the near end of the cylinder */
+	Vec3Float direction;	/**< Normalized direction in the xz-plane */
+	float length;			/**< Length of the cylinder */
+	float radius;			/**< Radius of the cylinder */
+
+	/**
+	* Constructor
+	* @param origin center of the near end of the cylinder
+	* @param direction the direction of the cylinder, doesn't need to be normalized
+	* @param length length of the cylinder
+	* @param radius radius of the cylinder
+	*/
+	CylinderArea(const Vec3Float& origin, const Vec3Float& direction, float length, float radius);
+};
+
+/**
+* A line segment with a thickness in the xz-plane. A position is inside if its
+* distance to the segment is at most radius, so the ends are rounded.
+*/
+struct LineArea
+{
+	Vec3Float origin;		/**< Start of the line */
+	Vec3Float direction;	/**< Normalized direction from the start to the end in the xz-plane */
+	float length;			/**< Length of the line */
+	float radius;			/**< Half the thickness of the line */
+
+	/**
+	* Constructor
+	* @param start start of the line
+	* @param end end of the line
+	* @param radius half the thickness of the line
+	*/
+	LineArea(const Vec3Float& start, const Vec3Float& end, float radius);
+};
+
+/**
+* Tests positions against an area, four at a time with SSE. The y-values are
+* ignored. Bit i % 32 of pHitMask[i / 32] is set if position i is inside.
+* @param area the area to test against
+* @param pX the x-values of the positions
+* @param pZ the z-values of the positions
+* @param cPositions number of positions
+* @param pHitMask array with room for (cPositions + 31) / 32 words
+*/
+void getHitMask(const ConeArea& area, const float* pX, const float* pZ, int cPositions, unsigned int* pHitMask);
+
+/**
+* @see getHitMask(const ConeArea&, const float*, const float*, int, unsigned int*)
+*/
+void getHitMask(const CylinderArea& area, const float* pX, const float* pZ, int cPositions, unsigned int* pHitMask);
+
+/**
+* @see getHitMask(const ConeArea&, const float*, const float*, int, unsigned int*)
+*/
+void getHitMask(const LineArea& area, const float* pX, const float* pZ, int cPositions, unsigned int* pHitMask);
+
+/**
+* Finds the positions inside an area, four at a time with SSE. The y-values
+* are ignored.
+* @param area the area to test against
+* @param positions the positions to test
+* @param pHitIndices array with room for positions.size() indices, filled with
+* the indices of the positions inside the area in increasing order
+* @return number of positions inside the area
+*/
+int findHits(const ConeArea& area, const Vec3FloatArray& positions, int* pHitIndices);
+
+/**
+* @see findHits(const ConeArea&, const Vec3FloatArray&, int*)
+*/
+int findHits(const CylinderArea& area, const Vec3FloatArray& positions, int* pHitIndices);
+
+/**
+* @see findHits(const ConeArea&, const Vec3FloatArray&, int*)
+*/
+int findHits(const LineArea& area, const Vec3FloatArray& positions, int* pHitIndices);
+
+/**
+* Finds the entities inside an area, only the cells of the grid that overlap
+* the bounding box of the area are tested.
+* @param area the area to test against
+* @param grid the grid with the entities
+* @param handles cleared and filled with the handles of the entities inside
+* the area, in the order they're stored in the grid
+* @return number of entities inside the area
+*/
+int findHits(const ConeArea& area, const SpatialGrid& grid, std::vector<int>& handles);
+
+/**
+* @see findHits(const ConeArea&, const SpatialGrid&, std::vector<int>&)
+*/
+int findHits(const CylinderArea& area, const SpatialGrid& grid, std::vector<int>& handles);
+
+/**
+* @see findHits(const ConeArea&, const SpatialGrid&, std::vector<int>&)
+*/
+int findHits(const LineArea& area, const SpatialGrid& grid, std::vector<int>& handles);
+}
+
+#endif
\ No newline at end of file
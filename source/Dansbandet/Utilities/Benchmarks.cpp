@@ -0,0 +1,462 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Benchmarks for the performance critical parts of the utilities. They are not run
+* automatically, call them from a debug build or a tool when you change the code
+* they measure.
+*/
+
+#include "Benchmarks.h"
+#include "GridAStar.h"
+#include "JumpPointSearch.h"
+#include "Vectors.h"
+#include "SweepAndPrune.h"
+#include "HashedString.h"
+#include "Timer.h"
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+
+using namespace utilities;
+using namespace utilities::benchmark;
+
+namespace
+{
+/**
+* Small linear congruential generator so the benchmarks are repeatable and don't
+* disturb the global rand() state.
+*/
+class BenchmarkRandom
+{
+public:
+	BenchmarkRandom(unsigned int seed) : mState(seed) {}
+
+	inline int next(int max)
+	{
+		mState = mState * 1664525u + 1013904223u;
+		return static_cast<int>((mState >> 8) % static_cast<unsigned int>(max));
+	}
+
+private:
+	unsigned int mState;
+};
+
+/**
+* Checks if all walkable cells have the same cost
+*/
+bool hasUniformCost(const PathCostMap& costMap)
+{
+	unsigned char uniformCost = PATH_COST_BLOCKED;
+	for (int y = 0; y < costMap.getHeight(); y++)
+	{
+		for (int x = 0; x < costMap.getWidth(); x++)
+		{
+			unsigned char cost = costMap.get(x, y);
+			if (cost != PATH_COST_BLOCKED)
+			{
+				if (uniformCost != PATH_COST_BLOCKED && cost != uniformCost)
+				{
+					return false;
+				}
+				uniformCost = cost;
+			}
+		}
+	}
+	return true;
+}
+
+// The vector operations as they were compiled when they were defined in the
+// .cpp files, i.e. one function call per operation.
+__declspec(noinline) Vec3Float subtractOutOfLine(const Vec3Float& left, const Vec3Float& right)
+{
+	return left - right;
+}
+
+__declspec(noinline) Vec3Float addOutOfLine(const Vec3Float& left, const Vec3Float& right)
+{
+	return left + right;
+}
+
+__declspec(noinline) Vec3Float multiplyOutOfLine(const Vec3Float& vec3, float value)
+{
+	return vec3 * value;
+}
+
+__declspec(noinline) void normalizeOutOfLine(Vec3Float& vec3)
+{
+	vec3.normalize();
+}
+
+__declspec(noinline) bool longerThanOutOfLine(const Vec3Float& vec3, float length)
+{
+	return vec3.longerThan(length);
+}
+
+/**
+* The 32-bit Adler based hash HashedString::hashName() used before it got a
+* 64-bit hash, used as reference.
+*/
+unsigned long hashNameAdler32(const char* pIdentStr)
+{
+	const unsigned long BASE = 65521UL;
+	const unsigned long NMAX = 5552;
+
+	unsigned long s1 = 0;
+	unsigned long s2 = 0;
+	for (size_t len = strlen(pIdentStr); len > 0;)
+	{
+		unsigned long k = len < NMAX ? static_cast<unsigned long>(len) : NMAX;
+		len -= k;
+		do
+		{
+			s1 += tolower(*pIdentStr++);
+			s2 += s1;
+		} while (--k);
+
+		s1 %= BASE;
+		s2 %= BASE;
+	}
+	return (s2 << 16) | s1;
+}
+
+/**
+* Counts the number of values that are equal to a previous value
+*/
+template <typename T>
+int countCollisions(std::vector<T>& values)
+{
+	std::sort(values.begin(), values.end());
+	return static_cast<int>(values.end() - std::unique(values.begin(), values.end()));
+}
+
+const float STEERING_MAX_SPEED = 10.0f;
+const float STEERING_ARRIVE_DISTANCE = 1.0f;
+const float STEERING_DELTA_TIME = 1.0f / 60.0f;
+}
+
+PathfindingBenchmarkResult benchmark::runPathfindingBenchmark(const PathCostMap& costMap, int cQueries, unsigned int seed)
+{
+	PathfindingBenchmarkResult result;
+	result.cQueries = cQueries;
+	result.cFound = 0;
+	result.aStarTime = 0.0f;
+	result.jpsTime = 0.0f;
+	result.aStarExpanded = 0;
+	result.jpsExpanded = 0;
+	result.cMismatches = 0;
+
+	// Generate all queries first so both searches get the same input
+	BenchmarkRandom random(seed);
+	std::vector<MapCoordinate> starts(cQueries);
+	std::vector<MapCoordinate> goals(cQueries);
+	for (int i = 0; i < cQueries; i++)
+	{
+		starts[i] = MapCoordinate(random.next(costMap.getWidth()), random.next(costMap.getHeight()));
+		goals[i] = MapCoordinate(random.next(costMap.getWidth()), random.next(costMap.getHeight()));
+	}
+
+	std::vector<int> aStarCosts(cQueries);
+	GridAStar aStar(costMap);
+	Timer timer;
+	timer.start();
+	for (int i = 0; i < cQueries; i++)
+	{
+		aStarCosts[i] = aStar.findPath(starts[i], goals[i], NULL);
+		result.aStarExpanded += aStar.getExpandedCount();
+	}
+	result.aStarTime = timer.getTime(Timer::ReturnType_MilliSeconds);
+
+	std::vector<int> jpsCosts(cQueries);
+	JumpPointSearch jps(costMap);
+	timer.start();
+	for (int i = 0; i < cQueries; i++)
+	{
+		jpsCosts[i] = jps.findPath(starts[i], goals[i], NULL);
+		result.jpsExpanded += jps.getExpandedCount();
+	}
+	result.jpsTime = timer.getTime(Timer::ReturnType_MilliSeconds);
+
+	// JPS path costs are with uniform cost, scale them to the cost of the map
+	bool uniformCost = hasUniformCost(costMap);
+	for (int i = 0; i < cQueries; i++)
+	{
+		if (aStarCosts[i] != PATH_NOT_FOUND)
+		{
+			result.cFound++;
+		}
+		if ((aStarCosts[i] == PATH_NOT_FOUND) != (jpsCosts[i] == PATH_NOT_FOUND))
+		{
+			result.cMismatches++;
+		}
+		else if (uniformCost && aStarCosts[i] != PATH_NOT_FOUND && aStarCosts[i] != jpsCosts[i] * costMap.get(starts[i].x, starts[i].y))
+		{
+			result.cMismatches++;
+		}
+	}
+
+	std::cout << "Pathfinding benchmark, " << cQueries << " queries on " << costMap.getWidth() << "x" << costMap.getHeight()
+		<< ", found " << result.cFound << ", mismatches " << result.cMismatches << std::endl;
+	std::cout << "A*:  " << result.aStarTime << " ms, " << result.aStarExpanded << " expanded nodes" << std::endl;
+	std::cout << "JPS: " << result.jpsTime << " ms, " << result.jpsExpanded << " expanded nodes" << std::endl;
+	if (result.cMismatches > 0)
+	{
+		ERROR_MESSAGE("Pathfinding benchmark: A* and JPS differed in " << result.cMismatches << " queries!");
+	}
+
+	return result;
+}
+
+VectorMathBenchmarkResult benchmark::runVectorMathBenchmark(int cAgents, int cIterations)
+{
+	VectorMathBenchmarkResult result;
+	result.cAgents = cAgents;
+	result.cIterations = cIterations;
+
+	BenchmarkRandom random(1);
+	std::vector<Vec3Float> startPositions(cAgents);
+	for (int i = 0; i < cAgents; i++)
+	{
+		startPositions[i] = Vec3Float(static_cast<float>(random.next(1000)), 0.0f, static_cast<float>(random.next(1000)));
+	}
+	const Vec3Float target(500.0f, 0.0f, 500.0f);
+
+	std::vector<Vec3Float> positions(startPositions);
+	std::vector<Vec3Float> velocities(cAgents);
+	Timer timer;
+	timer.start();
+	for (int iteration = 0; iteration < cIterations; iteration++)
+	{
+		for (int i = 0; i < cAgents; i++)
+		{
+			Vec3Float toTarget = subtractOutOfLine(target, positions[i]);
+			if (longerThanOutOfLine(toTarget, STEERING_ARRIVE_DISTANCE))
+			{
+				normalizeOutOfLine(toTarget);
+				Vec3Float steering = subtractOutOfLine(multiplyOutOfLine(toTarget, STEERING_MAX_SPEED), velocities[i]);
+				velocities[i] = addOutOfLine(velocities[i], multiplyOutOfLine(steering, STEERING_DELTA_TIME));
+			}
+			positions[i] = addOutOfLine(positions[i], multiplyOutOfLine(velocities[i], STEERING_DELTA_TIME));
+		}
+	}
+	result.outOfLineTime = timer.getTime(Timer::ReturnType_MilliSeconds);
+
+	std::vector<Vec3Float> outOfLinePositions;
+	outOfLinePositions.swap(positions);
+	positions = startPositions;
+	velocities.assign(cAgents, Vec3Float());
+	timer.start();
+	for (int iteration = 0; iteration < cIterations; iteration++)
+	{
+		for (int i = 0; i < cAgents; i++)
+		{
+			Vec3Float toTarget = target - positions[i];
+			if (toTarget.longerThan(STEERING_ARRIVE_DISTANCE))
+			{
+				toTarget.normalize();
+				Vec3Float steering = toTarget * STEERING_MAX_SPEED - velocities[i];
+				velocities[i] += steering * STEERING_DELTA_TIME;
+			}
+			positions[i] += velocities[i] * STEERING_DELTA_TIME;
+		}
+	}
+	result.inlineTime = timer.getTime(Timer::ReturnType_MilliSeconds);
+
+	// Use the results so the compiler can't remove the loops, both versions
+	// do the same operations in the same order so they have to agree exactly
+	result.outOfLineChecksum = 0.0f;
+	result.inlineChecksum = 0.0f;
+	result.cMismatches = 0;
+	for (int i = 0; i < cAgents; i++)
+	{
+		result.outOfLineChecksum += outOfLinePositions[i].x + outOfLinePositions[i].z;
+		result.inlineChecksum += positions[i].x + positions[i].z;
+		if (outOfLinePositions[i].x != positions[i].x || outOfLinePositions[i].y != positions[i].y || outOfLinePositions[i].z != positions[i].z)
+		{
+			result.cMismatches++;
+		}
+	}
+
+	std::cout << "Vector math benchmark, " << cAgents << " agents, " << cIterations << " iterations, mismatches " << result.cMismatches << std::endl;
+	std::cout << "Out of line: " << result.outOfLineTime << " ms, checksum " << result.outOfLineChecksum << std::endl;
+	std::cout << "Inline:      " << result.inlineTime << " ms, checksum " << result.inlineChecksum << std::endl;
+	if (result.cMismatches > 0)
+	{
+		ERROR_MESSAGE("Vector math benchmark: The final positions differed for " << result.cMismatches << " agents!");
+	}
+
+	return result;
+}
+
+BroadPhaseBenchmarkResult benchmark::runBroadPhaseBenchmark(int cBodies, int cFrames, unsigned int seed)
+{
+	BroadPhaseBenchmarkResult result;
+	result.cBodies = cBodies;
+	result.cFrames = cFrames;
+	result.sweepAndPruneTime = 0.0f;
+	result.naiveTime = 0.0f;
+	result.cPairs = 0;
+	result.cMismatches = 0;
+
+	// Keep the density constant, about one body per 8x8 world units
+	BenchmarkRandom random(seed);
+	int areaSize = static_cast<int>(sqrtf(static_cast<float>(cBodies)) * 8.0f) + 1;
+	Vec3FloatArray positions(cBodies);
+	Vec3FloatArray velocities(cBodies);
+	std::vector<float> radii(cBodies);
+	for (int i = 0; i < cBodies; i++)
+	{
+		positions.set(i, Vec3Float(static_cast<float>(random.next(areaSize)), 0.0f, static_cast<float>(random.next(areaSize))));
+		velocities.set(i, Vec3Float(random.next(41) - 20.0f, 0.0f, random.next(41) - 20.0f));
+		radii[i] = 1.0f + random.next(100) * 0.01f;
+	}
+
+	SweepAndPrune broadPhase(cBodies * 8);
+	float* pX = positions.getX();
+	const float* pY = positions.getY();
+	float* pZ = positions.getZ();
+	float areaSizeFloat = static_cast<float>(areaSize);
+	Timer timer;
+	for (int frame = 0; frame < cFrames; frame++)
+	{
+		// Bodies that leave the area come back on the other side, otherwise
+		// the swarm would spread out and the density fall every frame
+		positions.multiplyAdd(velocities, STEERING_DELTA_TIME);
+		for (int i = 0; i < cBodies; i++)
+		{
+			if (pX[i] < 0.0f)
+			{
+				pX[i] += areaSizeFloat;
+			}
+			else if (pX[i] >= areaSizeFloat)
+			{
+				pX[i] -= areaSizeFloat;
+			}
+			if (pZ[i] < 0.0f)
+			{
+				pZ[i] += areaSizeFloat;
+			}
+			else if (pZ[i] >= areaSizeFloat)
+			{
+				pZ[i] -= areaSizeFloat;
+			}
+		}
+
+		timer.start();
+		broadPhase.update(positions, &radii[0]);
+		result.sweepAndPruneTime += timer.getTime(Timer::ReturnType_MilliSeconds);
+
+		timer.start();
+		int cNaivePairs = 0;
+		for (int i = 0; i < cBodies; i++)
+		{
+			for (int j = i + 1; j < cBodies; j++)
+			{
+				// Same bounding box tests as SweepAndPrune so rounding can't differ
+				float radiusI = radii[i];
+				float radiusJ = radii[j];
+				if (pX[j] - radiusJ <= pX[i] + radiusI && pX[j] + radiusJ >= pX[i] - radiusI &&
+					pY[j] - radiusJ <= pY[i] + radiusI && pY[j] + radiusJ >= pY[i] - radiusI &&
+					pZ[j] - radiusJ <= pZ[i] + radiusI && pZ[j] + radiusJ >= pZ[i] - radiusI)
+				{
+					cNaivePairs++;
+				}
+			}
+		}
+		result.naiveTime += timer.getTime(Timer::ReturnType_MilliSeconds);
+
+		result.cPairs = broadPhase.getPairCount();
+		if (cNaivePairs != broadPhase.getPairCount())
+		{
+			result.cMismatches++;
+		}
+	}
+
+	std::cout << "Broad phase benchmark, " << cBodies << " bodies, " << cFrames << " frames, " << result.cPairs << " pairs" << std::endl;
+	std::cout << "Sweep and prune: " << result.sweepAndPruneTime << " ms" << std::endl;
+	std::cout << "All pairs:       " << result.naiveTime << " ms" << std::endl;
+	if (result.cMismatches > 0)
+	{
+		ERROR_MESSAGE("Broad phase benchmark: Pair counts differed in " << result.cMismatches << " frames!");
+	}
+
+	return result;
+}
+
+HashBenchmarkResult benchmark::runHashBenchmark(int cStrings, int length, int cIterations, unsigned int seed)
+{
+	static const char CHARACTERS[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_/.";
+
+	// Distinct random strings, otherwise equal strings would count as collisions
+	BenchmarkRandom random(seed);
+	std::vector<std::string> strings(cStrings, std::string(length, ' '));
+	for (int i = 0; i < cStrings; i++)
+	{
+		for (int c = 0; c < length; c++)
+		{
+			strings[i][c] = CHARACTERS[random.next(sizeof(CHARACTERS) - 1)];
+		}
+	}
+	std::sort(strings.begin(), strings.end());
+	strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+
+	HashBenchmarkResult result;
+	result.cStrings = static_cast<int>(strings.size());
+	result.length = length;
+
+	std::vector<unsigned long> adlerHashes(strings.size());
+	Timer timer;
+	timer.start();
+	for (int iteration = 0; iteration < cIterations; iteration++)
+	{
+		for (size_t i = 0; i < strings.size(); i++)
+		{
+			adlerHashes[i] = hashNameAdler32(strings[i].c_str());
+		}
+	}
+	result.adlerTime = timer.getTime(Timer::ReturnType_MilliSeconds);
+
+	std::vector<HashedStringId> hashes(strings.size());
+	timer.start();
+	for (int iteration = 0; iteration < cIterations; iteration++)
+	{
+		for (size_t i = 0; i < strings.size(); i++)
+		{
+			hashes[i] = HashedString::hashName(strings[i].c_str());
+		}
+	}
+	result.hashTime = timer.getTime(Timer::ReturnType_MilliSeconds);
+
+	result.cAdlerCollisions = countCollisions(adlerHashes);
+	result.cHashCollisions = countCollisions(hashes);
+
+	std::cout << "Hash benchmark, " << result.cStrings << " strings of " << length << " characters, " << cIterations << " iterations" << std::endl;
+	std::cout << "Adler32:  " << result.adlerTime << " ms, " << result.cAdlerCollisions << " collisions" << std::endl;
+	std::cout << "hashName: " << result.hashTime << " ms, " << result.cHashCollisions << " collisions" << std::endl;
+	if (result.cHashCollisions > 0)
+	{
+		ERROR_MESSAGE("Hash benchmark: hashName() had " << result.cHashCollisions << " collisions!");
+	}
+
+	return result;
+}
\ No newline at end of file
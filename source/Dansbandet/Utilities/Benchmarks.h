@@ -0,0 +1,144 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Benchmarks for the performance critical parts of the utilities. They are not run
+* automatically, call them from a tool when you change the code they measure.
+* Always run them from an optimized Release build, the Debug configuration
+* doesn't inline or optimize so its times say nothing about the Release build.
+* The results are returned and printed to stdout, results that should never
+* happen such as mismatches are also reported with ERROR_MESSAGE.
+*/
+
+#ifndef __BENCHMARKS_H__
+#define __BENCHMARKS_H__
+
+#include "PathCostMap.h"
+
+namespace utilities
+{
+namespace benchmark
+{
+
+/**
+* Result of runPathfindingBenchmark()
+*/
+struct PathfindingBenchmarkResult
+{
+	int cQueries;			/**< Number of queries that were run */
+	int cFound;				/**< Number of queries where a path was found */
+	float aStarTime;		/**< Total time in milliseconds for GridAStar */
+	float jpsTime;			/**< Total time in milliseconds for JumpPointSearch */
+	long aStarExpanded;		/**< Total number of nodes expanded by GridAStar */
+	long jpsExpanded;		/**< Total number of nodes expanded by JumpPointSearch */
+	int cMismatches;		/**< Number of queries where the path costs differed, should be 0 */
+};
+
+/**
+* Runs the same random queries with GridAStar and JumpPointSearch and compares
+* the time and number of expanded nodes. The result is also printed to
+* stdout. Since JPS treats all walkable cells as uniform cost the costs
+* are only compared when the map has uniform cost.
+* @param costMap the map to search in
+* @param cQueries number of random start and goal pairs
+* @param seed seed for the random start and goal coordinates
+* @return the result of the benchmark
+*/
+PathfindingBenchmarkResult runPathfindingBenchmark(const PathCostMap& costMap, int cQueries, unsigned int seed = 1);
+
+/**
+* Result of runVectorMathBenchmark()
+*/
+struct VectorMathBenchmarkResult
+{
+	int cAgents;				/**< Number of agents that were updated */
+	int cIterations;			/**< Number of times all agents were updated */
+	float outOfLineTime;		/**< Total time in milliseconds with the vector operations as function calls */
+	float inlineTime;			/**< Total time in milliseconds with the inline vector operations */
+	float outOfLineChecksum;	/**< Sum of the final positions with the function calls */
+	float inlineChecksum;		/**< Sum of the final positions with the inline operations */
+	int cMismatches;			/**< Number of agents whose final positions differed between the versions, should be 0 */
+};
+
+/**
+* Runs a typical steering update (seek towards a target and integrate) on a
+* number of agents. The update is run once with the vector operations as
+* function calls, as they were when they were defined in the .cpp files, and
+* once with the inline operations. The result is also printed to stdout.
+* @param cAgents number of agents to update
+* @param cIterations number of times to update all agents
+* @return the result of the benchmark
+*/
+VectorMathBenchmarkResult runVectorMathBenchmark(int cAgents, int cIterations);
+
+/**
+* Result of runBroadPhaseBenchmark()
+*/
+struct BroadPhaseBenchmarkResult
+{
+	int cBodies;				/**< Number of bodies */
+	int cFrames;				/**< Number of simulated frames */
+	float sweepAndPruneTime;	/**< Total time in milliseconds for SweepAndPrune */
+	float naiveTime;			/**< Total time in milliseconds for testing all pairs */
+	int cPairs;					/**< Number of overlapping pairs in the last frame */
+	int cMismatches;			/**< Number of frames where the pair counts differed, should be 0 */
+};
+
+/**
+* Moves bodies around at a constant density, similar to a bug swarm, and finds
+* the overlapping pairs each frame with SweepAndPrune and by testing all pairs.
+* Typically run with 1000, 5000 and 20000 bodies. The result is also printed
+* to stdout.
+* @param cBodies number of bodies
+* @param cFrames number of frames to simulate
+* @param seed seed for the positions, radii and velocities
+* @return the result of the benchmark
+*/
+BroadPhaseBenchmarkResult runBroadPhaseBenchmark(int cBodies, int cFrames, unsigned int seed = 1);
+
+/**
+* Result of runHashBenchmark()
+*/
+struct HashBenchmarkResult
+{
+	int cStrings;			/**< Number of distinct strings that were hashed */
+	int length;				/**< Number of characters in each string */
+	float adlerTime;		/**< Total time in milliseconds for the old 32-bit Adler hash */
+	float hashTime;			/**< Total time in milliseconds for HashedString::hashName() */
+	int cAdlerCollisions;	/**< Number of strings that got the same Adler hash as another string */
+	int cHashCollisions;	/**< Number of strings that got the same hashName() as another string, should be 0 */
+};
+
+/**
+* Hashes random strings with the old 32-bit Adler based hash and with
+* HashedString::hashName() and compares the time and number of collisions.
+* Typically run with short event names, e.g. 16 characters, and long asset
+* paths, e.g. 128 characters. The result is also printed to stdout.
+* @param cStrings number of random strings
+* @param length number of characters in each string
+* @param cIterations number of times to hash all strings
+* @param seed seed for the characters
+* @return the result of the benchmark
+*/
+HashBenchmarkResult runHashBenchmark(int cStrings, int length, int cIterations, unsigned int seed = 1);
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Bit packed streams for compact serialization, e.g. network snapshots.
+*/
+
+#include "BitStream.h"
+
+using namespace utilities;
+
+BitWriter::BitWriter(int cReservedBytes)
+{
+	mData.reserve(cReservedBytes);
+	mcBits = 0;
+}
+
+BitWriter::~BitWriter()
+{
+}
+
+void BitWriter::write(unsigned int value, int cBits)
+{
+	// Fill the rest of the current byte, then continue with whole bytes
+	while (cBits > 0)
+	{
+		int bitOffset = mcBits & 7;
+		if (bitOffset == 0)
+		{
+			mData.push_back(0);
+		}
+
+		int cWrite = 8 - bitOffset;
+		if (cWrite > cBits)
+		{
+			cWrite = cBits;
+		}
+
+		mData.back() |= static_cast<unsigned char>((value & ((1u << cWrite) - 1)) << bitOffset);
+		value >>= cWrite;
+		cBits -= cWrite;
+		mcBits += cWrite;
+	}
+}
+
+void BitWriter::clear()
+{
+	mData.clear();
+	mcBits = 0;
+}
+
+BitReader::BitReader(const unsigned char* pData, int cBytes)
+{
+	mpData = pData;
+	mcTotalBits = cBytes * 8;
+	mcBits = 0;
+}
+
+BitReader::~BitReader()
+{
+}
+
+unsigned int BitReader::read(int cBits)
+{
+	if (cBits > getBitsLeft())
+	{
+		throw EndOfDataException();
+	}
+
+	unsigned int value = 0;
+	int cValueBits = 0;
+	while (cBits > 0)
+	{
+		int bitOffset = mcBits & 7;
+		int cRead = 8 - bitOffset;
+		if (cRead > cBits)
+		{
+			cRead = cBits;
+		}
+
+		unsigned int bits = (mpData[mcBits >> 3] >> bitOffset) & ((1u << cRead) - 1);
+		value |= bits << cValueBits;
+		cValueBits += cRead;
+		cBits -= cRead;
+		mcBits += cRead;
+	}
+	return value;
+}
\ No newline at end of file
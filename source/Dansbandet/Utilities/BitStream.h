@@ -0,0 +1,169 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Bit packed streams for compact serialization, e.g. network snapshots.
+*/
+
+#ifndef __BIT_STREAM_H__
+#define __BIT_STREAM_H__
+
+#include "Exception.h"
+#include <vector>
+
+namespace utilities
+{
+
+/**
+* Writes values with an arbitrary number of bits into a byte buffer. The bits
+* are packed starting with the least significant bit of each byte, a value can
+* thus span several bytes. The last byte is padded with zeros.
+*/
+class BitWriter
+{
+public:
+	/**
+	* Constructor
+	* @param cReservedBytes number of bytes to reserve for the buffer
+	*/
+	explicit BitWriter(int cReservedBytes = 0);
+
+	/**
+	* Destructor
+	*/
+	~BitWriter();
+
+	/**
+	* Writes the cBits lowest bits of a value
+	* @param value the value to write, the other bits are ignored
+	* @param cBits number of bits to write, 0 to 32
+	*/
+	void write(unsigned int value, int cBits);
+
+	/**
+	* Writes a single bit
+	* @param value the bit to write
+	*/
+	inline void writeBool(bool value)
+	{
+		write(value ? 1 : 0, 1);
+	}
+
+	/**
+	* Removes all written data, the buffer is kept
+	*/
+	void clear();
+
+	/**
+	* Returns the written data
+	* @return pointer to the bytes, NULL if nothing has been written
+	*/
+	inline const unsigned char* getData() const
+	{
+		return mData.empty() ? NULL : &mData[0];
+	}
+
+	/**
+	* Returns the number of written bytes, including the padded last byte
+	* @return number of bytes
+	*/
+	inline int getByteCount() const
+	{
+		return static_cast<int>(mData.size());
+	}
+
+	/**
+	* Returns the number of written bits
+	* @return number of bits
+	*/
+	inline int getBitCount() const
+	{
+		return mcBits;
+	}
+
+private:
+	std::vector<unsigned char>	mData;
+	int							mcBits;
+};
+
+/**
+* Reads values written by a BitWriter. The reader doesn't copy the data, it
+* needs to outlive the reader.
+*/
+class BitReader
+{
+public:
+	/**
+	* Thrown when trying to read past the end of the data
+	*/
+	class EndOfDataException : public Exception
+	{
+	public:
+		EndOfDataException() : Exception("BitReaderEndOfDataException: Tried to read past the end of the data!", 70012) {}
+	};
+
+	/**
+	* Constructor
+	* @param pData the data to read
+	* @param cBytes number of bytes in pData
+	*/
+	BitReader(const unsigned char* pData, int cBytes);
+
+	/**
+	* Destructor
+	*/
+	~BitReader();
+
+	/**
+	* Reads a value
+	* @param cBits number of bits the value was written with, 0 to 32
+	* @return the value, the bits above cBits are 0
+	* @throws EndOfDataException if there are less than cBits bits left
+	*/
+	unsigned int read(int cBits);
+
+	/**
+	* Reads a single bit
+	* @return the bit
+	* @throws EndOfDataException if there are no bits left
+	*/
+	inline bool readBool()
+	{
+		return read(1) != 0;
+	}
+
+	/**
+	* Returns the number of bits that are left to read, including the padding
+	* of the last byte
+	* @return number of bits left
+	*/
+	inline int getBitsLeft() const
+	{
+		return mcTotalBits - mcBits;
+	}
+
+private:
+	const unsigned char*	mpData;
+	int						mcTotalBits;
+	int						mcBits;		/**< Number of bits read */
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,157 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Conversion between world and map coordinates, both for single values and in
+* batches. The batch versions convert four positions at a time with SSE2.
+*/
+
+#include "CoordinateConversion.h"
+#include "Vec3FloatArray.h"
+#include <emmintrin.h>
+
+using namespace utilities;
+
+namespace
+{
+/**
+* Converts four world coordinates to map coordinates with the same rounding as
+* convertToMapCoordinate(). SSE2 has no floor, so we truncate and subtract one
+* where the truncation rounded up, i.e. for negative non-integers. Then the
+* result is corrected against the exact cell borders like the scalar version.
+* @param worldCoordinates the world coordinates
+* @param cellSize MAP_IN_WORLD_COORDS in all lanes
+* @return the map coordinates
+*/
+inline __m128i convertToMapCoordinates4(__m128 worldCoordinates, __m128 cellSize)
+{
+	__m128 scaled = _mm_div_ps(worldCoordinates, cellSize);
+	__m128i truncated = _mm_cvttps_epi32(scaled);
+	// The compare masks are -1 where we need to subtract one, so we add them
+	__m128i roundedUp = _mm_castps_si128(_mm_cmplt_ps(scaled, _mm_cvtepi32_ps(truncated)));
+	__m128i mapCoordinates = _mm_add_epi32(truncated, roundedUp);
+
+	__m128 cellStart = _mm_mul_ps(_mm_cvtepi32_ps(mapCoordinates), cellSize);
+	__m128i belowCell = _mm_castps_si128(_mm_cmplt_ps(worldCoordinates, cellStart));
+	__m128i aboveCell = _mm_castps_si128(_mm_cmpge_ps(worldCoordinates, _mm_add_ps(cellStart, cellSize)));
+	return _mm_sub_epi32(_mm_add_epi32(mapCoordinates, belowCell), aboveCell);
+}
+}
+
+int utilities::convertToMapCoordinate(Fixed worldCoordinate)
+{
+	// The size of a cell is an integer, so this is exact. Integer division
+	// truncates towards zero and we want to round down.
+	const int cellSizeRaw = static_cast<int>(MAP_IN_WORLD_COORDS) * Fixed::RAW_ONE;
+	int raw = worldCoordinate.getRaw();
+	int mapCoordinate = raw / cellSizeRaw;
+	if (raw < 0 && mapCoordinate * cellSizeRaw != raw)
+	{
+		mapCoordinate--;
+	}
+	return mapCoordinate;
+}
+
+Fixed utilities::convertToFixedWorldCoordinate(int mapCoordinate)
+{
+	const int cellSizeRaw = static_cast<int>(MAP_IN_WORLD_COORDS) * Fixed::RAW_ONE;
+	return Fixed::fromRaw(mapCoordinate * cellSizeRaw + cellSizeRaw / 2);
+}
+
+void utilities::convertToMapCoordinates(const float* pWorldX, const float* pWorldZ, int cPositions, MapCoordinate* pMapCoordinates)
+{
+	__m128 cellSize = _mm_set1_ps(MAP_IN_WORLD_COORDS);
+
+	// MapCoordinate is two ints, so the array can be written as interleaved x, y ints
+	int* pOut = reinterpret_cast<int*>(pMapCoordinates);
+	int cSimd = cPositions & ~3;
+	for (int i = 0; i < cSimd; i += 4)
+	{
+		__m128i mapX = convertToMapCoordinates4(_mm_loadu_ps(pWorldX + i), cellSize);
+		__m128i mapY = convertToMapCoordinates4(_mm_loadu_ps(pWorldZ + i), cellSize);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + 2 * i), _mm_unpacklo_epi32(mapX, mapY));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + 2 * i + 4), _mm_unpackhi_epi32(mapX, mapY));
+	}
+	for (int i = cSimd; i < cPositions; i++)
+	{
+		pMapCoordinates[i].x = convertToMapCoordinate(pWorldX[i]);
+		pMapCoordinates[i].y = convertToMapCoordinate(pWorldZ[i]);
+	}
+}
+
+void utilities::convertToMapCoordinates(const Vec3FloatArray& positions, MapCoordinate* pMapCoordinates)
+{
+	convertToMapCoordinates(positions.getX(), positions.getZ(), positions.size(), pMapCoordinates);
+}
+
+void utilities::convertToCellIndices(const Vec3FloatArray& positions, int mapWidth, int* pCellIndices)
+{
+	const float* pWorldX = positions.getX();
+	const float* pWorldZ = positions.getZ();
+	__m128 cellSize = _mm_set1_ps(MAP_IN_WORLD_COORDS);
+
+	// SSE2 has no 32-bit multiplication, the map is small enough that the
+	// index can be calculated exactly as a float instead.
+	__m128 width = _mm_set1_ps(static_cast<float>(mapWidth));
+	int cSimd = positions.size() & ~3;
+	for (int i = 0; i < cSimd; i += 4)
+	{
+		__m128i mapX = convertToMapCoordinates4(_mm_load_ps(pWorldX + i), cellSize);
+		__m128i mapY = convertToMapCoordinates4(_mm_load_ps(pWorldZ + i), cellSize);
+		__m128 rowStart = _mm_mul_ps(_mm_cvtepi32_ps(mapY), width);
+		__m128i indices = _mm_add_epi32(_mm_cvttps_epi32(rowStart), mapX);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pCellIndices + i), indices);
+	}
+	for (int i = cSimd; i < positions.size(); i++)
+	{
+		pCellIndices[i] = convertToMapCoordinate(pWorldZ[i]) * mapWidth + convertToMapCoordinate(pWorldX[i]);
+	}
+}
+
+void utilities::convertToWorldCoordinates(const MapCoordinate* pMapCoordinates, int cMapCoordinates, Vec3FloatArray& positions)
+{
+	positions.resize(cMapCoordinates);
+	float* pWorldX = positions.getX();
+	float* pWorldY = positions.getY();
+	float* pWorldZ = positions.getZ();
+
+	__m128 scale = _mm_set1_ps(MAP_IN_WORLD_COORDS);
+	__m128 offset = _mm_set1_ps(MAP_IN_WORLD_COORDS_HALF);
+	const int* pIn = reinterpret_cast<const int*>(pMapCoordinates);
+	int cSimd = cMapCoordinates & ~3;
+	for (int i = 0; i < cSimd; i += 4)
+	{
+		// De-interleave x0 y0 x1 y1 | x2 y2 x3 y3 into x0 x1 x2 x3 and y0 y1 y2 y3
+		__m128 low = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + 2 * i)));
+		__m128 high = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + 2 * i + 4)));
+		__m128i mapX = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i mapY = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+
+		_mm_store_ps(pWorldX + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(mapX), scale), offset));
+		_mm_store_ps(pWorldY + i, _mm_setzero_ps());
+		_mm_store_ps(pWorldZ + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(mapY), scale), offset));
+	}
+	for (int i = cSimd; i < cMapCoordinates; i++)
+	{
+		pWorldX[i] = convertToWorldCoordinate(pMapCoordinates[i].x);
+		pWorldY[i] = 0.0f;
+		pWorldZ[i] = convertToWorldCoordinate(pMapCoordinates[i].y);
+	}
+}
\ No newline at end of file
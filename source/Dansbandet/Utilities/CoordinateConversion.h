@@ -0,0 +1,132 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Conversion between world and map coordinates, both for single values and in
+* batches. The batch versions convert four positions at a time with SSE2.
+*/
+
+#ifndef __COORDINATE_CONVERSION_H__
+#define __COORDINATE_CONVERSION_H__
+
+#include "Vectors.h"
+#include "Fixed.h"
+
+namespace utilities
+{
+
+class Vec3FloatArray;
+
+/**
+* Converts a world coordinate to a map coordinate, i.e. the cell that contains
+* the coordinate: mapCoordinate * MAP_IN_WORLD_COORDS <= worldCoordinate <
+* (mapCoordinate + 1) * MAP_IN_WORLD_COORDS. Negative coordinates are rounded
+* towards negative infinity, so -0.5 becomes -1 and -15.0 stays -1.
+* All convertToMapCoordinates() functions use this rounding.
+* @param worldCoordinate the world coordinate
+* @return the map coordinate
+*/
+inline int convertToMapCoordinate(float worldCoordinate)
+{
+	float scaled = worldCoordinate / MAP_IN_WORLD_COORDS;
+	int mapCoordinate = static_cast<int>(scaled);
+	if (scaled < static_cast<float>(mapCoordinate))
+	{
+		mapCoordinate--;
+	}
+
+	// The division rounds, so a coordinate just beside a border can end up in
+	// the neighbour cell. The borders are exact floats, check against them.
+	float cellStart = static_cast<float>(mapCoordinate) * MAP_IN_WORLD_COORDS;
+	if (worldCoordinate < cellStart)
+	{
+		mapCoordinate--;
+	}
+	else if (worldCoordinate >= cellStart + MAP_IN_WORLD_COORDS)
+	{
+		mapCoordinate++;
+	}
+	return mapCoordinate;
+}
+
+/**
+* Converts a map coordinate to the world coordinate of the center of the cell
+* @param mapCoordinate the map coordinate
+* @return the world coordinate
+*/
+inline float convertToWorldCoordinate(int mapCoordinate)
+{
+	return static_cast<float>(mapCoordinate) * MAP_IN_WORLD_COORDS + MAP_IN_WORLD_COORDS_HALF;
+}
+
+/**
+* Converts a fixed-point world coordinate to a map coordinate with integer math
+* only. The result is the exact cell, the same as convertToMapCoordinate(float)
+* returns for worldCoordinate.toFloat() whenever that conversion is exact, i.e.
+* for all raw values within +-2^24.
+* @param worldCoordinate the world coordinate
+* @return the map coordinate
+*/
+int convertToMapCoordinate(Fixed worldCoordinate);
+
+/**
+* Converts a map coordinate to the fixed-point world coordinate of the center of the cell
+* @param mapCoordinate the map coordinate
+* @return the world coordinate
+*/
+Fixed convertToFixedWorldCoordinate(int mapCoordinate);
+
+/**
+* Converts positions in world coordinates to map coordinates. The world x-value
+* becomes the map x-value and the world z-value the map y-value.
+* @param pWorldX the x-values of the positions
+* @param pWorldZ the z-values of the positions
+* @param cPositions number of positions
+* @param pMapCoordinates array with room for cPositions map coordinates
+*/
+void convertToMapCoordinates(const float* pWorldX, const float* pWorldZ, int cPositions, MapCoordinate* pMapCoordinates);
+
+/**
+* Converts positions in world coordinates to map coordinates.
+* @param positions the positions in world coordinates
+* @param pMapCoordinates array with room for positions.size() map coordinates
+*/
+void convertToMapCoordinates(const Vec3FloatArray& positions, MapCoordinate* pMapCoordinates);
+
+/**
+* Converts positions in world coordinates to packed cell indices, i.e.
+* mapY * mapWidth + mapX. The positions need to be inside the map.
+* @param positions the positions in world coordinates
+* @param mapWidth the width of the map
+* @param pCellIndices array with room for positions.size() indices
+*/
+void convertToCellIndices(const Vec3FloatArray& positions, int mapWidth, int* pCellIndices);
+
+/**
+* Converts map coordinates to world coordinates at the center of the cells,
+* the y-values are set to 0.
+* @param pMapCoordinates the map coordinates
+* @param cMapCoordinates number of map coordinates
+* @param positions resized to cMapCoordinates and filled with the world coordinates
+*/
+void convertToWorldCoordinates(const MapCoordinate* pMapCoordinates, int cMapCoordinates, Vec3FloatArray& positions);
+}
+
+#endif
\ No newline at end of file
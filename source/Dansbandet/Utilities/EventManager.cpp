@@ -0,0 +1,427 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Event manager keyed by HashedString. Events are either triggered and delivered
+* at once or queued and delivered grouped by type when the manager is updated.
+*/
+
+#include "EventManager.h"
+#include "EventTypes.h"
+#include <algorithm>
+
+using namespace utilities;
+
+namespace
+{
+/** Number of slots in the listener table when it's created */
+const int LISTENER_TABLE_SIZE_MIN = 64;
+
+/**
+* Returns the first slot to probe for a coalesced event
+* @param type the event type
+* @param target the target of the event
+* @return index of the first slot to probe, before masking
+*/
+inline size_t getCoalescedIndex(HashedStringId type, int target)
+{
+	return static_cast<size_t>(type ^ (static_cast<HashedStringId>(target) * HASHED_STRING_PRIME_1));
+}
+}
+
+EventManager::EventManager(int queueSize, int dataSize) :
+	mEventTypes(EVENT_TYPES_DISPLACEMENTS, EVENT_TYPES_BUCKET_COUNT, EVENT_TYPES_KEYS, EVENT_TYPES_KEY_COUNT, EVENT_TYPES_SEED),
+	mFixedSlots(EVENT_TYPES_KEY_COUNT), mSlots(LISTENER_TABLE_SIZE_MIN), mBatch(BATCH_SIZE_MAX, Event(HashedString::fromId(0), NULL, 0))
+{
+	// At most half full
+	int coalescedSize = 1;
+	while (coalescedSize < queueSize * 2)
+	{
+		coalescedSize *= 2;
+	}
+
+	mcUsedSlots = 0;
+	for (int i = 0; i < 2; i++)
+	{
+		mQueues[i].events.resize(queueSize);
+		mQueues[i].data.resize(dataSize);
+		mQueues[i].coalesced.resize(coalescedSize, -1);
+		mQueues[i].cEvents = 0;
+		mQueues[i].dataUsed = 0;
+		mQueues[i].cDelivered = 0;
+		mQueues[i].cMerged = 0;
+	}
+	mQueueIndex = 0;
+	mDeliveryDepth = 0;
+	mListenersRemoved = false;
+	for (size_t i = 0; i < mFixedSlots.size(); i++)
+	{
+		mFixedSlots[i].type = mEventTypes.getKey(static_cast<int>(i));
+		mFixedSlots[i].used = true;
+		mFixedSlots[i].mergeFunction = NULL;
+	}
+	for (size_t i = 0; i < mSlots.size(); i++)
+	{
+		mSlots[i].used = false;
+	}
+}
+
+EventManager::~EventManager()
+{
+}
+
+void EventManager::setCoalescing(const HashedString& type, EventMergeFunction mergeFunction)
+{
+	// Creating a slot may grow the table, which a delivery can't handle
+	if (mDeliveryDepth > 0)
+	{
+		PendingCoalescing pending;
+		pending.type = type.getHashValue();
+		pending.mergeFunction = mergeFunction;
+		mPendingCoalescing.push_back(pending);
+		return;
+	}
+
+	getOrCreateSlot(type.getHashValue()).mergeFunction = mergeFunction;
+}
+
+void EventManager::addListener(EventListener* pListener, const HashedString& type)
+{
+	if (mDeliveryDepth > 0)
+	{
+		PendingListener pending;
+		pending.pListener = pListener;
+		pending.type = type.getHashValue();
+		mPendingListeners.push_back(pending);
+		return;
+	}
+
+	std::vector<EventListener*>& listeners = getOrCreateSlot(type.getHashValue()).listeners;
+	if (std::find(listeners.begin(), listeners.end(), pListener) == listeners.end())
+	{
+		listeners.push_back(pListener);
+	}
+}
+
+void EventManager::removeListener(EventListener* pListener, const HashedString& type)
+{
+	for (size_t i = 0; i < mPendingListeners.size(); )
+	{
+		if (mPendingListeners[i].pListener == pListener && mPendingListeners[i].type == type.getHashValue())
+		{
+			mPendingListeners.erase(mPendingListeners.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	ListenerSlot* pSlot = findSlot(type.getHashValue());
+	if (pSlot == NULL)
+	{
+		return;
+	}
+
+	std::vector<EventListener*>::iterator it = std::find(pSlot->listeners.begin(), pSlot->listeners.end(), pListener);
+	if (it != pSlot->listeners.end())
+	{
+		// Set to NULL during a delivery so the indices of the other listeners don't change
+		if (mDeliveryDepth > 0)
+		{
+			*it = NULL;
+			mListenersRemoved = true;
+		}
+		else
+		{
+			pSlot->listeners.erase(it);
+		}
+	}
+}
+
+void EventManager::removeListener(EventListener* pListener)
+{
+	for (size_t i = 0; i < mFixedSlots.size(); i++)
+	{
+		removeListener(pListener, HashedString::fromId(mFixedSlots[i].type));
+	}
+	for (size_t i = 0; i < mSlots.size(); i++)
+	{
+		if (mSlots[i].used)
+		{
+			removeListener(pListener, HashedString::fromId(mSlots[i].type));
+		}
+	}
+}
+
+bool EventManager::trigger(const HashedString& type, const void* pData, int size)
+{
+	ListenerSlot* pSlot = findSlot(type.getHashValue());
+	if (pSlot == NULL || pSlot->listeners.empty())
+	{
+		return false;
+	}
+
+	Event event(type, pData, size);
+	DeliveryScope deliveryScope(*this);
+	deliver(*pSlot, &event, 1);
+	return true;
+}
+
+bool EventManager::queueEvent(const HashedString& type, const void* pData, int size)
+{
+	return queueEvent(type, EVENT_NO_TARGET, pData, size);
+}
+
+bool EventManager::queueEvent(const HashedString& type, int target, const void* pData, int size)
+{
+	EventQueue& queue = mQueues[mQueueIndex];
+
+	// Merge with the queued event of the same type and target
+	int* pCoalesced = NULL;
+	const ListenerSlot* pSlot = findSlot(type.getHashValue());
+	if (pSlot != NULL && pSlot->mergeFunction != NULL)
+	{
+		size_t mask = queue.coalesced.size() - 1;
+		size_t i = getCoalescedIndex(type.getHashValue(), target) & mask;
+		for (; queue.coalesced[i] != -1; i = (i + 1) & mask)
+		{
+			const QueuedEvent& queued = queue.events[queue.coalesced[i]];
+			if (queued.type == type.getHashValue() && queued.target == target && queued.size == size)
+			{
+				pSlot->mergeFunction(&queue.data[queued.dataOffset], pData);
+				queue.cMerged++;
+				return true;
+			}
+		}
+		pCoalesced = &queue.coalesced[i];
+	}
+
+	int dataOffset = (queue.dataUsed + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+	if (queue.cEvents == static_cast<int>(queue.events.size()) || dataOffset + size > static_cast<int>(queue.data.size()))
+	{
+		// Types that were never interned have no string
+		DEBUG_MESSAGE(LEVEL_HIGH, "EventManager: The queue is full, dropped event 0x" << std::hex << type.getHashValue() <<
+			" " << (type.getStr() != NULL ? type.getStr() : "(not interned)"));
+		return false;
+	}
+
+	QueuedEvent& event = queue.events[queue.cEvents];
+	event.type = type.getHashValue();
+	event.order = queue.cEvents;
+	event.target = target;
+	event.dataOffset = dataOffset;
+	event.size = size;
+	if (size > 0)
+	{
+		memcpy(&queue.data[dataOffset], pData, size);
+	}
+	if (pCoalesced != NULL)
+	{
+		*pCoalesced = queue.cEvents;
+	}
+	queue.dataUsed = dataOffset + size;
+	queue.cEvents++;
+	return true;
+}
+
+bool EventManager::update(float budget)
+{
+	mTimer.start();
+
+	// Continue with the events that didn't fit in the budget of the last
+	// update, otherwise deliver the events queued since then
+	EventQueue* pQueue = &mQueues[1 - mQueueIndex];
+	if (pQueue->cDelivered == pQueue->cEvents)
+	{
+		resetQueue(*pQueue);
+		mQueueIndex = 1 - mQueueIndex;
+		pQueue = &mQueues[1 - mQueueIndex];
+		std::sort(pQueue->events.begin(), pQueue->events.begin() + pQueue->cEvents);
+	}
+
+	// The whole update is one delivery, so adding listeners and merge
+	// functions is deferred and the table can't grow while we hold a slot
+	DeliveryScope deliveryScope(*this);
+	while (pQueue->cDelivered < pQueue->cEvents)
+	{
+		// The events are sorted by type so a batch is a run of the same type
+		HashedStringId type = pQueue->events[pQueue->cDelivered].type;
+		int cBatch = 0;
+		while (cBatch < BATCH_SIZE_MAX && pQueue->cDelivered < pQueue->cEvents && pQueue->events[pQueue->cDelivered].type == type)
+		{
+			const QueuedEvent& queuedEvent = pQueue->events[pQueue->cDelivered];
+			const void* pData = queuedEvent.size > 0 ? &pQueue->data[queuedEvent.dataOffset] : NULL;
+			mBatch[cBatch] = Event(HashedString::fromId(type), pData, queuedEvent.size, queuedEvent.target);
+			cBatch++;
+			pQueue->cDelivered++;
+		}
+
+		ListenerSlot* pSlot = findSlot(type);
+		if (pSlot != NULL)
+		{
+			deliver(*pSlot, &mBatch[0], cBatch);
+		}
+
+		if (mTimer.getTime(Timer::ReturnType_MilliSeconds) >= budget)
+		{
+			break;
+		}
+	}
+
+	return pQueue->cDelivered == pQueue->cEvents && mQueues[mQueueIndex].cEvents == 0;
+}
+
+int EventManager::getQueuedCount() const
+{
+	const EventQueue& delivering = mQueues[1 - mQueueIndex];
+	return delivering.cEvents - delivering.cDelivered + mQueues[mQueueIndex].cEvents;
+}
+
+int EventManager::getMergedCount() const
+{
+	return mQueues[mQueueIndex].cMerged;
+}
+
+void EventManager::resetQueue(EventQueue& queue)
+{
+	if (queue.cEvents > 0)
+	{
+		std::fill(queue.coalesced.begin(), queue.coalesced.end(), -1);
+	}
+	queue.cEvents = 0;
+	queue.dataUsed = 0;
+	queue.cDelivered = 0;
+	queue.cMerged = 0;
+}
+
+EventManager::ListenerSlot* EventManager::findSlot(HashedStringId type)
+{
+	int index = mEventTypes.getIndex(type);
+	if (index != PerfectHashTable::NOT_FOUND)
+	{
+		return &mFixedSlots[index];
+	}
+
+	size_t mask = mSlots.size() - 1;
+	for (size_t i = static_cast<size_t>(type) & mask; mSlots[i].used; i = (i + 1) & mask)
+	{
+		if (mSlots[i].type == type)
+		{
+			return &mSlots[i];
+		}
+	}
+	return NULL;
+}
+
+EventManager::ListenerSlot& EventManager::getOrCreateSlot(HashedStringId type)
+{
+	ListenerSlot* pSlot = findSlot(type);
+	if (pSlot != NULL)
+	{
+		return *pSlot;
+	}
+
+	// Keep the table at most half full
+	if ((mcUsedSlots + 1) * 2 > static_cast<int>(mSlots.size()))
+	{
+		std::vector<ListenerSlot> oldSlots(mSlots.size() * 2);
+		oldSlots.swap(mSlots);
+		for (size_t i = 0; i < mSlots.size(); i++)
+		{
+			mSlots[i].used = false;
+		}
+		mcUsedSlots = 0;
+		for (size_t i = 0; i < oldSlots.size(); i++)
+		{
+			if (oldSlots[i].used)
+			{
+				ListenerSlot& slot = getOrCreateSlot(oldSlots[i].type);
+				slot.mergeFunction = oldSlots[i].mergeFunction;
+				slot.listeners.swap(oldSlots[i].listeners);
+			}
+		}
+	}
+
+	size_t mask = mSlots.size() - 1;
+	size_t i = static_cast<size_t>(type) & mask;
+	while (mSlots[i].used)
+	{
+		i = (i + 1) & mask;
+	}
+	mSlots[i].type = type;
+	mSlots[i].used = true;
+	mSlots[i].mergeFunction = NULL;
+	mcUsedSlots++;
+	return mSlots[i];
+}
+
+void EventManager::deliver(ListenerSlot& slot, const Event* pEvents, int cEvents)
+{
+	// Listeners added during the delivery are pending, so the size can't grow
+	size_t cListeners = slot.listeners.size();
+	for (size_t i = 0; i < cListeners; i++)
+	{
+		EventListener* pListener = slot.listeners[i];
+		if (pListener != NULL)
+		{
+			pListener->handleEvents(pEvents, cEvents);
+		}
+	}
+}
+
+void EventManager::endDelivery()
+{
+	mDeliveryDepth--;
+	if (mDeliveryDepth > 0)
+	{
+		return;
+	}
+
+	if (mListenersRemoved)
+	{
+		for (size_t i = 0; i < mFixedSlots.size(); i++)
+		{
+			std::vector<EventListener*>& listeners = mFixedSlots[i].listeners;
+			listeners.erase(std::remove(listeners.begin(), listeners.end(), static_cast<EventListener*>(NULL)), listeners.end());
+		}
+		for (size_t i = 0; i < mSlots.size(); i++)
+		{
+			std::vector<EventListener*>& listeners = mSlots[i].listeners;
+			listeners.erase(std::remove(listeners.begin(), listeners.end(), static_cast<EventListener*>(NULL)), listeners.end());
+		}
+		mListenersRemoved = false;
+	}
+
+	// Copy first since the table may grow when the listeners are added
+	std::vector<PendingListener> pendingListeners;
+	pendingListeners.swap(mPendingListeners);
+	for (size_t i = 0; i < pendingListeners.size(); i++)
+	{
+		addListener(pendingListeners[i].pListener, HashedString::fromId(pendingListeners[i].type));
+	}
+
+	std::vector<PendingCoalescing> pendingCoalescing;
+	pendingCoalescing.swap(mPendingCoalescing);
+	for (size_t i = 0; i < pendingCoalescing.size(); i++)
+	{
+		setCoalescing(HashedString::fromId(pendingCoalescing[i].type), pendingCoalescing[i].mergeFunction);
+	}
+}
\ No newline at end of file
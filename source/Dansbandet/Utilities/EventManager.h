@@ -0,0 +1,455 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Event manager keyed by HashedString. Events are either triggered and delivered
+* at once or queued and delivered grouped by type when the manager is updated.
+*/
+
+#ifndef __EVENT_MANAGER_H__
+#define __EVENT_MANAGER_H__
+
+#include "HashedString.h"
+#include "PerfectHash.h"
+#include "Timer.h"
+#include <vector>
+
+namespace utilities
+{
+
+/** The target of an event that isn't aimed at anything */
+const int EVENT_NO_TARGET = -1;
+
+/**
+* Merges the data of an event into the data of an earlier event of the same
+* type and target, e.g. sums the damage or keeps the latest position.
+* @param pMerged the data of the earlier event, the result is written here
+* @param pData the data of the event to merge into it
+*/
+typedef void (*EventMergeFunction)(void* pMerged, const void* pData);
+
+/**
+* An event that is delivered to the listeners. The data is only valid while the
+* event is being handled.
+*/
+class Event
+{
+public:
+	/**
+	* Constructor
+	* @param type the type of the event
+	* @param pData the data of the event, NULL if it has no data
+	* @param size size of the data in bytes
+	* @param target what the event is aimed at, e.g. the id of a bug
+	*/
+	Event(const HashedString& type, const void* pData, int size, int target = EVENT_NO_TARGET) :
+		mType(type), mpData(pData), mSize(size), mTarget(target) {}
+
+	/**
+	* Returns the type of the event
+	* @return type of the event
+	*/
+	inline const HashedString& getType() const
+	{
+		return mType;
+	}
+
+	/**
+	* Returns the data of the event as the struct it was triggered with
+	* @return the data
+	*/
+	template <typename T>
+	inline const T& getData() const
+	{
+		return *static_cast<const T*>(mpData);
+	}
+
+	/**
+	* Returns the raw data of the event
+	* @return the data, NULL if the event has no data
+	*/
+	inline const void* getData() const
+	{
+		return mpData;
+	}
+
+	/**
+	* Returns the size of the data
+	* @return size of the data in bytes
+	*/
+	inline int getSize() const
+	{
+		return mSize;
+	}
+
+	/**
+	* Returns what the event is aimed at
+	* @return the target, EVENT_NO_TARGET if the event isn't aimed at anything
+	*/
+	inline int getTarget() const
+	{
+		return mTarget;
+	}
+
+private:
+	HashedString mType;
+	const void* mpData;
+	int mSize;
+	int mTarget;
+};
+
+/**
+* Interface for classes that listen to events
+*/
+class EventListener
+{
+public:
+	/**
+	* Destructor
+	*/
+	virtual ~EventListener() {}
+
+	/**
+	* Handles an event of a type the listener has been added to
+	* @param event the event
+	*/
+	virtual void handleEvent(const Event& event) = 0;
+
+	/**
+	* Handles a batch of queued events of the same type. Override it to handle
+	* a whole batch in one call, by default each event is handled with
+	* handleEvent().
+	* @param pEvents the events
+	* @param cEvents number of events
+	*/
+	virtual void handleEvents(const Event* pEvents, int cEvents)
+	{
+		for (int i = 0; i < cEvents; i++)
+		{
+			handleEvent(pEvents[i]);
+		}
+	}
+};
+
+/**
+* Delivers events to the listeners of the event type. Typical usage:
+* @code
+* eventManager.addListener(this, HashedString::fromLiteral("bug_killed"));
+* eventManager.queueEvent(HashedString::fromLiteral("bug_killed"), bugKilledData);
+* // once per frame
+* eventManager.update(1.0f);
+* @endcode
+* The types in EventTypes.txt have a fixed slot each that is found with the
+* perfect hash table generated into EventTypes.h, other types are stored in an
+* open addressing table keyed by the hash of the type. Queued events are
+* delivered to EventListener::handleEvents() in batches of the same type.
+* Frequent events, e.g. damage from the minigun, can be coalesced so all events
+* of a type with the same target in a frame are merged into one:
+* @code
+* void mergeDamage(void* pMerged, const void* pData)
+* {
+*	static_cast<DamageData*>(pMerged)->damage += static_cast<const DamageData*>(pData)->damage;
+* }
+* eventManager.setCoalescing(damageType, mergeDamage);
+* eventManager.queueEvent(damageType, bugId, damageData);
+* @endcode
+* Queued events and their data are copied into buffers that are allocated
+* when the manager is created, so neither triggering nor queueing an event
+* allocates. Listeners may be added and removed while an event is delivered:
+* a removed listener gets no more events and an added listener gets events
+* after the current trigger() or update() is done.
+*/
+class EventManager
+{
+public:
+	/** Default maximum number of queued events per frame */
+	static const int QUEUE_SIZE_DEFAULT = 4096;
+
+	/** Default maximum number of bytes of event data per frame */
+	static const int DATA_SIZE_DEFAULT = 256 * 1024;
+
+	/**
+	* Constructor
+	* @param queueSize maximum number of events that can be queued between two updates
+	* @param dataSize maximum number of bytes of event data that can be queued between two updates
+	*/
+	EventManager(int queueSize = QUEUE_SIZE_DEFAULT, int dataSize = DATA_SIZE_DEFAULT);
+
+	/**
+	* Destructor
+	*/
+	~EventManager();
+
+	/** Maximum number of events in a batch, the budget is checked between batches */
+	static const int BATCH_SIZE_MAX = 256;
+
+	/**
+	* Makes queued events of a type coalesce, events with the same target are
+	* merged when they are queued so only one event per target is delivered.
+	* Events of the type need to have the same data size. Call at startup, a
+	* call during a delivery takes effect when the delivery is done.
+	* @param type the event type
+	* @param mergeFunction merges the data of two events, NULL to stop coalescing
+	*/
+	void setCoalescing(const HashedString& type, EventMergeFunction mergeFunction);
+
+	/**
+	* Adds a listener to an event type, does nothing if it's already added
+	* @param pListener the listener, needs to be removed before it's deleted
+	* @param type the event type
+	*/
+	void addListener(EventListener* pListener, const HashedString& type);
+
+	/**
+	* Removes a listener from an event type
+	* @param pListener the listener
+	* @param type the event type
+	*/
+	void removeListener(EventListener* pListener, const HashedString& type);
+
+	/**
+	* Removes a listener from all event types
+	* @param pListener the listener
+	*/
+	void removeListener(EventListener* pListener);
+
+	/**
+	* Delivers an event to all listeners at once
+	* @param type the event type
+	* @param pData the data of the event, NULL if it has no data
+	* @param size size of the data in bytes
+	* @return true if the event had any listeners
+	*/
+	bool trigger(const HashedString& type, const void* pData = NULL, int size = 0);
+
+	/**
+	* Delivers an event with data to all listeners at once
+	* @param type the event type
+	* @param data the data of the event
+	* @return true if the event had any listeners
+	*/
+	template <typename T>
+	inline bool trigger(const HashedString& type, const T& data)
+	{
+		return trigger(type, &data, sizeof(T));
+	}
+
+	/**
+	* Queues an event that is delivered in update(). The data is copied so it
+	* has to be plain old data without pointers to temporary objects.
+	* @param type the event type
+	* @param pData the data of the event, NULL if it has no data
+	* @param size size of the data in bytes
+	* @return false if the queue is full and the event was dropped
+	*/
+	bool queueEvent(const HashedString& type, const void* pData = NULL, int size = 0);
+
+	/**
+	* Queues an event with data that is delivered in update()
+	* @see queueEvent(const HashedString&, const void*, int)
+	*/
+	template <typename T>
+	inline bool queueEvent(const HashedString& type, const T& data)
+	{
+		return queueEvent(type, &data, sizeof(T));
+	}
+
+	/**
+	* Queues an event aimed at a target, if the type coalesces it's merged
+	* with an event of the same type and target that is already queued.
+	* @param type the event type
+	* @param target what the event is aimed at, e.g. the id of a bug
+	* @param pData the data of the event, NULL if it has no data
+	* @param size size of the data in bytes
+	* @return false if the queue is full and the event was dropped
+	*/
+	bool queueEvent(const HashedString& type, int target, const void* pData, int size);
+
+	/**
+	* Queues an event with data aimed at a target
+	* @see queueEvent(const HashedString&, int, const void*, int)
+	*/
+	template <typename T>
+	inline bool queueEvent(const HashedString& type, int target, const T& data)
+	{
+		return queueEvent(type, target, &data, sizeof(T));
+	}
+
+	/**
+	* Delivers the events that were queued before the update in batches of the
+	* same type. Events of the same type are delivered in the order they were
+	* queued, a coalesced event in the place of the first merged event.
+	* Events queued during the update are delivered in the next update. At
+	* least one event is delivered, the rest are delivered in the next update
+	* if the budget runs out.
+	* @param budget the time budget in milliseconds
+	* @return true if all events were delivered
+	*/
+	bool update(float budget);
+
+	/**
+	* Returns the number of queued events that haven't been delivered
+	* @return number of queued events
+	*/
+	int getQueuedCount() const;
+
+	/**
+	* Returns the number of events that have been merged into already queued
+	* events since the queue was last delivered
+	* @return number of merged events
+	*/
+	int getMergedCount() const;
+
+private:
+	/** Queued event data is aligned to this many bytes */
+	static const int DATA_ALIGNMENT = 8;
+
+	/** The listeners of an event type */
+	struct ListenerSlot
+	{
+		HashedStringId type;
+		bool used;
+		EventMergeFunction mergeFunction;		/**< NULL if the type doesn't coalesce */
+		std::vector<EventListener*> listeners;	/**< Removed listeners are NULL until the delivery is done */
+	};
+
+	/** A queued event, the data is stored in the data buffer of the queue */
+	struct QueuedEvent
+	{
+		HashedStringId type;
+		int order;			/**< The order the event was queued in */
+		int target;
+		int dataOffset;
+		int size;
+
+		bool operator<(const QueuedEvent& event) const
+		{
+			return type < event.type || (type == event.type && order < event.order);
+		}
+	};
+
+	/** Events queued between two updates */
+	struct EventQueue
+	{
+		std::vector<QueuedEvent> events;
+		std::vector<char> data;
+		std::vector<int> coalesced;		/**< Open addressing table of event indices keyed by type and target, -1 if empty */
+		int cEvents;
+		int dataUsed;
+		int cDelivered;
+		int cMerged;
+	};
+
+	/** A listener that was added during a delivery */
+	struct PendingListener
+	{
+		EventListener* pListener;
+		HashedStringId type;
+	};
+
+	/** A merge function that was set during a delivery */
+	struct PendingCoalescing
+	{
+		HashedStringId type;
+		EventMergeFunction mergeFunction;
+	};
+
+	/**
+	* Finds the listeners of an event type
+	* @param type the event type
+	* @return the listeners, NULL if the type has no slot
+	*/
+	ListenerSlot* findSlot(HashedStringId type);
+
+	/**
+	* Returns the listeners of an event type, creates the slot if needed.
+	* Mustn't be called during a delivery since the table may grow.
+	* @param type the event type
+	* @return the listeners
+	*/
+	ListenerSlot& getOrCreateSlot(HashedStringId type);
+
+	/**
+	* Resets a queue after all its events have been delivered
+	* @param queue the queue
+	*/
+	void resetQueue(EventQueue& queue);
+
+	/**
+	* Delivers events to the listeners in a slot, needs to be called within a
+	* DeliveryScope
+	* @param slot the listeners
+	* @param pEvents the events
+	* @param cEvents number of events
+	*/
+	void deliver(ListenerSlot& slot, const Event* pEvents, int cEvents);
+
+	/**
+	* Decreases mDeliveryDepth. When the outermost delivery is done the pending
+	* listeners and merge functions are added and the removed listeners are erased.
+	*/
+	void endDelivery();
+
+	/**
+	* Increases mDeliveryDepth for its lifetime and calls endDelivery() when it
+	* goes out of scope, also when a listener throws
+	*/
+	class DeliveryScope
+	{
+	public:
+		DeliveryScope(EventManager& eventManager) : mEventManager(eventManager)
+		{
+			mEventManager.mDeliveryDepth++;
+		}
+
+		~DeliveryScope()
+		{
+			mEventManager.endDelivery();
+		}
+
+	private:
+		EventManager& mEventManager;
+
+		// Not copyable
+		DeliveryScope(const DeliveryScope&);
+		DeliveryScope& operator=(const DeliveryScope&);
+	};
+	friend class DeliveryScope;
+
+	PerfectHashTable				mEventTypes;	/**< The event types in EventTypes.h */
+	std::vector<ListenerSlot>		mFixedSlots;	/**< One slot per event type in EventTypes.h, in index order */
+	std::vector<ListenerSlot>		mSlots;			/**< Open addressing table for other types, the size is a power of two */
+	int								mcUsedSlots;
+	EventQueue						mQueues[2];
+	int								mQueueIndex;	/**< The queue new events are added to, the other one is delivered */
+	int								mDeliveryDepth;	/**< Number of deliveries in progress, deliveries can be nested */
+	bool							mListenersRemoved;
+	std::vector<PendingListener>	mPendingListeners;
+	std::vector<PendingCoalescing>	mPendingCoalescing;
+	std::vector<Event>				mBatch;			/**< The batch that is delivered */
+	Timer							mTimer;
+
+	// Not copyable
+	EventManager(const EventManager&);
+	EventManager& operator=(const EventManager&);
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+// Generated by PerfectHashTable::writeHeader(), don't edit
+
+#ifndef __EVENT_TYPES_H__
+#define __EVENT_TYPES_H__
+
+#include "../Utilities/HashedString.h"
+
+const unsigned int EVENT_TYPES_SEED = 0u;
+const int EVENT_TYPES_BUCKET_COUNT = 5;
+const int EVENT_TYPES_KEY_COUNT = 18;
+
+const unsigned short EVENT_TYPES_DISPLACEMENTS[EVENT_TYPES_BUCKET_COUNT] =
+{
+	7, 3, 23, 1, 5
+};
+
+const utilities::HashedStringId EVENT_TYPES_KEYS[EVENT_TYPES_KEY_COUNT] =
+{
+	0x961cfbcbbd5ab908ULL,	// tank_damaged
+	0xfe648d0825f15e30ULL,	// player_left
+	0x0181640dc037b007ULL,	// tank_recovered
+	0x9fbeb66a0aa72173ULL,	// civilian_killed
+	0xc44bd6838bea3f00ULL,	// civilian_panicked
+	0xe680ff62d95378c6ULL,	// bug_hole_opened
+	0x70f6717b73cf14a6ULL,	// tank_destroyed
+	0x31121df3b1ba0630ULL,	// mission_failed
+	0x90a249dac1b2bc5cULL,	// player_joined
+	0xc416cef5696cdb8cULL,	// bug_damaged
+	0x8ade230eb2df18d7ULL,	// mission_started
+	0xfc5f66f8f01ad284ULL,	// tank_hijacked
+	0xcb9f8cd7cd0e00b8ULL,	// bug_spawned
+	0x92412974fe23184dULL,	// bug_killed
+	0x9b39891e5947f825ULL,	// mission_completed
+	0x88f312250ca38201ULL,	// bug_hole_closed
+	0x5cc0b0699ba2499fULL,	// weapon_fired
+	0xa2cf11eedd6660deULL 	// weapon_changed
+};
+
+const char* const EVENT_TYPES_NAMES[EVENT_TYPES_KEY_COUNT] =
+{
+	"tank_damaged",
+	"player_left",
+	"tank_recovered",
+	"civilian_killed",
+	"civilian_panicked",
+	"bug_hole_opened",
+	"tank_destroyed",
+	"mission_failed",
+	"player_joined",
+	"bug_damaged",
+	"mission_started",
+	"tank_hijacked",
+	"bug_spawned",
+	"bug_killed",
+	"mission_completed",
+	"bug_hole_closed",
+	"weapon_fired",
+	"weapon_changed"
+};
+
+const int EVENT_TYPES_INDEX_TANK_DAMAGED = 0;
+const int EVENT_TYPES_INDEX_PLAYER_LEFT = 1;
+const int EVENT_TYPES_INDEX_TANK_RECOVERED = 2;
+const int EVENT_TYPES_INDEX_CIVILIAN_KILLED = 3;
+const int EVENT_TYPES_INDEX_CIVILIAN_PANICKED = 4;
+const int EVENT_TYPES_INDEX_BUG_HOLE_OPENED = 5;
+const int EVENT_TYPES_INDEX_TANK_DESTROYED = 6;
+const int EVENT_TYPES_INDEX_MISSION_FAILED = 7;
+const int EVENT_TYPES_INDEX_PLAYER_JOINED = 8;
+const int EVENT_TYPES_INDEX_BUG_DAMAGED = 9;
+const int EVENT_TYPES_INDEX_MISSION_STARTED = 10;
+const int EVENT_TYPES_INDEX_TANK_HIJACKED = 11;
+const int EVENT_TYPES_INDEX_BUG_SPAWNED = 12;
+const int EVENT_TYPES_INDEX_BUG_KILLED = 13;
+const int EVENT_TYPES_INDEX_MISSION_COMPLETED = 14;
+const int EVENT_TYPES_INDEX_BUG_HOLE_CLOSED = 15;
+const int EVENT_TYPES_INDEX_WEAPON_FIRED = 16;
+const int EVENT_TYPES_INDEX_WEAPON_CHANGED = 17;
+
+// The header needs to be generated again if the hash function has changed
+typedef char EVENT_TYPES_HASH_CHECK[utilities::StaticHashedString<116, 97, 110, 107, 95, 100, 97, 109, 97, 103, 101, 100>::value == 0x961cfbcbbd5ab908ULL ? 1 : -1];
+
+#endif
\ No newline at end of file
@@ -0,0 +1,158 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Fast polynomial approximations of trigonometric functions, both scalar and SSE
+* versions that handle four values at a time. The error bounds are measured
+* against the double precision functions of the standard library.
+*/
+
+#ifndef __FAST_MATH_H__
+#define __FAST_MATH_H__
+
+#include "Constants.h"
+#include <emmintrin.h>
+#include <cmath>
+
+namespace utilities
+{
+namespace math
+{
+
+/**
+* Fast atan2 with a minimax polynomial. The maximum error is less than 3e-6
+* radians in the whole range.
+* @param y the y-value
+* @param x the x-value
+* @return the angle of (x, y) in radians between -PI and PI, 0 if both are 0.
+* Unlike atan2f -0.0f is treated as 0.0f, i.e. fastAtan2(-0.0f, -1.0f) is PI.
+*/
+inline float fastAtan2(float y, float x)
+{
+	float absX = fabsf(x);
+	float absY = fabsf(y);
+	float maxValue = absX > absY ? absX : absY;
+	if (maxValue == 0.0f)
+	{
+		return 0.0f;
+	}
+
+	// atan(a) for a in [0, 1], then mirror into the right octant
+	float a = (absX > absY ? absY : absX) / maxValue;
+	float s = a * a;
+	float angle = a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f + s * (-0.11643287f + s * (0.05265332f + s * -0.01172120f)))));
+
+	if (absY > absX)
+	{
+		angle = PI_HALF - angle;
+	}
+	if (x < 0.0f)
+	{
+		angle = PI - angle;
+	}
+	if (y < 0.0f)
+	{
+		angle = -angle;
+	}
+	return angle;
+}
+
+/**
+* Fast sine and cosine of the same angle. The angle is reduced to
+* [-PI/4, PI/4] and minimax polynomials are used for the reduced angle. The
+* maximum error is less than 2e-7 for angles between -100 PI and 100 PI, the
+* error grows for larger angles.
+* @param radian the angle in radians
+* @param sine set to the sine of the angle
+* @param cosine set to the cosine of the angle
+*/
+inline void fastSinCos(float radian, float& sine, float& cosine)
+{
+	// radian = quadrant * PI/2 + reduced, PI/2 is split in three parts so
+	// the subtraction is exact for moderate quadrants
+	int quadrant = static_cast<int>(radian * 0.636619772f + (radian >= 0.0f ? 0.5f : -0.5f));
+	float quadrantFloat = static_cast<float>(quadrant);
+	float reduced = ((radian - quadrantFloat * 1.5703125f) - quadrantFloat * 4.837512969970703125e-4f) - quadrantFloat * 7.54978995489188216e-8f;
+	float z = reduced * reduced;
+
+	float reducedSine = reduced + reduced * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+	float reducedCosine = 1.0f - 0.5f * z + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+
+	switch (quadrant & 3)
+	{
+	case 0:
+		sine = reducedSine;
+		cosine = reducedCosine;
+		break;
+	case 1:
+		sine = reducedCosine;
+		cosine = -reducedSine;
+		break;
+	case 2:
+		sine = -reducedSine;
+		cosine = -reducedCosine;
+		break;
+	default:
+		sine = -reducedCosine;
+		cosine = reducedSine;
+		break;
+	}
+}
+
+/**
+* SSE version of fastSinCos() that calculates four angles at a time, it has the
+* same error bounds as fastSinCos().
+* @param radians the angles in radians
+* @param sines set to the sines of the angles
+* @param cosines set to the cosines of the angles
+*/
+inline void fastSinCos4(__m128 radians, __m128& sines, __m128& cosines)
+{
+	// Round to nearest, the default rounding mode
+	__m128i quadrants = _mm_cvtps_epi32(_mm_mul_ps(radians, _mm_set1_ps(0.636619772f)));
+	__m128 quadrantsFloat = _mm_cvtepi32_ps(quadrants);
+	__m128 reduced = _mm_sub_ps(radians, _mm_mul_ps(quadrantsFloat, _mm_set1_ps(1.5703125f)));
+	reduced = _mm_sub_ps(reduced, _mm_mul_ps(quadrantsFloat, _mm_set1_ps(4.837512969970703125e-4f)));
+	reduced = _mm_sub_ps(reduced, _mm_mul_ps(quadrantsFloat, _mm_set1_ps(7.54978995489188216e-8f)));
+	__m128 z = _mm_mul_ps(reduced, reduced);
+
+	__m128 reducedSine = _mm_add_ps(_mm_set1_ps(8.3321608736e-3f), _mm_mul_ps(z, _mm_set1_ps(-1.9515295891e-4f)));
+	reducedSine = _mm_add_ps(_mm_set1_ps(-1.6666654611e-1f), _mm_mul_ps(z, reducedSine));
+	reducedSine = _mm_add_ps(reduced, _mm_mul_ps(_mm_mul_ps(reduced, z), reducedSine));
+
+	__m128 reducedCosine = _mm_add_ps(_mm_set1_ps(-1.388731625493765e-3f), _mm_mul_ps(z, _mm_set1_ps(2.443315711809948e-5f)));
+	reducedCosine = _mm_add_ps(_mm_set1_ps(4.166664568298827e-2f), _mm_mul_ps(z, reducedCosine));
+	reducedCosine = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_mul_ps(_mm_mul_ps(z, z), reducedCosine));
+
+	// Odd quadrants swap sine and cosine. Bit 1 of the quadrant, moved to the
+	// sign bit, negates the sine and bit 1 of quadrant + 1 negates the cosine.
+	__m128 swapMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrants, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	__m128 sineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrants, _mm_set1_epi32(2)), 30));
+	__m128 cosineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrants, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+	sines = _mm_or_ps(_mm_and_ps(swapMask, reducedCosine), _mm_andnot_ps(swapMask, reducedSine));
+	cosines = _mm_or_ps(_mm_and_ps(swapMask, reducedSine), _mm_andnot_ps(swapMask, reducedCosine));
+	sines = _mm_xor_ps(sines, sineSign);
+	cosines = _mm_xor_ps(cosines, cosineSign);
+}
+}
+}
+
+#endif
\ No newline at end of file
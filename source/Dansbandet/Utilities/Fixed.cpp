@@ -0,0 +1,176 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Q16.16 fixed-point number for deterministic simulation, e.g. lockstep
+* multiplayer where all clients need bit-exact results. All arithmetic, square
+* root and trigonometric functions use integer math only.
+*/
+
+#include "Fixed.h"
+
+using namespace utilities;
+
+namespace
+{
+// The trigonometric functions work with Q2.30 internally for precision
+const int Q30_BITS = 30;
+const long long Q30_ONE = 1LL << Q30_BITS;
+const long long Q30_PI_HALF = 1686629713LL;
+const long long Q30_PI = 3373259426LL;
+
+/**
+* Multiplies two Q2.30 values
+*/
+inline long long multiplyQ30(long long left, long long right)
+{
+	return (left * right) >> Q30_BITS;
+}
+
+/**
+* Converts a Q2.30 value to a Q16.16 fixed-point number, rounded to nearest
+*/
+inline Fixed q30ToFixed(long long value)
+{
+	const int shift = Q30_BITS - Fixed::FRACTION_BITS;
+	return Fixed::fromRaw(static_cast<int>((value + (1LL << (shift - 1))) >> shift));
+}
+}
+
+Fixed Fixed::sqrt() const
+{
+	if (mRaw <= 0)
+	{
+		return Fixed();
+	}
+
+	// sqrt(raw / 2^16) * 2^16 = sqrt(raw * 2^16)
+	return fromRaw(static_cast<int>(fixedMath::sqrt64(static_cast<unsigned long long>(mRaw) << FRACTION_BITS)));
+}
+
+unsigned long long fixedMath::sqrt64(unsigned long long value)
+{
+	// Bit by bit, one result bit per iteration
+	unsigned long long result = 0;
+	unsigned long long bit = 1ULL << 62;
+	while (bit > value)
+	{
+		bit >>= 2;
+	}
+
+	while (bit != 0)
+	{
+		if (value >= result + bit)
+		{
+			value -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else
+		{
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return result;
+}
+
+void fixedMath::sinCos(Fixed radian, Fixed& sine, Fixed& cosine)
+{
+	// radian = quadrant * PI/2 + reduced, where reduced is in [-PI/4, PI/4]
+	long long radianQ30 = static_cast<long long>(radian.getRaw()) << (Q30_BITS - Fixed::FRACTION_BITS);
+	long long halfQuadrant = radianQ30 >= 0 ? Q30_PI_HALF / 2 : -Q30_PI_HALF / 2;
+	long long quadrant = (radianQ30 + halfQuadrant) / Q30_PI_HALF;
+	long long reduced = radianQ30 - quadrant * Q30_PI_HALF;
+	long long z = multiplyQ30(reduced, reduced);
+
+	// Taylor series in Horner form, the first omitted term is less than 4e-7 for |reduced| <= PI/4
+	long long reducedSine = Q30_ONE - z / 42;
+	reducedSine = Q30_ONE - multiplyQ30(z, reducedSine) / 20;
+	reducedSine = Q30_ONE - multiplyQ30(z, reducedSine) / 6;
+	reducedSine = multiplyQ30(reduced, reducedSine);
+
+	long long reducedCosine = Q30_ONE - z / 56;
+	reducedCosine = Q30_ONE - multiplyQ30(z, reducedCosine) / 30;
+	reducedCosine = Q30_ONE - multiplyQ30(z, reducedCosine) / 12;
+	reducedCosine = Q30_ONE - multiplyQ30(z, reducedCosine) / 2;
+
+	switch (quadrant & 3)
+	{
+	case 0:
+		sine = q30ToFixed(reducedSine);
+		cosine = q30ToFixed(reducedCosine);
+		break;
+	case 1:
+		sine = q30ToFixed(reducedCosine);
+		cosine = q30ToFixed(-reducedSine);
+		break;
+	case 2:
+		sine = q30ToFixed(-reducedSine);
+		cosine = q30ToFixed(-reducedCosine);
+		break;
+	default:
+		sine = q30ToFixed(-reducedCosine);
+		cosine = q30ToFixed(reducedSine);
+		break;
+	}
+}
+
+Fixed fixedMath::atan2(long long y, long long x)
+{
+	long long absX = x < 0 ? -x : x;
+	long long absY = y < 0 ? -y : y;
+	long long maxValue = absX > absY ? absX : absY;
+	if (maxValue == 0)
+	{
+		return Fixed();
+	}
+
+	// Scale down so the shift below can't overflow
+	long long minValue = absX > absY ? absY : absX;
+	while (maxValue >= (1LL << 32))
+	{
+		maxValue >>= 1;
+		minValue >>= 1;
+	}
+
+	// atan(a) for a in [0, 1] with the same minimax polynomial as math::fastAtan2()
+	long long a = (minValue << Q30_BITS) / maxValue;
+	long long s = multiplyQ30(a, a);
+	long long angle = 56536072LL + multiplyQ30(s, -12585543LL);
+	angle = -125018842LL + multiplyQ30(s, angle);
+	angle = 207815708LL + multiplyQ30(s, angle);
+	angle = -357151731LL + multiplyQ30(s, angle);
+	angle = 1073717407LL + multiplyQ30(s, angle);
+	angle = multiplyQ30(a, angle);
+
+	if (absY > absX)
+	{
+		angle = Q30_PI_HALF - angle;
+	}
+	if (x < 0)
+	{
+		angle = Q30_PI - angle;
+	}
+	if (y < 0)
+	{
+		angle = -angle;
+	}
+	return q30ToFixed(angle);
+}
\ No newline at end of file
@@ -0,0 +1,313 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Q16.16 fixed-point number for deterministic simulation, e.g. lockstep
+* multiplayer where all clients need bit-exact results. All arithmetic, square
+* root and trigonometric functions use integer math only.
+*/
+
+#ifndef __FIXED_H__
+#define __FIXED_H__
+
+#include "Exception.h"
+
+namespace utilities
+{
+
+/**
+* A Q16.16 fixed-point number, 16 bits integer part and 16 bits fraction. The
+* range is [-32768, 32768) with a resolution of 1/65536.
+* All operations give the same result on all platforms, provided that right
+* shifts of negative values are arithmetic and that integer division truncates
+* towards zero, which is the case for all compilers we use.
+* Convert from float only when setting up the simulation, e.g. when loading a
+* level, and to float only for rendering.
+*/
+class Fixed
+{
+public:
+	/**
+	* Thrown when dividing by zero
+	*/
+	class DivisionByZeroException : public Exception
+	{
+	public:
+		DivisionByZeroException() : Exception("FixedDivisionByZeroException: Division by zero!", 70011) {}
+	};
+
+	/** Number of fraction bits */
+	static const int FRACTION_BITS = 16;
+
+	/** The raw value of 1.0 */
+	static const int RAW_ONE = 1 << FRACTION_BITS;
+
+	/**
+	* Default constructor, the value is 0
+	*/
+	inline Fixed() : mRaw(0) {}
+
+	/**
+	* Constructor that converts an integer
+	* @param value the integer value
+	*/
+	explicit inline Fixed(int value) : mRaw(value * RAW_ONE) {}
+
+	/**
+	* Creates a fixed-point number from a raw value
+	* @param raw the raw value, i.e. the value times 65536
+	* @return the fixed-point number
+	*/
+	static inline Fixed fromRaw(int raw)
+	{
+		Fixed fixed;
+		fixed.mRaw = raw;
+		return fixed;
+	}
+
+	/**
+	* Converts a float to the nearest fixed-point number. The conversion itself is
+	* deterministic, but only if the float is.
+	* @param value the float value
+	* @return the fixed-point number
+	*/
+	static inline Fixed fromFloat(float value)
+	{
+		// Scaling with a power of 2 is exact, adding 0.5 before flooring isn't
+		// from 2^23 and up. Floor the exact value and round half up on the
+		// fraction instead, the subtraction is exact since both are within 1.
+		float scaled = value * static_cast<float>(RAW_ONE);
+		int raw = static_cast<int>(scaled);
+		if (scaled < static_cast<float>(raw))
+		{
+			raw--;
+		}
+		if (scaled - static_cast<float>(raw) >= 0.5f)
+		{
+			raw++;
+		}
+		return fromRaw(raw);
+	}
+
+	/**
+	* Returns the raw value, i.e. the value times 65536
+	* @return the raw value
+	*/
+	inline int getRaw() const
+	{
+		return mRaw;
+	}
+
+	/**
+	* Converts the number to a float
+	* @return the value as a float
+	*/
+	inline float toFloat() const
+	{
+		return static_cast<float>(mRaw) * (1.0f / static_cast<float>(RAW_ONE));
+	}
+
+	/**
+	* Returns the integer part, rounded towards negative infinity
+	* @return the integer part
+	*/
+	inline int floor() const
+	{
+		return mRaw >> FRACTION_BITS;
+	}
+
+	inline Fixed operator+(const Fixed& fixed) const
+	{
+		return fromRaw(mRaw + fixed.mRaw);
+	}
+
+	inline Fixed operator-(const Fixed& fixed) const
+	{
+		return fromRaw(mRaw - fixed.mRaw);
+	}
+
+	inline Fixed operator-() const
+	{
+		return fromRaw(-mRaw);
+	}
+
+	/**
+	* Multiplication, the result is rounded towards negative infinity
+	* @param fixed the right-sided value
+	* @return the product
+	*/
+	inline Fixed operator*(const Fixed& fixed) const
+	{
+		return fromRaw(static_cast<int>((static_cast<long long>(mRaw) * fixed.mRaw) >> FRACTION_BITS));
+	}
+
+	/**
+	* Multiplication with an integer, this is exact
+	* @param value the integer to multiply with
+	* @return the product
+	*/
+	inline Fixed operator*(int value) const
+	{
+		return fromRaw(mRaw * value);
+	}
+
+	/**
+	* Division, the result is truncated towards zero
+	* @param fixed the right-sided value
+	* @return the quotient
+	* @throws DivisionByZeroException if fixed is 0
+	*/
+	inline Fixed operator/(const Fixed& fixed) const
+	{
+		if (fixed.mRaw == 0)
+		{
+			throw DivisionByZeroException();
+		}
+		return fromRaw(static_cast<int>((static_cast<long long>(mRaw) << FRACTION_BITS) / fixed.mRaw));
+	}
+
+	/**
+	* Division with an integer, the result is truncated towards zero
+	* @param value the integer to divide with
+	* @return the quotient
+	* @throws DivisionByZeroException if value is 0
+	*/
+	inline Fixed operator/(int value) const
+	{
+		if (value == 0)
+		{
+			throw DivisionByZeroException();
+		}
+		return fromRaw(mRaw / value);
+	}
+
+	inline Fixed& operator+=(const Fixed& fixed)
+	{
+		mRaw += fixed.mRaw;
+		return *this;
+	}
+
+	inline Fixed& operator-=(const Fixed& fixed)
+	{
+		mRaw -= fixed.mRaw;
+		return *this;
+	}
+
+	inline Fixed& operator*=(const Fixed& fixed)
+	{
+		*this = *this * fixed;
+		return *this;
+	}
+
+	inline Fixed& operator/=(const Fixed& fixed)
+	{
+		*this = *this / fixed;
+		return *this;
+	}
+
+	inline bool operator==(const Fixed& fixed) const
+	{
+		return mRaw == fixed.mRaw;
+	}
+
+	inline bool operator!=(const Fixed& fixed) const
+	{
+		return mRaw != fixed.mRaw;
+	}
+
+	inline bool operator<(const Fixed& fixed) const
+	{
+		return mRaw < fixed.mRaw;
+	}
+
+	inline bool operator<=(const Fixed& fixed) const
+	{
+		return mRaw <= fixed.mRaw;
+	}
+
+	inline bool operator>(const Fixed& fixed) const
+	{
+		return mRaw > fixed.mRaw;
+	}
+
+	inline bool operator>=(const Fixed& fixed) const
+	{
+		return mRaw >= fixed.mRaw;
+	}
+
+	/**
+	* Returns the absolute value
+	* @return the absolute value
+	*/
+	inline Fixed abs() const
+	{
+		return fromRaw(mRaw < 0 ? -mRaw : mRaw);
+	}
+
+	/**
+	* Returns the square root, rounded down
+	* @return the square root, 0 for negative values
+	*/
+	Fixed sqrt() const;
+
+private:
+	int mRaw;
+};
+
+namespace fixedMath
+{
+/** PI as a fixed-point number */
+const Fixed PI = Fixed::fromRaw(205887);
+
+/** PI/2 as a fixed-point number */
+const Fixed PI_HALF = Fixed::fromRaw(102944);
+
+/** 2 PI as a fixed-point number */
+const Fixed PI_TWO = Fixed::fromRaw(411775);
+
+/**
+* Returns the integer square root of a 64-bit value
+* @param value the value
+* @return the square root rounded down
+*/
+unsigned long long sqrt64(unsigned long long value);
+
+/**
+* Calculates the sine and cosine of an angle with integer math. The error is
+* less than one unit in the last place of the Q16.16 result.
+* @param radian the angle in radians
+* @param sine set to the sine of the angle
+* @param cosine set to the cosine of the angle
+*/
+void sinCos(Fixed radian, Fixed& sine, Fixed& cosine);
+
+/**
+* Calculates atan2 with integer math, the error is less than one unit in the
+* last place of the Q16.16 result. Only the ratio between y and x matters, so
+* the raw values can be of any scale.
+* @param y the y-value as a raw value
+* @param x the x-value as a raw value
+* @return the angle of (x, y) in radians between -PI and PI, 0 if both are 0
+*/
+Fixed atan2(long long y, long long x);
+}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* An array that can be reset in constant time by using generation stamps.
+*/
+
+#ifndef __GENERATION_ARRAY_H__
+#define __GENERATION_ARRAY_H__
+
+#include "Macros.h"
+#include <vector>
+
+namespace utilities
+{
+
+/**
+* An array where every element is stamped with the generation it was last
+* written in. Starting a new generation resets all elements to the default
+* value in constant time, an element is only reset when it's accessed the
+* first time in the new generation. Used for per-search node state so a
+* search never has to clear the whole map.
+*/
+template <typename T>
+class GenerationArray
+{
+public:
+	/**
+	* Constructor
+	* @param size the number of elements
+	* @param defaultValue the value all elements have at the start of a generation
+	*/
+	GenerationArray(int size = 0, const T& defaultValue = T()) :
+		mValues(size, defaultValue), mStamps(size, 0), mDefaultValue(defaultValue), mGeneration(1)
+	{
+	}
+
+	/**
+	* Changes the number of elements, all elements are reset
+	* @param size the new number of elements
+	*/
+	void resize(int size)
+	{
+		mValues.resize(size, mDefaultValue);
+		mStamps.resize(size, 0);
+		nextGeneration();
+	}
+
+	/**
+	* Resets all elements to the default value
+	*/
+	inline void nextGeneration()
+	{
+		mGeneration++;
+
+		// When the generation wraps we have to clear the stamps for real
+		if (mGeneration == 0)
+		{
+			for (size_t i = 0; i < mStamps.size(); i++)
+			{
+				mStamps[i] = 0;
+			}
+			mGeneration = 1;
+		}
+	}
+
+	/**
+	* Returns a reference to an element, resets it first if it hasn't been
+	* accessed in this generation.
+	* @param index the index of the element
+	* @return reference to the element
+	*/
+	inline T& get(int index)
+	{
+		if (mStamps[index] != mGeneration)
+		{
+			mStamps[index] = mGeneration;
+			mValues[index] = mDefaultValue;
+		}
+		return mValues[index];
+	}
+
+	/**
+	* Returns an element without touching it
+	* @param index the index of the element
+	* @return the element, or the default value if it hasn't been accessed in this generation
+	*/
+	inline const T& get(int index) const
+	{
+		return mStamps[index] == mGeneration ? mValues[index] : mDefaultValue;
+	}
+
+	/**
+	* Checks if an element has been accessed in this generation
+	* @param index the index of the element
+	* @return true if the element has been accessed
+	*/
+	inline bool isTouched(int index) const
+	{
+		return mStamps[index] == mGeneration;
+	}
+
+	/**
+	* Returns the number of elements
+	* @return the number of elements
+	*/
+	inline int size() const
+	{
+		return static_cast<int>(mValues.size());
+	}
+
+private:
+	std::vector<T>				mValues;
+	std::vector<unsigned int>	mStamps;		/**< The generation each element was last accessed in */
+	T							mDefaultValue;
+	unsigned int				mGeneration;	/**< The current generation, never 0 */
+};
+}
+
+#endif
\ No newline at end of file
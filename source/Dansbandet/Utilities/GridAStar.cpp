@@ -0,0 +1,153 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Plain A* over a PathCostMap, optionally restricted to a rectangle.
+*/
+
+#include "GridAStar.h"
+
+using namespace utilities;
+
+GridAStar::GridAStar(const PathCostMap& costMap) :
+	mCostMap(costMap), mNodes(costMap.getWidth() * costMap.getHeight()), mOpen(costMap.getWidth() * costMap.getHeight())
+{
+	mWidth = costMap.getWidth();
+	mcExpanded = 0;
+	mStatus = SearchStatus_NotFound;
+	mGoalIndex = -1;
+}
+
+GridAStar::~GridAStar()
+{
+}
+
+int GridAStar::findPath(const MapCoordinate& start, const MapCoordinate& goal, const PathBounds& bounds, VectorList<MapCoordinate>* pPath)
+{
+	beginSearch(start, goal, bounds);
+	while (step(INT_MAX) == SearchStatus_Searching)
+	{
+	}
+
+	if (mStatus == SearchStatus_Found && pPath != NULL)
+	{
+		getPath(pPath);
+	}
+	return getPathCost();
+}
+
+void GridAStar::beginSearch(const MapCoordinate& start, const MapCoordinate& goal, const PathBounds& bounds)
+{
+	mNodes.nextGeneration();
+	mOpen.clear();
+	mcExpanded = 0;
+	mGoal = goal;
+	mBounds = bounds;
+
+	if (!isPathWalkable(mCostMap, bounds, start.x, start.y) || !isPathWalkable(mCostMap, bounds, goal.x, goal.y))
+	{
+		mStatus = SearchStatus_NotFound;
+		mGoalIndex = -1;
+		return;
+	}
+
+	int startIndex = start.y * mWidth + start.x;
+	mGoalIndex = goal.y * mWidth + goal.x;
+	mStatus = SearchStatus_Searching;
+
+	mNodes.get(startIndex).cost = 0;
+	mOpen.push(startIndex, getPathHeuristic(start, goal));
+}
+
+GridAStar::SearchStatus GridAStar::step(int maxExpansions)
+{
+	if (mStatus != SearchStatus_Searching)
+	{
+		return mStatus;
+	}
+
+	for (int cExpanded = 0; cExpanded < maxExpansions; cExpanded++)
+	{
+		if (mOpen.empty())
+		{
+			mStatus = SearchStatus_NotFound;
+			return mStatus;
+		}
+
+		int index = mOpen.pop();
+		PathSearchNode& node = mNodes.get(index);
+		node.closed = true;
+		mcExpanded++;
+
+		if (index == mGoalIndex)
+		{
+			mStatus = SearchStatus_Found;
+			return mStatus;
+		}
+
+		MapCoordinate current(index % mWidth, index / mWidth);
+		for (int direction = 0; direction < 8; direction++)
+		{
+			int dx = PATH_DIRECTIONS_X[direction];
+			int dy = PATH_DIRECTIONS_Y[direction];
+			if (!canPathStep(mCostMap, mBounds, current.x, current.y, dx, dy))
+			{
+				continue;
+			}
+
+			MapCoordinate neighbour(current.x + dx, current.y + dy);
+			int neighbourIndex = neighbour.y * mWidth + neighbour.x;
+			PathSearchNode& neighbourNode = mNodes.get(neighbourIndex);
+			if (neighbourNode.closed)
+			{
+				continue;
+			}
+
+			int cost = node.cost + getPathStepCost(mCostMap, current, neighbour, direction >= 4);
+			if (cost < neighbourNode.cost)
+			{
+				neighbourNode.cost = cost;
+				neighbourNode.parent = index;
+				mOpen.push(neighbourIndex, cost + getPathHeuristic(neighbour, mGoal));
+			}
+		}
+	}
+
+	return mStatus;
+}
+
+void GridAStar::getPath(VectorList<MapCoordinate>* pPath)
+{
+	if (mStatus != SearchStatus_Found)
+	{
+		return;
+	}
+
+	mReversePath.clear();
+	for (int index = mGoalIndex; mNodes.get(index).parent != -1; index = mNodes.get(index).parent)
+	{
+		mReversePath.push_back(MapCoordinate(index % mWidth, index / mWidth));
+	}
+
+	for (int i = static_cast<int>(mReversePath.size()) - 1; i >= 0; i--)
+	{
+		pPath->add(mReversePath[i]);
+	}
+}
\ No newline at end of file
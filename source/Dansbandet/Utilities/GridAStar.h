@@ -0,0 +1,155 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Plain A* over a PathCostMap, optionally restricted to a rectangle.
+*/
+
+#ifndef __GRID_A_STAR_H__
+#define __GRID_A_STAR_H__
+
+#include "PathCostMap.h"
+#include "VectorList.h"
+#include "GenerationArray.h"
+#include "IndexedPriorityQueue.h"
+#include <vector>
+
+namespace utilities
+{
+
+/**
+* A* search on the grid. The node state is allocated once for the whole map
+* and stamped with a generation, so starting a search never clears the map.
+* A search can either be run at once with findPath() or be spread over several
+* frames with beginSearch() and step().
+*/
+class GridAStar
+{
+public:
+	enum SearchStatus
+	{
+		SearchStatus_Searching,
+		SearchStatus_Found,
+		SearchStatus_NotFound,
+	};
+
+	/**
+	* Constructor
+	* @param costMap the map to search in, needs to outlive the GridAStar
+	*/
+	GridAStar(const PathCostMap& costMap);
+
+	/**
+	* Destructor
+	*/
+	~GridAStar();
+
+	/**
+	* Searches for the cheapest path between two coordinates.
+	* @param start the coordinate to start from
+	* @param goal the coordinate we want to reach
+	* @param bounds the search is restricted to these bounds
+	* @param pPath if not NULL the path is added to it, excluding start but including goal
+	* @return cost of the path, PATH_NOT_FOUND if there is no path
+	* @throws VectorList::FullException if the path doesn't fit in pPath
+	*/
+	int findPath(const MapCoordinate& start, const MapCoordinate& goal, const PathBounds& bounds, VectorList<MapCoordinate>* pPath);
+
+	/**
+	* Searches for the cheapest path in the whole map.
+	* @see findPath(const MapCoordinate&, const MapCoordinate&, const PathBounds&, VectorList<MapCoordinate>*)
+	*/
+	inline int findPath(const MapCoordinate& start, const MapCoordinate& goal, VectorList<MapCoordinate>* pPath)
+	{
+		return findPath(start, goal, getPathBounds(mCostMap), pPath);
+	}
+
+	/**
+	* Starts an incremental search, call step() until it no longer returns
+	* SearchStatus_Searching.
+	* @param start the coordinate to start from
+	* @param goal the coordinate we want to reach
+	* @param bounds the search is restricted to these bounds
+	*/
+	void beginSearch(const MapCoordinate& start, const MapCoordinate& goal, const PathBounds& bounds);
+
+	/**
+	* Continues the search started with beginSearch()
+	* @param maxExpansions the maximum number of nodes to expand in this step
+	* @return status of the search
+	*/
+	SearchStatus step(int maxExpansions);
+
+	/**
+	* Returns the status of the current search
+	* @return status of the search
+	*/
+	inline SearchStatus getStatus() const
+	{
+		return mStatus;
+	}
+
+	/**
+	* Returns the cost of the path found by the current search
+	* @return cost of the path, PATH_NOT_FOUND if the search hasn't found a path
+	*/
+	inline int getPathCost() const
+	{
+		return mStatus == SearchStatus_Found ? mNodes.get(mGoalIndex).cost : PATH_NOT_FOUND;
+	}
+
+	/**
+	* Adds the path found by the current search to pPath, excluding start but
+	* including goal. Does nothing if no path has been found.
+	* @param pPath the list to add the path to
+	* @throws VectorList::FullException if the path doesn't fit in pPath
+	*/
+	void getPath(VectorList<MapCoordinate>* pPath);
+
+	/**
+	* Returns the number of nodes that were expanded in the last search
+	* @return number of expanded nodes
+	*/
+	inline int getExpandedCount() const
+	{
+		return mcExpanded;
+	}
+
+private:
+	const PathCostMap&					mCostMap;
+	int									mWidth;
+	GenerationArray<PathSearchNode>		mNodes;			/**< State of each map coordinate in the current search */
+	IndexedPriorityQueue				mOpen;			/**< Open nodes ordered by estimated total cost */
+	std::vector<MapCoordinate>			mReversePath;	/**< Scratch buffer when building the path */
+	int									mcExpanded;
+
+	// Current search
+	SearchStatus						mStatus;
+	MapCoordinate						mGoal;
+	int									mGoalIndex;
+	PathBounds							mBounds;
+
+	// Not copyable
+	GridAStar(const GridAStar&);
+	GridAStar& operator=(const GridAStar&);
+};
+}
+
+#endif
\ No newline at end of file
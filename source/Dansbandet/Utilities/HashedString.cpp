@@ -37,57 +37,403 @@
 
 
 #include "HashedString.h"
+#include "Macros.h"
+#include <pthread.h>
+#include <intrin.h>
+#include <emmintrin.h>
 
 using namespace utilities;
 
-void* HashedString::hashName(char const* pIdentStr)
+namespace
 {
-	//Largest prime number smaller than 65536
-	unsigned long BASE = 65521L;
+/**
+* Loads up to 8 characters as a little endian word and converts the ASCII
+* characters to lower case, 8 at a time
+* @param pStr the characters
+* @param cChars number of characters to load, at most 8
+* @return the lower case word, the same as getHashedStringWord()
+*/
+inline HashedStringId loadLowerWord(const char* pStr, size_t cChars)
+{
+	HashedStringId word = 0;
+	memcpy(&word, pStr, cChars);
 
-	//NMAX is the largest n such that 255n(n+1)/2+
-	//(n+1)(BASE-1) <= 2^32-1
-	unsigned long NMAX = 5552;
+	// Sets the high bit of each byte that is 'A' to 'Z', the additions can't
+	// carry into the next byte since the high bits are masked away first
+	HashedStringId lowBits = word & 0x7f7f7f7f7f7f7f7fULL;
+	HashedStringId aboveZ = lowBits + 0x2525252525252525ULL;
+	HashedStringId atLeastA = lowBits + 0x3f3f3f3f3f3f3f3fULL;
+	HashedStringId upper = atLeastA & ~aboveZ & ~word & 0x8080808080808080ULL;
+	return word | (upper >> 2);
+}
 
-#define DO1(buf,i)  {s1 += tolower(buf[i]); s2 += s1;}
-#define DO2(buf,i)  DO1(buf,i); DO1(buf,i+1);
-#define DO4(buf,i)  DO2(buf,i); DO2(buf,i+2);
-#define DO8(buf,i)  DO4(buf,i); DO4(buf,i+4);
-#define DO16(buf)   DO8(buf,0); DO8(buf,8);
+/**
+* Converts the ASCII characters of 16 bytes to lower case
+* @param bytes the characters
+* @return the lower case characters
+*/
+inline __m128i toLower(__m128i bytes)
+{
+	// Characters above 127 are negative and thus never upper case
+	__m128i upper = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(bytes, _mm_set1_epi8('Z' + 1)));
+	return _mm_or_si128(bytes, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
 
-	if (pIdentStr == NULL)
+/** The keys of the four lanes in hashLongName() and how much they change each stripe */
+__declspec(align(16)) const HashedStringId LONG_NAME_KEYS[4] = {HASHED_STRING_SEED, HASHED_STRING_PRIME_1, HASHED_STRING_PRIME_2, HASHED_STRING_FINALIZE_1};
+__declspec(align(16)) const HashedStringId LONG_NAME_KEY_STEP[2] = {HASHED_STRING_FINALIZE_2, HASHED_STRING_SEED};
+
+/**
+* Hashes a long string, e.g. an asset path. 32 characters are hashed at a time
+* into four 64-bit lanes, each lane adds the product of the low and high half
+* of the characters xor a key. The key changes with each stripe so the order
+* of the stripes matter. The lanes and the characters after the last stripe
+* are then mixed with the same rounds as short strings.
+* @param pStr the string
+* @param length number of characters, at least HASHED_STRING_LONG_LENGTH
+* @return the hash value
+*/
+HashedStringId hashLongName(const char* pStr, size_t length)
+{
+	__m128i accumulator0 = _mm_setzero_si128();
+	__m128i accumulator1 = _mm_setzero_si128();
+	__m128i key0 = _mm_load_si128(reinterpret_cast<const __m128i*>(LONG_NAME_KEYS));
+	__m128i key1 = _mm_load_si128(reinterpret_cast<const __m128i*>(LONG_NAME_KEYS + 2));
+	const __m128i keyStep = _mm_load_si128(reinterpret_cast<const __m128i*>(LONG_NAME_KEY_STEP));
+
+	size_t i = 0;
+	for (; i + 32 <= length; i += 32)
+	{
+		__m128i chars0 = toLower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pStr + i)));
+		__m128i chars1 = toLower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pStr + i + 16)));
+		__m128i keyed0 = _mm_xor_si128(chars0, key0);
+		__m128i keyed1 = _mm_xor_si128(chars1, key1);
+		accumulator0 = _mm_add_epi64(accumulator0, _mm_mul_epu32(keyed0, _mm_srli_epi64(keyed0, 32)));
+		accumulator1 = _mm_add_epi64(accumulator1, _mm_mul_epu32(keyed1, _mm_srli_epi64(keyed1, 32)));
+		accumulator0 = _mm_add_epi64(accumulator0, _mm_shuffle_epi32(chars0, _MM_SHUFFLE(1, 0, 3, 2)));
+		accumulator1 = _mm_add_epi64(accumulator1, _mm_shuffle_epi32(chars1, _MM_SHUFFLE(1, 0, 3, 2)));
+		key0 = _mm_add_epi64(key0, keyStep);
+		key1 = _mm_add_epi64(key1, keyStep);
+	}
+
+	__declspec(align(16)) HashedStringId lanes[4];
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanes), accumulator0);
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanes + 2), accumulator1);
+
+	HashedStringId hash = HASHED_STRING_SEED;
+	for (int lane = 0; lane < 4; lane++)
+	{
+		hash = hashedStringRound(hash, lanes[lane]);
+	}
+	for (; i + 8 <= length; i += 8)
+	{
+		hash = hashedStringRound(hash, loadLowerWord(pStr + i, 8));
+	}
+	if (i < length)
+	{
+		hash = hashedStringRound(hash, loadLowerWord(pStr + i, length - i));
+	}
+	return hashedStringFinalize(hash, length);
+}
+
+/** Number of slots in the first lookup table, the table is doubled when half full */
+const unsigned long POOL_TABLE_SIZE_MIN = 1024;
+
+/** Size of an arena block, longer strings get a block of their own */
+const size_t POOL_BLOCK_SIZE = 64 * 1024;
+
+/**
+* A slot in the lookup table, empty as long as pStr is NULL. The id is always
+* written before pStr so a reader that sees pStr also sees the right id.
+*/
+struct PoolSlot
+{
+	volatile HashedStringId id;
+	const char* volatile pStr;
+};
+
+/**
+* Open addressing lookup table. When the table grows the old one is kept until
+* clear() since a reader might still be looking in it.
+*/
+struct PoolTable
+{
+	PoolSlot* pSlots;
+	unsigned long mask;
+	PoolTable* pPrevious;
+};
+
+/**
+* Header of an arena block, the strings follow directly after it
+*/
+struct PoolBlock
+{
+	PoolBlock* pPrevious;
+	size_t size;
+	size_t cUsed;
+};
+
+// Only POD so the pool can be used during static initialization
+pthread_mutex_t gPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+PoolTable* volatile gpPoolTable = NULL;
+PoolBlock* gpPoolBlock = NULL;
+volatile int gcPoolStrings = 0;
+volatile int gcPoolCollisions = 0;
+
+/**
+* Returns the first slot to probe, the hash is already well mixed
+* @param id the hash value
+* @return index of the first slot to probe, before masking
+*/
+inline unsigned long getPoolSlotIndex(HashedStringId id)
+{
+	return static_cast<unsigned long>(id ^ (id >> 32));
+}
+
+#ifdef _DEBUG
+/**
+* Reports a collision if a string is interned with the same hash as a
+* different string, i.e. not only a different case
+* @param id the hash value
+* @param pInterned the string that was interned first
+* @param pIdentStr the string that is being interned
+*/
+void checkPoolCollision(HashedStringId id, const char* pInterned, const char* pIdentStr)
+{
+	for (size_t i = 0; ; i++)
+	{
+		if (HASHED_STRING_LOWER(pInterned[i]) != HASHED_STRING_LOWER(pIdentStr[i]))
+		{
+			break;
+		}
+		if (pInterned[i] == '\0')
+		{
+			return;
+		}
+	}
+
+	pthread_mutex_lock(&gPoolMutex);
+	gcPoolCollisions++;
+	pthread_mutex_unlock(&gPoolMutex);
+	ERROR_MESSAGE("HashedString collision, \"" << pIdentStr << "\" has the same hash as \"" << pInterned <<
+		"\": 0x" << std::hex << id << std::dec);
+}
+#endif
+
+/**
+* Finds the string of a hash value in a table, lock-free
+* @param pTable the table to look in, may be NULL
+* @param id the hash value
+* @return the string, NULL if not found
+*/
+const char* findPoolString(const PoolTable* pTable, HashedStringId id)
+{
+	if (pTable == NULL)
+	{
 		return NULL;
+	}
+
+	for (unsigned long i = getPoolSlotIndex(id) & pTable->mask; ; i = (i + 1) & pTable->mask)
+	{
+		const char* pStr = pTable->pSlots[i].pStr;
+		_ReadWriteBarrier();
+		if (pStr == NULL)
+		{
+			return NULL;
+		}
+		if (pTable->pSlots[i].id == id)
+		{
+			return pStr;
+		}
+	}
+}
 
-	unsigned long s1 = 0;
-	unsigned long s2 = 0;
+/**
+* Adds a string to a table that has room for it, requires the mutex
+* @param pTable the table
+* @param id the hash value
+* @param pStr the interned string
+*/
+void insertPoolString(PoolTable* pTable, HashedStringId id, const char* pStr)
+{
+	unsigned long i = getPoolSlotIndex(id) & pTable->mask;
+	while (pTable->pSlots[i].pStr != NULL)
+	{
+		i = (i + 1) & pTable->mask;
+	}
+	pTable->pSlots[i].id = id;
+	_ReadWriteBarrier();
+	pTable->pSlots[i].pStr = pStr;
+}
 
-	for (size_t len = strlen(pIdentStr); len > 0;)
+/**
+* Creates a new empty table
+* @param size number of slots, a power of two
+* @return the table
+*/
+PoolTable* createPoolTable(unsigned long size)
+{
+	PoolTable* pTable = myNew PoolTable;
+	pTable->pSlots = myNew PoolSlot[size];
+	for (unsigned long i = 0; i < size; i++)
 	{
-		unsigned long k = len < NMAX ? len : NMAX;
+		pTable->pSlots[i].id = 0;
+		pTable->pSlots[i].pStr = NULL;
+	}
+	pTable->mask = size - 1;
+	pTable->pPrevious = NULL;
+	return pTable;
+}
 
-		len -= k;
+/**
+* Makes sure the table has room for one more string, a bigger table is
+* published if needed. Requires the mutex.
+*/
+void reservePoolSlot()
+{
+	PoolTable* pTable = gpPoolTable;
+	if (pTable != NULL && static_cast<unsigned long>(gcPoolStrings + 1) * 2 <= pTable->mask + 1)
+	{
+		return;
+	}
 
-		while(k >= 16)
+	PoolTable* pNewTable = createPoolTable(pTable != NULL ? (pTable->mask + 1) * 2 : POOL_TABLE_SIZE_MIN);
+	if (pTable != NULL)
+	{
+		for (unsigned long i = 0; i <= pTable->mask; i++)
 		{
-			DO16(pIdentStr);
-			pIdentStr += 16;
-			k -= 16;
+			if (pTable->pSlots[i].pStr != NULL)
+			{
+				insertPoolString(pNewTable, pTable->pSlots[i].id, pTable->pSlots[i].pStr);
+			}
 		}
-		if (k!=0) do
+	}
+	pNewTable->pPrevious = pTable;
+
+	// The new table has to be filled before readers can see it
+	_ReadWriteBarrier();
+	gpPoolTable = pNewTable;
+}
+
+/**
+* Copies a string into the arena, requires the mutex
+* @param pStr the string to copy
+* @return the copy
+*/
+const char* copyPoolString(const char* pStr)
+{
+	size_t length = strlen(pStr) + 1;
+	if (gpPoolBlock == NULL || gpPoolBlock->size - gpPoolBlock->cUsed < length)
+	{
+		size_t size = length > POOL_BLOCK_SIZE ? length : POOL_BLOCK_SIZE;
+		PoolBlock* pBlock = reinterpret_cast<PoolBlock*>(myNew char[sizeof(PoolBlock) + size]);
+		pBlock->pPrevious = gpPoolBlock;
+		pBlock->size = size;
+		pBlock->cUsed = 0;
+		gpPoolBlock = pBlock;
+	}
+
+	char* pCopy = reinterpret_cast<char*>(gpPoolBlock + 1) + gpPoolBlock->cUsed;
+	memcpy(pCopy, pStr, length);
+	gpPoolBlock->cUsed += length;
+	return pCopy;
+}
+}
+
+HashedStringId HashedStringPool::intern(char const* pIdentStr)
+{
+	return intern(HashedString::hashName(pIdentStr), pIdentStr);
+}
+
+HashedStringId HashedStringPool::intern(HashedStringId id, char const* pIdentStr)
+{
+	if (pIdentStr == NULL)
+	{
+		return id;
+	}
+
+	const char* pInterned = findPoolString(gpPoolTable, id);
+	if (pInterned == NULL)
+	{
+		pthread_mutex_lock(&gPoolMutex);
+		// Another thread might have interned it while we waited
+		pInterned = findPoolString(gpPoolTable, id);
+		if (pInterned == NULL)
 		{
-			s1 += tolower(*pIdentStr++);
-			s2 += s1;
-		} while (--k);
+			reservePoolSlot();
+			pInterned = copyPoolString(pIdentStr);
+			insertPoolString(gpPoolTable, id, pInterned);
+			gcPoolStrings++;
+		}
+		pthread_mutex_unlock(&gPoolMutex);
+	}
+
+#ifdef _DEBUG
+	checkPoolCollision(id, pInterned, pIdentStr);
+#endif
+
+	return id;
+}
+
+const char* HashedStringPool::getStr(HashedStringId id)
+{
+	return findPoolString(gpPoolTable, id);
+}
+
+int HashedStringPool::getCount()
+{
+	return gcPoolStrings;
+}
+
+int HashedStringPool::getCollisionCount()
+{
+	return gcPoolCollisions;
+}
+
+void HashedStringPool::clear()
+{
+	pthread_mutex_lock(&gPoolMutex);
+	PoolTable* pTable = gpPoolTable;
+	while (pTable != NULL)
+	{
+		PoolTable* pPrevious = pTable->pPrevious;
+		SAFE_DELETE_ARRAY(pTable->pSlots);
+		SAFE_DELETE(pTable);
+		pTable = pPrevious;
+	}
+	gpPoolTable = NULL;
 
-		s1 %= BASE;
-		s2 %= BASE;
+	while (gpPoolBlock != NULL)
+	{
+		PoolBlock* pPrevious = gpPoolBlock->pPrevious;
+		delete [] reinterpret_cast<char*>(gpPoolBlock);
+		gpPoolBlock = pPrevious;
 	}
+	gcPoolStrings = 0;
+	gcPoolCollisions = 0;
+	pthread_mutex_unlock(&gPoolMutex);
+}
+
+HashedStringId HashedString::hashName(char const* pIdentStr)
+{
+	if (pIdentStr == NULL)
+		return 0;
 
-	return reinterpret_cast<void *>((s2 << 16) | s1);
+	size_t length = strlen(pIdentStr);
+	if (length >= HASHED_STRING_LONG_LENGTH)
+	{
+		return hashLongName(pIdentStr, length);
+	}
 
-#undef DO1
-#undef DO2
-#undef DO4
-#undef DO8
-#undef DO16
+	HashedStringId hash = HASHED_STRING_SEED;
+	size_t i = 0;
+	for (; i + 8 <= length; i += 8)
+	{
+		hash = hashedStringRound(hash, loadLowerWord(pIdentStr + i, 8));
+	}
+	if (i < length)
+	{
+		hash = hashedStringRound(hash, loadLowerWord(pIdentStr + i, length - i));
+	}
+	return hashedStringFinalize(hash, length);
 }
\ No newline at end of file
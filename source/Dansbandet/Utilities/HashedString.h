@@ -39,51 +39,390 @@
 
 
 #include <string>
+#include <cstddef>
 
 /*
 * This is a class that hashes a string to make it easier to use events and stuff.
+* The strings are interned in a global pool so a HashedString is only the hash
+* value and is cheap to copy.
 */
 
 namespace utilities
 {
 
+/**
+* The hash value of a HashedString. It's an integer so a hash calculated at
+* compile time with StaticHashedString can be used in switch statements and as
+* a template parameter.
+*/
+typedef unsigned long long HashedStringId;
+
+// Constants of the hash
+const HashedStringId HASHED_STRING_SEED = 0x9e3779b97f4a7c15ULL;
+const HashedStringId HASHED_STRING_PRIME_1 = 0x9fb21c651e98df25ULL;
+const HashedStringId HASHED_STRING_PRIME_2 = 0xc2b2ae3d27d4eb4fULL;
+const HashedStringId HASHED_STRING_FINALIZE_1 = 0xff51afd7ed558ccdULL;
+const HashedStringId HASHED_STRING_FINALIZE_2 = 0xc4ceb9fe1a85ec53ULL;
+
+/** Strings at least this long are hashed 32 characters at a time with SSE2 */
+const std::size_t HASHED_STRING_LONG_LENGTH = 64;
+
+/**
+* Converts an ASCII character to lower case at compile time, same as tolower()
+* for ASCII characters.
+*/
+#define HASHED_STRING_LOWER(c) ((c) >= 'A' && (c) <= 'Z' ? (c) - 'A' + 'a' : (c))
+
+/**
+* A lower case character shifted to its place in a little endian 8 character word
+*/
+#define HASHED_STRING_BYTE(c, i) (static_cast<HashedStringId>(static_cast<unsigned char>(HASHED_STRING_LOWER(c))) << (8 * (i)))
+
+/**
+* Mixes an 8 character word into the hash at compile time, same as hashedStringRound()
+*/
+template <HashedStringId H, HashedStringId W>
+struct HashedStringRound
+{
+	static const HashedStringId mixed = H ^ (W * HASHED_STRING_PRIME_1);
+	static const HashedStringId value = ((mixed << 31) | (mixed >> 33)) * HASHED_STRING_PRIME_2;
+};
+
+/**
+* Finalizes the hash at compile time, same as hashedStringFinalize()
+*/
+template <HashedStringId H, std::size_t L>
+struct HashedStringFinalize
+{
+	static const HashedStringId h0 = H ^ L;
+	static const HashedStringId h1 = (h0 ^ (h0 >> 33)) * HASHED_STRING_FINALIZE_1;
+	static const HashedStringId h2 = (h1 ^ (h1 >> 33)) * HASHED_STRING_FINALIZE_2;
+	static const HashedStringId value = h2 ^ (h2 >> 33);
+};
+
+/**
+* Lower case word of 8 characters at compile time, the characters after the
+* end of the string are 0.
+*/
+template <char C0, char C1, char C2, char C3, char C4, char C5, char C6, char C7>
+struct HashedStringWord
+{
+	static const HashedStringId value =
+		HASHED_STRING_BYTE(C0, 0) |
+		HASHED_STRING_BYTE(C1, 1) |
+		HASHED_STRING_BYTE(C2, 2) |
+		HASHED_STRING_BYTE(C3, 3) |
+		HASHED_STRING_BYTE(C4, 4) |
+		HASHED_STRING_BYTE(C5, 5) |
+		HASHED_STRING_BYTE(C6, 6) |
+		HASHED_STRING_BYTE(C7, 7);
+	static const std::size_t length =
+		(C0 != 0) +
+		(C1 != 0) +
+		(C2 != 0) +
+		(C3 != 0) +
+		(C4 != 0) +
+		(C5 != 0) +
+		(C6 != 0) +
+		(C7 != 0);
+};
+
+/**
+* Hashes the characters 8 at a time at compile time. H is the hash so far and
+* L the number of characters hashed, the first word is mixed in and the rest
+* of the characters are passed on until a 0 character is reached.
+*/
+template <HashedStringId H, std::size_t L, char C0, char C1, char C2, char C3, char C4, char C5, char C6, char C7, char C8, char C9, char C10, char C11, char C12, char C13, char C14, char C15, char C16, char C17, char C18, char C19, char C20, char C21, char C22, char C23, char C24, char C25, char C26, char C27, char C28, char C29, char C30, char C31>
+struct HashedStringChars
+{
+	typedef HashedStringWord<C0, C1, C2, C3, C4, C5, C6, C7> Word;
+	static const HashedStringId value = HashedStringChars<
+		HashedStringRound<H, Word::value>::value, L + Word::length,
+		C8, C9, C10, C11, C12, C13, C14, C15, C16, C17, C18, C19, C20, C21, C22, C23, C24, C25, C26, C27, C28, C29, C30, C31, 0, 0, 0, 0, 0, 0, 0, 0>::value;
+};
+
+/**
+* The end of the string
+*/
+template <HashedStringId H, std::size_t L, char C1, char C2, char C3, char C4, char C5, char C6, char C7, char C8, char C9, char C10, char C11, char C12, char C13, char C14, char C15, char C16, char C17, char C18, char C19, char C20, char C21, char C22, char C23, char C24, char C25, char C26, char C27, char C28, char C29, char C30, char C31>
+struct HashedStringChars<H, L, 0, C1, C2, C3, C4, C5, C6, C7, C8, C9, C10, C11, C12, C13, C14, C15, C16, C17, C18, C19, C20, C21, C22, C23, C24, C25, C26, C27, C28, C29, C30, C31>
+{
+	static const HashedStringId value = HashedStringFinalize<H, L>::value;
+};
+
+/**
+* Calculates the same hash as HashedString::hashName() at compile time for
+* ASCII strings of at most 32 characters. The string is given one character
+* per template parameter, value is then an integral constant:
+* @code
+* switch (eventType.getHashValue())
+* {
+* case StaticHashedString<'b','u','g','_','k','i','l','l','e','d'>::value:
+* @endcode
+*/
+template <
+	char C0,
+	char C1 = 0,
+	char C2 = 0,
+	char C3 = 0,
+	char C4 = 0,
+	char C5 = 0,
+	char C6 = 0,
+	char C7 = 0,
+	char C8 = 0,
+	char C9 = 0,
+	char C10 = 0,
+	char C11 = 0,
+	char C12 = 0,
+	char C13 = 0,
+	char C14 = 0,
+	char C15 = 0,
+	char C16 = 0,
+	char C17 = 0,
+	char C18 = 0,
+	char C19 = 0,
+	char C20 = 0,
+	char C21 = 0,
+	char C22 = 0,
+	char C23 = 0,
+	char C24 = 0,
+	char C25 = 0,
+	char C26 = 0,
+	char C27 = 0,
+	char C28 = 0,
+	char C29 = 0,
+	char C30 = 0,
+	char C31 = 0>
+struct StaticHashedString
+{
+	static const HashedStringId value = HashedStringChars<HASHED_STRING_SEED, 0, C0, C1, C2, C3, C4, C5, C6, C7, C8, C9, C10, C11, C12, C13, C14, C15, C16, C17, C18, C19, C20, C21, C22, C23, C24, C25, C26, C27, C28, C29, C30, C31>::value;
+};
+
+/**
+* Mixes an 8 character word into the hash
+* @param hash the hash so far
+* @param word the lower case characters, little endian
+* @return the new hash
+*/
+inline HashedStringId hashedStringRound(HashedStringId hash, HashedStringId word)
+{
+	HashedStringId mixed = hash ^ (word * HASHED_STRING_PRIME_1);
+	return ((mixed << 31) | (mixed >> 33)) * HASHED_STRING_PRIME_2;
+}
+
+/**
+* Finalizes the hash so all bits depend on all characters
+* @param hash the hash after the last round
+* @param length number of characters in the string
+* @return the hash value
+*/
+inline HashedStringId hashedStringFinalize(HashedStringId hash, std::size_t length)
+{
+	hash ^= length;
+	hash = (hash ^ (hash >> 33)) * HASHED_STRING_FINALIZE_1;
+	hash = (hash ^ (hash >> 33)) * HASHED_STRING_FINALIZE_2;
+	return hash ^ (hash >> 33);
+}
+
+/**
+* Returns a lower case word of up to 8 characters, one character at a time so
+* the compiler can calculate it for string literals
+* @param pStr the characters
+* @param cChars number of characters, at most 8
+* @return the word, little endian
+*/
+inline HashedStringId getHashedStringWord(const char* pStr, std::size_t cChars)
+{
+	return (cChars > 0 ? HASHED_STRING_BYTE(pStr[0], 0) : 0) |
+		(cChars > 1 ? HASHED_STRING_BYTE(pStr[1], 1) : 0) |
+		(cChars > 2 ? HASHED_STRING_BYTE(pStr[2], 2) : 0) |
+		(cChars > 3 ? HASHED_STRING_BYTE(pStr[3], 3) : 0) |
+		(cChars > 4 ? HASHED_STRING_BYTE(pStr[4], 4) : 0) |
+		(cChars > 5 ? HASHED_STRING_BYTE(pStr[5], 5) : 0) |
+		(cChars > 6 ? HASHED_STRING_BYTE(pStr[6], 6) : 0) |
+		(cChars > 7 ? HASHED_STRING_BYTE(pStr[7], 7) : 0);
+}
+
+/**
+* Unrolls the hash of a string literal so the compiler can calculate it when
+* optimizing, used by HashedString::hashLiteral()
+*/
+template <std::size_t N>
+struct HashedStringLiteral
+{
+	static inline HashedStringId hash(const char* pLiteral, HashedStringId hash)
+	{
+		return HashedStringLiteral<(N > 8 ? N - 8 : 0)>::hash(pLiteral + 8,
+			hashedStringRound(hash, getHashedStringWord(pLiteral, N > 8 ? 8 : N)));
+	}
+};
+
+template <>
+struct HashedStringLiteral<0>
+{
+	static inline HashedStringId hash(const char*, HashedStringId hash)
+	{
+		return hash;
+	}
+};
+
+/**
+* Hashes a string literal of N characters, short literals are unrolled and
+* long literals are hashed with HashedString::hashName(). Defined after
+* HashedString.
+*/
+template <std::size_t N, bool LONG_LITERAL = (N >= HASHED_STRING_LONG_LENGTH)>
+struct HashedStringLiteralHash;
+
+/**
+* The global pool of interned strings. Each string is copied once into an
+* append-only arena and can then be looked up by its hash. Looking up a string
+* never locks, interning a new string takes a lock so strings should preferably
+* be interned at startup.
+*/
+class HashedStringPool
+{
+public:
+	/**
+	* Hashes and interns a string, does nothing if it has already been interned.
+	* @param pIdentStr the string, NULL isn't interned
+	* @return the hash value of the string
+	*/
+	static HashedStringId intern(char const* pIdentStr);
+
+	/**
+	* Interns a string with a hash value that has already been calculated.
+	* @param id the hash value of pIdentStr
+	* @param pIdentStr the string, NULL isn't interned
+	* @return id
+	*/
+	static HashedStringId intern(HashedStringId id, char const* pIdentStr);
+
+	/**
+	* Returns the interned string of a hash value. Thread safe and lock-free.
+	* @param id the hash value
+	* @return the string as it was first interned, NULL if no string with the
+	* hash value has been interned
+	*/
+	static const char* getStr(HashedStringId id);
+
+	/**
+	* Returns the number of interned strings
+	* @return number of interned strings
+	*/
+	static int getCount();
+
+	/**
+	* Returns the number of times a string was interned with the same hash as
+	* a different string, the collisions are also reported with ERROR_MESSAGE.
+	* Only detected in debug builds.
+	* @return number of detected collisions, always 0 in release builds
+	*/
+	static int getCollisionCount();
+
+	/**
+	* Frees all interned strings. Not thread safe, call at shutdown when no
+	* HashedString is used anymore.
+	*/
+	static void clear();
+
+private:
+	// Only static functions
+	HashedStringPool();
+};
+
 class HashedString
 {
 public:
 
 	/**
-	* Constructor. Does basically nothing.
+	* Constructor. Interns the string if it hasn't been interned already, which
+	* only takes a lock the first time.
 	* @param pIdentString the string to be hashed.
 	*/
 	explicit HashedString(char const* const pIdentString) 
-				: mIdent(hashName(pIdentString)), mIdentStr(pIdentString)
+				: mIdent(HashedStringPool::intern(pIdentString))
+	{
+
+	}
+
+	/**
+	* Constructor with a hash value that has already been calculated, e.g. with
+	* StaticHashedString or hashLiteral(), so the string isn't hashed again.
+	* @param id the hash value of pIdentString
+	* @param pIdentString the string
+	*/
+	HashedString(HashedStringId id, char const* const pIdentString)
+				: mIdent(HashedStringPool::intern(id, pIdentString))
+	{
+
+	}
+
+	/**
+	* Creates a HashedString from a hash value without interning anything, e.g.
+	* from a StaticHashedString. getStr() only works if the string has been
+	* interned elsewhere.
+	* @param id the hash value
+	* @return the hashed string
+	*/
+	static HashedString fromId(HashedStringId id)
 	{
+		HashedString hashedString;
+		hashedString.mIdent = id;
+		return hashedString;
+	}
+
+	/**
+	* Creates a HashedString from a string literal, the hash is unrolled so
+	* the compiler calculates it when optimizing and no hashing is done at
+	* runtime.
+	* @param literal the string literal
+	* @return the hashed string
+	*/
+	template <std::size_t N>
+	static HashedString fromLiteral(const char (&literal)[N])
+	{
+		return HashedString(hashLiteral(literal), literal);
+	}
 
+	/**
+	* Calculates the hash of a string literal, the same value as hashName().
+	* The hash is unrolled so the compiler calculates it when optimizing.
+	* Literals of HASHED_STRING_LONG_LENGTH characters or more are hashed with
+	* hashName() at runtime.
+	* @param literal the string literal
+	* @return the hash value
+	*/
+	template <std::size_t N>
+	static inline HashedStringId hashLiteral(const char (&literal)[N])
+	{
+		return HashedStringLiteralHash<N - 1>::hash(literal);
 	}
 
 	/**
 	* Gets the hash value.
 	* @return Returns the hash value of the string
 	*/
-	unsigned long getHashValue(void) const
+	HashedStringId getHashValue(void) const
 	{
-		return reinterpret_cast<unsigned long>(mIdent);
+		return mIdent;
 	}
 
 	/**
-	* Gets the string representation.
-	*  @return returns the string representation of a hash
+	* Gets the string representation from the pool.
+	*  @return returns the string representation of a hash, NULL if it was
+	*  created with fromId() and the string has never been interned
 	*/
-	const std::string &getStr() const
+	const char* getStr() const
 	{
-		return mIdentStr;
+		return HashedStringPool::getStr(mIdent);
 	}
 
 	/*
-	* Relatively simple hash of arbitrary text string into a
-	* 32-bit identifier Output value is
-	* input-valid-deterministic, but no guarantees are made
-	* about the uniqueness of the output per-input
+	* Hash of arbitrary text string into a 64-bit identifier.
+	* Output value is input-valid-deterministic, different
+	* strings are very unlikely to get the same value and
+	* collisions are reported by the pool in debug builds.
 	*
 	* Input value is treated as lower-case to cut down on false
 	* separations cause by human mistypes. Sure, it could be
@@ -92,12 +431,13 @@ public:
 	* making this text case-sensitive will likely just lead to
 	* Pain and Suffering.
 	*
-	* This code loosely based upon the adler32 checksum by Mark
-	* Adler and published as part of the zlib compression
-	* library sources.
+	* The string is hashed 8 characters at a time with a
+	* multiply and rotate round and a murmur3 style finalizer,
+	* strings of HASHED_STRING_LONG_LENGTH characters or more
+	* are hashed 32 characters at a time with SSE2.
 	*
 	*/
-	static void *hashName(char const *pIdentStr);
+	static HashedStringId hashName(char const *pIdentStr);
 
 
 	bool operator < (HashedString const & o) const
@@ -114,8 +454,27 @@ public:
 
 
 private:
-	void* mIdent;
-	std::string mIdentStr;
+	HashedString() {}
+
+	HashedStringId mIdent;
+};
+
+template <std::size_t N>
+struct HashedStringLiteralHash<N, false>
+{
+	static inline HashedStringId hash(const char* pLiteral)
+	{
+		return hashedStringFinalize(HashedStringLiteral<N>::hash(pLiteral, HASHED_STRING_SEED), N);
+	}
+};
+
+template <std::size_t N>
+struct HashedStringLiteralHash<N, true>
+{
+	static inline HashedStringId hash(const char* pLiteral)
+	{
+		return HashedString::hashName(pLiteral);
+	}
 };
 }
 #endif
\ No newline at end of file
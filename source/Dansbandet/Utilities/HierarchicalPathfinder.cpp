@@ -0,0 +1,512 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Hierarchical pathfinding (HPA*).
+*/
+
+#include "HierarchicalPathfinder.h"
+#include <algorithm>
+#include <climits>
+
+using namespace utilities;
+
+HierarchicalPathfinder::HierarchicalPathfinder(const PathCostMap& costMap, int clusterSize) :
+	mCostMap(costMap), mGridSearch(costMap), mClusterSize(clusterSize)
+{
+	mcClustersX = (costMap.getWidth() + clusterSize - 1) / clusterSize;
+	mcClustersY = (costMap.getHeight() + clusterSize - 1) / clusterSize;
+
+	rebuild();
+}
+
+HierarchicalPathfinder::~HierarchicalPathfinder()
+{
+}
+
+void HierarchicalPathfinder::rebuild()
+{
+	mNodes.clear();
+	mFreeNodes.clear();
+	mClusterNodes.clear();
+	mClusterNodes.resize(mcClustersX * mcClustersY);
+
+	// Entrances to the right and below of each cluster
+	for (int clusterY = 0; clusterY < mcClustersY; clusterY++)
+	{
+		for (int clusterX = 0; clusterX < mcClustersX; clusterX++)
+		{
+			int cluster = clusterY * mcClustersX + clusterX;
+			if (clusterX + 1 < mcClustersX)
+			{
+				buildBorder(cluster, cluster + 1);
+			}
+			if (clusterY + 1 < mcClustersY)
+			{
+				buildBorder(cluster, cluster + mcClustersX);
+			}
+		}
+	}
+
+	for (int cluster = 0; cluster < mcClustersX * mcClustersY; cluster++)
+	{
+		buildIntraEdges(cluster);
+	}
+}
+
+void HierarchicalPathfinder::onCellChanged(const MapCoordinate& cell)
+{
+	int cluster = getClusterIndex(cell);
+	int neighbours[4];
+	getNeighbourClusters(cluster, neighbours);
+
+	// Remember the nodes on the other side of the borders, they might only have
+	// existed because of an entrance to this cluster
+	std::vector<int> outsideNodes;
+	const std::vector<int>& clusterNodes = mClusterNodes[cluster];
+	for (size_t i = 0; i < clusterNodes.size(); i++)
+	{
+		const std::vector<AbstractEdge>& edges = mNodes[clusterNodes[i]].edges;
+		for (size_t edge = 0; edge < edges.size(); edge++)
+		{
+			if (!edges[edge].intra)
+			{
+				outsideNodes.push_back(edges[edge].target);
+			}
+		}
+	}
+
+	// All nodes of the cluster are on its borders, remove them all
+	while (!mClusterNodes[cluster].empty())
+	{
+		removeNode(mClusterNodes[cluster].back());
+	}
+
+	for (size_t i = 0; i < outsideNodes.size(); i++)
+	{
+		AbstractNode& node = mNodes[outsideNodes[i]];
+		if (!node.used)
+		{
+			continue;
+		}
+
+		bool hasInterEdge = false;
+		for (size_t edge = 0; edge < node.edges.size() && !hasInterEdge; edge++)
+		{
+			hasInterEdge = !node.edges[edge].intra;
+		}
+		if (!hasInterEdge)
+		{
+			removeNode(outsideNodes[i]);
+		}
+	}
+
+	// Detect the entrances again, left and up neighbours have lower indices
+	for (int i = 0; i < 4; i++)
+	{
+		if (neighbours[i] != -1)
+		{
+			buildBorder((std::min)(cluster, neighbours[i]), (std::max)(cluster, neighbours[i]));
+		}
+	}
+
+	buildIntraEdges(cluster);
+	for (int i = 0; i < 4; i++)
+	{
+		if (neighbours[i] != -1)
+		{
+			buildIntraEdges(neighbours[i]);
+		}
+	}
+}
+
+bool HierarchicalPathfinder::findAbstractPath(const MapCoordinate& start, const MapCoordinate& goal, VectorList<MapCoordinate>& waypoints)
+{
+	waypoints.clear();
+
+	PathBounds mapBounds = getPathBounds(mCostMap);
+	if (!isPathWalkable(mCostMap, mapBounds, start.x, start.y) || !isPathWalkable(mCostMap, mapBounds, goal.x, goal.y))
+	{
+		return false;
+	}
+
+	// Within the same cluster we try to go directly first
+	int startCluster = getClusterIndex(start);
+	if (start == goal ||
+		(startCluster == getClusterIndex(goal) &&
+		mGridSearch.findPath(start, goal, getClusterBounds(startCluster), NULL) != PATH_NOT_FOUND))
+	{
+		waypoints.add(goal);
+		return true;
+	}
+
+	// Insert start and goal into the abstract graph
+	int startNode = findNode(start);
+	bool startIsTemporary = startNode == -1;
+	if (startIsTemporary)
+	{
+		startNode = getOrCreateNode(start);
+		connectToCluster(startNode);
+	}
+	int goalNode = findNode(goal);
+	bool goalIsTemporary = goalNode == -1;
+	if (goalIsTemporary)
+	{
+		goalNode = getOrCreateNode(goal);
+		connectToCluster(goalNode);
+	}
+
+	// Reset the search state
+	for (size_t i = 0; i < mSearchTouched.size(); i++)
+	{
+		int node = mSearchTouched[i];
+		if (node < static_cast<int>(mSearchCost.size()))
+		{
+			mSearchCost[node] = INT_MAX;
+			mSearchParent[node] = -1;
+			mSearchClosed[node] = false;
+		}
+	}
+	mSearchTouched.clear();
+	mSearchOpen.clear();
+	mSearchCost.resize(mNodes.size(), INT_MAX);
+	mSearchParent.resize(mNodes.size(), -1);
+	mSearchClosed.resize(mNodes.size(), false);
+
+	mSearchCost[startNode] = 0;
+	mSearchTouched.push_back(startNode);
+	mSearchOpen.push_back(OpenEntry(getPathHeuristic(start, goal), startNode));
+
+	bool found = false;
+	while (!mSearchOpen.empty())
+	{
+		std::pop_heap(mSearchOpen.begin(), mSearchOpen.end());
+		int node = mSearchOpen.back().node;
+		mSearchOpen.pop_back();
+
+		if (mSearchClosed[node])
+		{
+			continue;
+		}
+		mSearchClosed[node] = true;
+
+		if (node == goalNode)
+		{
+			found = true;
+			break;
+		}
+
+		const std::vector<AbstractEdge>& edges = mNodes[node].edges;
+		for (size_t i = 0; i < edges.size(); i++)
+		{
+			int target = edges[i].target;
+			int cost = mSearchCost[node] + edges[i].cost;
+			if (!mSearchClosed[target] && cost < mSearchCost[target])
+			{
+				if (mSearchCost[target] == INT_MAX)
+				{
+					mSearchTouched.push_back(target);
+				}
+				mSearchCost[target] = cost;
+				mSearchParent[target] = node;
+				mSearchOpen.push_back(OpenEntry(cost + getPathHeuristic(mNodes[target].cell, goal), target));
+				std::push_heap(mSearchOpen.begin(), mSearchOpen.end());
+			}
+		}
+	}
+
+	if (found)
+	{
+		mReversePath.clear();
+		for (int node = goalNode; node != startNode; node = mSearchParent[node])
+		{
+			mReversePath.push_back(node);
+		}
+		for (int i = static_cast<int>(mReversePath.size()) - 1; i >= 0; i--)
+		{
+			waypoints.add(mNodes[mReversePath[i]].cell);
+		}
+	}
+
+	// Remove the temporary nodes again
+	if (goalIsTemporary)
+	{
+		removeNode(goalNode);
+	}
+	if (startIsTemporary)
+	{
+		removeNode(startNode);
+	}
+
+	return found;
+}
+
+bool HierarchicalPathfinder::refineLeg(const MapCoordinate& from, const MapCoordinate& to, VectorList<MapCoordinate>& path)
+{
+	path.clear();
+	if (from == to)
+	{
+		return true;
+	}
+
+	PathBounds fromBounds = getClusterBounds(getClusterIndex(from));
+	PathBounds toBounds = getClusterBounds(getClusterIndex(to));
+	PathBounds bounds((std::min)(fromBounds.minX, toBounds.minX), (std::min)(fromBounds.minY, toBounds.minY),
+		(std::max)(fromBounds.maxX, toBounds.maxX), (std::max)(fromBounds.maxY, toBounds.maxY));
+
+	return mGridSearch.findPath(from, to, bounds, &path) != PATH_NOT_FOUND;
+}
+
+bool HierarchicalPathfinder::findPath(const MapCoordinate& start, const MapCoordinate& goal, VectorList<MapCoordinate>& waypoints, VectorList<MapCoordinate>& firstLeg)
+{
+	firstLeg.clear();
+	if (!findAbstractPath(start, goal, waypoints))
+	{
+		return false;
+	}
+	return refineLeg(start, waypoints[0], firstLeg);
+}
+
+int HierarchicalPathfinder::getNodeCount() const
+{
+	return static_cast<int>(mNodes.size() - mFreeNodes.size());
+}
+
+PathBounds HierarchicalPathfinder::getClusterBounds(int cluster) const
+{
+	int minX = (cluster % mcClustersX) * mClusterSize;
+	int minY = (cluster / mcClustersX) * mClusterSize;
+	return PathBounds(minX, minY,
+		(std::min)(minX + mClusterSize, mCostMap.getWidth()) - 1,
+		(std::min)(minY + mClusterSize, mCostMap.getHeight()) - 1);
+}
+
+int HierarchicalPathfinder::findNode(const MapCoordinate& cell) const
+{
+	const std::vector<int>& clusterNodes = mClusterNodes[getClusterIndex(cell)];
+	for (size_t i = 0; i < clusterNodes.size(); i++)
+	{
+		if (mNodes[clusterNodes[i]].cell == cell)
+		{
+			return clusterNodes[i];
+		}
+	}
+	return -1;
+}
+
+int HierarchicalPathfinder::getOrCreateNode(const MapCoordinate& cell)
+{
+	int node = findNode(cell);
+	if (node != -1)
+	{
+		return node;
+	}
+
+	if (!mFreeNodes.empty())
+	{
+		node = mFreeNodes.back();
+		mFreeNodes.pop_back();
+	}
+	else
+	{
+		node = static_cast<int>(mNodes.size());
+		mNodes.push_back(AbstractNode());
+	}
+
+	AbstractNode& newNode = mNodes[node];
+	newNode.cell = cell;
+	newNode.cluster = getClusterIndex(cell);
+	newNode.used = true;
+	newNode.edges.clear();
+	mClusterNodes[newNode.cluster].push_back(node);
+
+	return node;
+}
+
+void HierarchicalPathfinder::removeNode(int node)
+{
+	AbstractNode& removedNode = mNodes[node];
+	for (size_t i = 0; i < removedNode.edges.size(); i++)
+	{
+		removeEdges(removedNode.edges[i].target, node);
+	}
+	removedNode.edges.clear();
+	removedNode.used = false;
+
+	std::vector<int>& clusterNodes = mClusterNodes[removedNode.cluster];
+	std::vector<int>::iterator it = std::find(clusterNodes.begin(), clusterNodes.end(), node);
+	if (it != clusterNodes.end())
+	{
+		*it = clusterNodes.back();
+		clusterNodes.pop_back();
+	}
+
+	mFreeNodes.push_back(node);
+}
+
+void HierarchicalPathfinder::removeEdges(int from, int to)
+{
+	std::vector<AbstractEdge>& edges = mNodes[from].edges;
+	for (size_t i = 0; i < edges.size();)
+	{
+		if (edges[i].target == to)
+		{
+			edges[i] = edges.back();
+			edges.pop_back();
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+void HierarchicalPathfinder::buildBorder(int clusterA, int clusterB)
+{
+	PathBounds boundsA = getClusterBounds(clusterA);
+	PathBounds boundsB = getClusterBounds(clusterB);
+
+	// Vertical border when B is to the right of A, else horizontal
+	bool vertical = clusterB == clusterA + 1;
+	int length = vertical ? boundsA.maxY - boundsA.minY + 1 : boundsA.maxX - boundsA.minX + 1;
+
+	int runStart = -1;
+	for (int i = 0; i <= length; i++)
+	{
+		MapCoordinate cellA = vertical ? MapCoordinate(boundsA.maxX, boundsA.minY + i) : MapCoordinate(boundsA.minX + i, boundsA.maxY);
+		MapCoordinate cellB = vertical ? MapCoordinate(boundsB.minX, boundsA.minY + i) : MapCoordinate(boundsA.minX + i, boundsB.minY);
+
+		bool open = i < length &&
+			mCostMap.get(cellA.x, cellA.y) != PATH_COST_BLOCKED &&
+			mCostMap.get(cellB.x, cellB.y) != PATH_COST_BLOCKED;
+
+		if (open && runStart == -1)
+		{
+			runStart = i;
+		}
+		else if (!open && runStart != -1)
+		{
+			// The entrance ended, add one transition in the middle or one at each end
+			int runEnd = i - 1;
+			MapCoordinate offset = vertical ? MapCoordinate(0, 1) : MapCoordinate(1, 0);
+			MapCoordinate startA = vertical ? MapCoordinate(boundsA.maxX, boundsA.minY + runStart) : MapCoordinate(boundsA.minX + runStart, boundsA.maxY);
+			MapCoordinate startB = vertical ? MapCoordinate(boundsB.minX, boundsA.minY + runStart) : MapCoordinate(boundsA.minX + runStart, boundsB.minY);
+
+			int runLength = runEnd - runStart + 1;
+			if (runLength >= ENTRANCE_SPLIT_LENGTH)
+			{
+				MapCoordinate endOffset(offset.x * (runLength - 1), offset.y * (runLength - 1));
+				addTransition(startA, startB);
+				addTransition(startA + endOffset, startB + endOffset);
+			}
+			else
+			{
+				MapCoordinate middleOffset(offset.x * (runLength / 2), offset.y * (runLength / 2));
+				addTransition(startA + middleOffset, startB + middleOffset);
+			}
+
+			runStart = -1;
+		}
+	}
+}
+
+void HierarchicalPathfinder::addTransition(const MapCoordinate& cellA, const MapCoordinate& cellB)
+{
+	int nodeA = getOrCreateNode(cellA);
+	int nodeB = getOrCreateNode(cellB);
+	int cost = getPathStepCost(mCostMap, cellA, cellB, false);
+
+	mNodes[nodeA].edges.push_back(AbstractEdge(nodeB, cost, false));
+	mNodes[nodeB].edges.push_back(AbstractEdge(nodeA, cost, false));
+}
+
+void HierarchicalPathfinder::buildIntraEdges(int cluster)
+{
+	const std::vector<int>& clusterNodes = mClusterNodes[cluster];
+
+	// Remove the old intra-edges
+	for (size_t i = 0; i < clusterNodes.size(); i++)
+	{
+		std::vector<AbstractEdge>& edges = mNodes[clusterNodes[i]].edges;
+		for (size_t edge = 0; edge < edges.size();)
+		{
+			if (edges[edge].intra)
+			{
+				edges[edge] = edges.back();
+				edges.pop_back();
+			}
+			else
+			{
+				edge++;
+			}
+		}
+	}
+
+	// The step cost is symmetric so one search per pair is enough
+	PathBounds bounds = getClusterBounds(cluster);
+	for (size_t i = 0; i < clusterNodes.size(); i++)
+	{
+		for (size_t j = i + 1; j < clusterNodes.size(); j++)
+		{
+			int nodeA = clusterNodes[i];
+			int nodeB = clusterNodes[j];
+			int cost = mGridSearch.findPath(mNodes[nodeA].cell, mNodes[nodeB].cell, bounds, NULL);
+			if (cost != PATH_NOT_FOUND)
+			{
+				mNodes[nodeA].edges.push_back(AbstractEdge(nodeB, cost, true));
+				mNodes[nodeB].edges.push_back(AbstractEdge(nodeA, cost, true));
+			}
+		}
+	}
+}
+
+void HierarchicalPathfinder::connectToCluster(int node)
+{
+	int cluster = mNodes[node].cluster;
+	PathBounds bounds = getClusterBounds(cluster);
+	const std::vector<int>& clusterNodes = mClusterNodes[cluster];
+
+	for (size_t i = 0; i < clusterNodes.size(); i++)
+	{
+		int other = clusterNodes[i];
+		if (other == node)
+		{
+			continue;
+		}
+
+		int cost = mGridSearch.findPath(mNodes[node].cell, mNodes[other].cell, bounds, NULL);
+		if (cost != PATH_NOT_FOUND)
+		{
+			mNodes[node].edges.push_back(AbstractEdge(other, cost, true));
+			mNodes[other].edges.push_back(AbstractEdge(node, cost, true));
+		}
+	}
+}
+
+void HierarchicalPathfinder::getNeighbourClusters(int cluster, int neighbours[4]) const
+{
+	int clusterX = cluster % mcClustersX;
+	int clusterY = cluster / mcClustersX;
+
+	neighbours[0] = clusterX > 0 ? cluster - 1 : -1;
+	neighbours[1] = clusterX + 1 < mcClustersX ? cluster + 1 : -1;
+	neighbours[2] = clusterY > 0 ? cluster - mcClustersX : -1;
+	neighbours[3] = clusterY + 1 < mcClustersY ? cluster + mcClustersX : -1;
+}
\ No newline at end of file
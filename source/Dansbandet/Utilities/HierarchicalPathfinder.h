@@ -0,0 +1,265 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Hierarchical pathfinding (HPA*). The map is divided into square clusters and
+* an abstract graph is built from the entrances between neighbouring clusters.
+* A search first finds a path in the abstract graph and then only the leg the
+* agent is about to walk is refined into map coordinates.
+*/
+
+#ifndef __HIERARCHICAL_PATHFINDER_H__
+#define __HIERARCHICAL_PATHFINDER_H__
+
+#include "PathCostMap.h"
+#include "GridAStar.h"
+#include "VectorList.h"
+#include <vector>
+
+namespace utilities
+{
+
+/**
+* HPA* pathfinder. Typical usage:
+* @code
+* pathfinder.findPath(start, goal, waypoints, leg);
+* // walk along leg, when waypoints[i] is reached:
+* pathfinder.refineLeg(waypoints[i], waypoints[i+1], leg);
+* @endcode
+* When the map changes, e.g. a wall is destroyed, call onCellChanged() and
+* only the abstract graph around that cell is updated.
+*/
+class HierarchicalPathfinder
+{
+public:
+	/** The default width and height of a cluster in map coordinates */
+	static const int CLUSTER_SIZE_DEFAULT = 16;
+
+	/**
+	* Constructor, builds the abstract graph
+	* @param costMap the map to search in, needs to outlive the pathfinder
+	* @param clusterSize width and height of the clusters in map coordinates
+	*/
+	HierarchicalPathfinder(const PathCostMap& costMap, int clusterSize = CLUSTER_SIZE_DEFAULT);
+
+	/**
+	* Destructor
+	*/
+	~HierarchicalPathfinder();
+
+	/**
+	* Rebuilds the whole abstract graph. Only necessary if large parts of the map changed.
+	*/
+	void rebuild();
+
+	/**
+	* Updates the abstract graph after the cost of a map coordinate has changed,
+	* e.g. when a wall is destroyed. Only the cluster of the coordinate and the
+	* borders to its neighbours are recalculated.
+	* @param cell the map coordinate that changed
+	*/
+	void onCellChanged(const MapCoordinate& cell);
+
+	/**
+	* Finds a path in the abstract graph. The waypoints are entrances between
+	* clusters, two consecutive waypoints are always in the same or neighbouring
+	* clusters and can thus be refined cheaply with refineLeg().
+	* @param start the coordinate to start from
+	* @param goal the coordinate we want to reach
+	* @param waypoints cleared and filled with the waypoints, excluding start and
+	* with the goal as last waypoint
+	* @return true if a path was found
+	* @throws VectorList::FullException if the waypoints don't fit
+	*/
+	bool findAbstractPath(const MapCoordinate& start, const MapCoordinate& goal, VectorList<MapCoordinate>& waypoints);
+
+	/**
+	* Refines a leg between two consecutive waypoints into map coordinates.
+	* @param from the coordinate to start from
+	* @param to the waypoint to reach, needs to be in the same or a neighbouring cluster
+	* @param path cleared and filled with the path, excluding from and including to
+	* @return true if a path was found
+	* @throws VectorList::FullException if the path doesn't fit
+	*/
+	bool refineLeg(const MapCoordinate& from, const MapCoordinate& to, VectorList<MapCoordinate>& path);
+
+	/**
+	* Finds the abstract path and refines the first leg.
+	* @param start the coordinate to start from
+	* @param goal the coordinate we want to reach
+	* @param waypoints cleared and filled with the waypoints, see findAbstractPath()
+	* @param firstLeg cleared and filled with the path from start to the first waypoint
+	* @return true if a path was found
+	* @throws VectorList::FullException if the waypoints or the first leg don't fit
+	*/
+	bool findPath(const MapCoordinate& start, const MapCoordinate& goal, VectorList<MapCoordinate>& waypoints, VectorList<MapCoordinate>& firstLeg);
+
+	/**
+	* Returns the number of nodes in the abstract graph
+	* @return number of entrance nodes
+	*/
+	int getNodeCount() const;
+
+	/**
+	* Returns the cluster a coordinate belongs to
+	* @param cell the map coordinate
+	* @return index of the cluster
+	*/
+	inline int getClusterIndex(const MapCoordinate& cell) const
+	{
+		return (cell.y / mClusterSize) * mcClustersX + cell.x / mClusterSize;
+	}
+
+private:
+	/** Entrances longer than this get two transitions, one at each end */
+	static const int ENTRANCE_SPLIT_LENGTH = 6;
+
+	/**
+	* An edge in the abstract graph
+	*/
+	struct AbstractEdge
+	{
+		int target;	/**< Index of the node the edge goes to */
+		int cost;	/**< Cost of the cheapest path between the nodes */
+		bool intra;	/**< True if the edge is inside a cluster, false if it crosses a border */
+
+		AbstractEdge(int target, int cost, bool intra) : target(target), cost(cost), intra(intra) {}
+	};
+
+	/**
+	* A node in the abstract graph, i.e. a coordinate on a cluster border
+	*/
+	struct AbstractNode
+	{
+		MapCoordinate cell;
+		int cluster;
+		bool used;	/**< False if the node is in the free list */
+		std::vector<AbstractEdge> edges;
+	};
+
+	/**
+	* An entry in the open list of the abstract search
+	*/
+	struct OpenEntry
+	{
+		int estimatedCost;
+		int node;
+
+		OpenEntry(int estimatedCost, int node) : estimatedCost(estimatedCost), node(node) {}
+
+		bool operator<(const OpenEntry& entry) const
+		{
+			return estimatedCost > entry.estimatedCost;
+		}
+	};
+
+	/**
+	* Returns the bounds of a cluster
+	* @param cluster index of the cluster
+	* @return bounds of the cluster
+	*/
+	PathBounds getClusterBounds(int cluster) const;
+
+	/**
+	* Finds the node at the specified coordinate
+	* @param cell the coordinate
+	* @return index of the node, -1 if there is no node there
+	*/
+	int findNode(const MapCoordinate& cell) const;
+
+	/**
+	* Returns the node at the coordinate, creates it if it doesn't exist
+	* @param cell the coordinate
+	* @return index of the node
+	*/
+	int getOrCreateNode(const MapCoordinate& cell);
+
+	/**
+	* Removes a node and all edges to and from it
+	* @param node index of the node
+	*/
+	void removeNode(int node);
+
+	/**
+	* Removes all edges from one node to another
+	* @param from the node to remove the edges from
+	* @param to the target of the edges to remove
+	*/
+	void removeEdges(int from, int to);
+
+	/**
+	* Detects the entrances on the border between two neighbouring clusters and
+	* connects them with inter-edges.
+	* @param clusterA the cluster to the left or above
+	* @param clusterB the cluster to the right or below
+	*/
+	void buildBorder(int clusterA, int clusterB);
+
+	/**
+	* Adds a transition between two cells on each side of a border
+	* @param cellA cell in the first cluster
+	* @param cellB cell in the second cluster
+	*/
+	void addTransition(const MapCoordinate& cellA, const MapCoordinate& cellB);
+
+	/**
+	* Calculates the intra-edges between all nodes in a cluster
+	* @param cluster index of the cluster
+	*/
+	void buildIntraEdges(int cluster);
+
+	/**
+	* Connects a temporary node to all nodes in its cluster
+	* @param node index of the temporary node
+	*/
+	void connectToCluster(int node);
+
+	/**
+	* Returns the neighbour clusters of a cluster
+	* @param cluster index of the cluster
+	* @param neighbours array of 4 that is filled with neighbour indices, -1 if none
+	*/
+	void getNeighbourClusters(int cluster, int neighbours[4]) const;
+
+	const PathCostMap&	mCostMap;
+	GridAStar			mGridSearch;	/**< Used for intra-edges and refinement */
+	int					mClusterSize;
+	int					mcClustersX;
+	int					mcClustersY;
+
+	std::vector<AbstractNode>		mNodes;
+	std::vector<int>				mFreeNodes;		/**< Indices of unused nodes in mNodes */
+	std::vector<std::vector<int> >	mClusterNodes;	/**< Node indices in each cluster */
+
+	// Abstract search state
+	std::vector<int>		mSearchCost;
+	std::vector<int>		mSearchParent;
+	std::vector<bool>		mSearchClosed;
+	std::vector<int>		mSearchTouched;
+	std::vector<OpenEntry>	mSearchOpen;
+	std::vector<int>		mReversePath;
+
+	// Not copyable
+	HierarchicalPathfinder(const HierarchicalPathfinder&);
+	HierarchicalPathfinder& operator=(const HierarchicalPathfinder&);
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,272 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* A 4-ary min-heap of integer items with an index map for decrease-key.
+*/
+
+#ifndef __INDEXED_PRIORITY_QUEUE_H__
+#define __INDEXED_PRIORITY_QUEUE_H__
+
+#include "Macros.h"
+#include "Exception.h"
+#include <vector>
+
+namespace utilities
+{
+
+/**
+* A 4-ary min-heap of items in the range [0, capacity) where each item is
+* ordered by an integer priority. Every item knows its position in the heap,
+* so an item's priority can be decreased without a duplicate entry. The heap
+* is meant to be reused between searches, clear() only touches the items that
+* are left in the heap.
+*/
+class IndexedPriorityQueue
+{
+public:
+	/**
+	* Thrown when trying to access the top of an empty queue.
+	*/
+	class EmptyException : public Exception
+	{
+	public:
+		EmptyException() : Exception("IndexedPriorityQueueEmptyException: Can't operate on an empty queue!", 70008) {}
+	};
+
+	/**
+	* Constructor
+	* @param capacity the items need to be less than the capacity
+	*/
+	IndexedPriorityQueue(int capacity = 0)
+	{
+		reserve(capacity);
+	}
+
+	/**
+	* Makes room for items in the range [0, capacity)
+	* @param capacity the items need to be less than the capacity
+	*/
+	void reserve(int capacity)
+	{
+		if (capacity > static_cast<int>(mPosition.size()))
+		{
+			mPosition.resize(capacity, NOT_IN_HEAP);
+			mHeap.reserve(capacity);
+		}
+	}
+
+	/**
+	* Removes all items from the queue
+	*/
+	void clear()
+	{
+		for (size_t i = 0; i < mHeap.size(); i++)
+		{
+			mPosition[mHeap[i].item] = NOT_IN_HEAP;
+		}
+		mHeap.clear();
+	}
+
+	/**
+	* Checks if the queue is empty
+	* @return true if empty
+	*/
+	inline bool empty() const
+	{
+		return mHeap.empty();
+	}
+
+	/**
+	* Returns the number of items in the queue
+	* @return number of items in the queue
+	*/
+	inline int size() const
+	{
+		return static_cast<int>(mHeap.size());
+	}
+
+	/**
+	* Checks if an item is in the queue
+	* @param item the item
+	* @return true if the item is in the queue
+	*/
+	inline bool contains(int item) const
+	{
+		return mPosition[item] != NOT_IN_HEAP;
+	}
+
+	/**
+	* Adds an item or decreases its priority if it's already in the queue and the
+	* new priority is lower.
+	* @param item the item, needs to be less than the capacity
+	* @param priority the priority, lowest priority is popped first
+	*/
+	inline void push(int item, int priority)
+	{
+		int position = mPosition[item];
+		if (position == NOT_IN_HEAP)
+		{
+			position = static_cast<int>(mHeap.size());
+			mHeap.push_back(Entry(priority, item));
+			mPosition[item] = position;
+			siftUp(position);
+		}
+		else if (priority < mHeap[position].priority)
+		{
+			mHeap[position].priority = priority;
+			siftUp(position);
+		}
+	}
+
+	/**
+	* Returns the item with the lowest priority
+	* @return item with the lowest priority
+	* @throws EmptyException if the queue is empty
+	*/
+	inline int top() const
+	{
+		if (mHeap.empty())
+		{
+			throw EmptyException();
+		}
+		return mHeap[0].item;
+	}
+
+	/**
+	* Returns the lowest priority in the queue
+	* @return the lowest priority
+	* @throws EmptyException if the queue is empty
+	*/
+	inline int topPriority() const
+	{
+		if (mHeap.empty())
+		{
+			throw EmptyException();
+		}
+		return mHeap[0].priority;
+	}
+
+	/**
+	* Removes and returns the item with the lowest priority
+	* @return item with the lowest priority
+	* @throws EmptyException if the queue is empty
+	*/
+	inline int pop()
+	{
+		if (mHeap.empty())
+		{
+			throw EmptyException();
+		}
+
+		int item = mHeap[0].item;
+		mPosition[item] = NOT_IN_HEAP;
+
+		Entry last = mHeap.back();
+		mHeap.pop_back();
+		if (!mHeap.empty())
+		{
+			mHeap[0] = last;
+			mPosition[last.item] = 0;
+			siftDown(0);
+		}
+
+		return item;
+	}
+
+private:
+	static const int NOT_IN_HEAP = -1;
+	static const int ARITY = 4;
+
+	struct Entry
+	{
+		int priority;
+		int item;
+
+		Entry(int priority, int item) : priority(priority), item(item) {}
+	};
+
+	/**
+	* Moves an entry up until its parent has a lower or equal priority
+	* @param position the position of the entry in the heap
+	*/
+	void siftUp(int position)
+	{
+		Entry entry = mHeap[position];
+		while (position > 0)
+		{
+			int parent = (position - 1) / ARITY;
+			if (mHeap[parent].priority <= entry.priority)
+			{
+				break;
+			}
+			mHeap[position] = mHeap[parent];
+			mPosition[mHeap[position].item] = position;
+			position = parent;
+		}
+		mHeap[position] = entry;
+		mPosition[entry.item] = position;
+	}
+
+	/**
+	* Moves an entry down until all its children have a higher or equal priority
+	* @param position the position of the entry in the heap
+	*/
+	void siftDown(int position)
+	{
+		Entry entry = mHeap[position];
+		int cEntries = static_cast<int>(mHeap.size());
+		for (;;)
+		{
+			int firstChild = position * ARITY + 1;
+			if (firstChild >= cEntries)
+			{
+				break;
+			}
+
+			// Find the child with the lowest priority
+			int lastChild = firstChild + ARITY < cEntries ? firstChild + ARITY : cEntries;
+			int bestChild = firstChild;
+			for (int child = firstChild + 1; child < lastChild; child++)
+			{
+				if (mHeap[child].priority < mHeap[bestChild].priority)
+				{
+					bestChild = child;
+				}
+			}
+
+			if (entry.priority <= mHeap[bestChild].priority)
+			{
+				break;
+			}
+			mHeap[position] = mHeap[bestChild];
+			mPosition[mHeap[position].item] = position;
+			position = bestChild;
+		}
+		mHeap[position] = entry;
+		mPosition[entry.item] = position;
+	}
+
+	std::vector<Entry>	mHeap;		/**< The 4-ary heap */
+	std::vector<int>	mPosition;	/**< Position of each item in mHeap, NOT_IN_HEAP if not in the queue */
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,411 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Work-stealing job system. One worker thread per core runs short jobs from
+* Chase-Lev deques and steals from the other workers when its own deque is empty.
+*/
+
+#include "JobSystem.h"
+#include "Macros.h"
+#include <windows.h>
+#include <emmintrin.h>
+#include <intrin.h>
+
+using namespace utilities;
+
+namespace
+{
+/** Number of times an idle thread spins before it starts to yield */
+const int IDLE_SPIN_COUNT = 64;
+
+/** Number of times an idle thread yields before it parks or blocks */
+const int IDLE_YIELD_COUNT = 256;
+
+/**
+* Returns the number of steps from one deque index to another. The indices
+* only ever grow and wrap around after 2^32 pushes, the distance between them
+* is always small so it is computed with unsigned arithmetic that wraps the
+* same way
+* @param from the index to start at
+* @param to the index to end at
+* @return the number of steps from from to to, negative when to lies before
+*/
+inline long getDistance(long from, long to)
+{
+	return static_cast<long>(static_cast<unsigned long>(to) - static_cast<unsigned long>(from));
+}
+
+/**
+* Returns the index following a deque index, wrapping around instead of
+* overflowing
+* @param index the index to advance
+* @return the next index
+*/
+inline long getNext(long index)
+{
+	return static_cast<long>(static_cast<unsigned long>(index) + 1);
+}
+}
+
+JobSystem::Deque::Deque() : mJobs(DEQUE_SIZE)
+{
+	mTop = 0;
+	mBottom = 0;
+}
+
+bool JobSystem::Deque::push(const QueuedJob& job)
+{
+	long bottom = mBottom;
+	if (getDistance(mTop, bottom) >= DEQUE_SIZE)
+	{
+		return false;
+	}
+
+	mJobs[bottom & (DEQUE_SIZE - 1)] = job;
+
+	// The job has to be written before a thief can see the new bottom
+	_ReadWriteBarrier();
+	mBottom = getNext(bottom);
+	return true;
+}
+
+bool JobSystem::Deque::pop(QueuedJob& job)
+{
+	// The new bottom has to be visible to the thieves before we read top, an
+	// interlocked operation is a full memory barrier
+	long bottom = mBottom;
+	long last = static_cast<long>(static_cast<unsigned long>(bottom) - 1);
+	InterlockedExchange(&mBottom, last);
+	long top = mTop;
+
+	long cRemaining = getDistance(top, last);
+	if (cRemaining < 0)
+	{
+		mBottom = bottom;
+		return false;
+	}
+
+	job = mJobs[last & (DEQUE_SIZE - 1)];
+	if (cRemaining == 0)
+	{
+		// The last job, race the thieves for it
+		bool won = InterlockedCompareExchange(&mTop, getNext(top), top) == top;
+		mBottom = bottom;
+		return won;
+	}
+	return true;
+}
+
+bool JobSystem::Deque::steal(QueuedJob& job)
+{
+	long top = mTop;
+	_ReadWriteBarrier();
+	long bottom = mBottom;
+	if (getDistance(top, bottom) <= 0)
+	{
+		return false;
+	}
+
+	// The owner can't overwrite the job until top has moved since the deque
+	// is never pushed beyond DEQUE_SIZE jobs
+	job = mJobs[top & (DEQUE_SIZE - 1)];
+	_ReadWriteBarrier();
+	return InterlockedCompareExchange(&mTop, getNext(top), top) == top;
+}
+
+JobSystem::JobSystem(int cWorkers)
+{
+	if (cWorkers <= 0)
+	{
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		cWorkers = static_cast<int>(systemInfo.dwNumberOfProcessors) - 1;
+	}
+	if (cWorkers > THREAD_COUNT_MAX - 1)
+	{
+		cWorkers = THREAD_COUNT_MAX - 1;
+	}
+
+	mQuit = false;
+	mcParked = 0;
+	pthread_key_create(&mThreadIndexKey, NULL);
+	pthread_setspecific(mThreadIndexKey, reinterpret_cast<void*>(1));
+
+	mDeques.resize(cWorkers + 1);
+	mDoneEvents.resize(cWorkers + 1);
+	for (size_t i = 0; i < mDeques.size(); i++)
+	{
+		mDeques[i] = myNew Deque;
+		mDoneEvents[i] = myNew AutoResetEvent;
+	}
+
+	// All data is allocated before the first worker starts
+	mWorkers.resize(cWorkers);
+	mWorkerData.resize(cWorkers);
+	for (int i = 0; i < cWorkers; i++)
+	{
+		mWorkerData[i].pJobSystem = this;
+		mWorkerData[i].index = i + 1;
+	}
+	for (int i = 0; i < cWorkers; i++)
+	{
+		pthread_create(&mWorkers[i], NULL, runWorker, &mWorkerData[i]);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	mQuit = true;
+	mWakeSemaphore.post(static_cast<int>(mWorkers.size()));
+	for (size_t i = 0; i < mWorkers.size(); i++)
+	{
+		pthread_join(mWorkers[i], NULL);
+	}
+
+	for (size_t i = 0; i < mDeques.size(); i++)
+	{
+		SAFE_DELETE(mDeques[i]);
+		SAFE_DELETE(mDoneEvents[i]);
+	}
+	pthread_key_delete(mThreadIndexKey);
+}
+
+void JobSystem::run(const Job& job, JobCounter* pCounter)
+{
+	run(&job, 1, pCounter);
+}
+
+void JobSystem::run(const Job* pJobs, int cJobs, JobCounter* pCounter)
+{
+	if (pCounter != NULL)
+	{
+		InterlockedExchangeAdd(&pCounter->mcJobs, cJobs);
+	}
+
+	int threadIndex = getThreadIndex();
+	int cPushed = 0;
+	for (int i = 0; i < cJobs; i++)
+	{
+		QueuedJob queuedJob;
+		queuedJob.job = pJobs[i];
+		queuedJob.pCounter = pCounter;
+
+		// Run it at once if the deque is full or the thread isn't ours
+		if (threadIndex >= 0 && mDeques[threadIndex]->push(queuedJob))
+		{
+			cPushed++;
+		}
+		else
+		{
+			execute(queuedJob);
+		}
+	}
+
+	if (cPushed > 0)
+	{
+		wakeWorkers(cPushed);
+	}
+}
+
+void JobSystem::wait(const JobCounter* pCounter)
+{
+	int threadIndex = getThreadIndex();
+	unsigned int random = static_cast<unsigned int>(threadIndex) * 0x9e3779b9u + 1;
+	int cIdle = 0;
+	while (!pCounter->isDone())
+	{
+		QueuedJob job;
+		if (threadIndex >= 0 && findJob(threadIndex, job, random))
+		{
+			execute(job);
+			cIdle = 0;
+		}
+		else if (threadIndex < 0 || cIdle < IDLE_SPIN_COUNT + IDLE_YIELD_COUNT)
+		{
+			idle(cIdle++);
+		}
+		else
+		{
+			// The remaining jobs are running on other threads, sleeping a
+			// fixed time would overshoot the frame so block until the last
+			// one wakes us
+			block(threadIndex, pCounter);
+			cIdle = IDLE_SPIN_COUNT;
+		}
+	}
+}
+
+int JobSystem::getThreadIndex() const
+{
+	return static_cast<int>(reinterpret_cast<size_t>(pthread_getspecific(mThreadIndexKey))) - 1;
+}
+
+void* JobSystem::runWorker(void* pData)
+{
+	WorkerData* pWorkerData = static_cast<WorkerData*>(pData);
+	JobSystem* pJobSystem = pWorkerData->pJobSystem;
+	int threadIndex = pWorkerData->index;
+	pthread_setspecific(pJobSystem->mThreadIndexKey, reinterpret_cast<void*>(static_cast<size_t>(threadIndex + 1)));
+
+	unsigned int random = static_cast<unsigned int>(threadIndex) * 0x9e3779b9u + 1;
+	int cIdle = 0;
+	while (!pJobSystem->mQuit)
+	{
+		QueuedJob job;
+		if (pJobSystem->findJob(threadIndex, job, random))
+		{
+			pJobSystem->execute(job);
+			cIdle = 0;
+		}
+		else if (cIdle < IDLE_SPIN_COUNT + IDLE_YIELD_COUNT)
+		{
+			idle(cIdle++);
+		}
+		else
+		{
+			pJobSystem->park(threadIndex, random);
+			cIdle = 0;
+		}
+	}
+	return NULL;
+}
+
+bool JobSystem::findJob(int threadIndex, QueuedJob& job, unsigned int& random)
+{
+	if (mDeques[threadIndex]->pop(job))
+	{
+		return true;
+	}
+
+	// Steal from the others, starting at a random thread so the thieves
+	// spread out
+	int cThreads = static_cast<int>(mDeques.size());
+	random ^= random << 13;
+	random ^= random >> 17;
+	random ^= random << 5;
+	int first = static_cast<int>(random % static_cast<unsigned int>(cThreads));
+	for (int i = 0; i < cThreads; i++)
+	{
+		int victim = (first + i) % cThreads;
+		if (victim != threadIndex && mDeques[victim]->steal(job))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::execute(const QueuedJob& job)
+{
+	job.job.function(job.job.pData);
+
+	// The decrement is a full memory barrier so everything the job wrote is
+	// visible when the counter is done. The counter may be gone as soon as
+	// it is done, the blocked thread is taken from the decremented value.
+	if (job.pCounter != NULL)
+	{
+		long jobs = InterlockedDecrement(&job.pCounter->mcJobs);
+		if ((jobs & JobCounter::COUNT_MASK) == 0 && jobs != 0)
+		{
+			mDoneEvents[(jobs >> JobCounter::WAITER_SHIFT) - 1]->set();
+		}
+	}
+}
+
+void JobSystem::idle(int cIdle)
+{
+	if (cIdle < IDLE_SPIN_COUNT)
+	{
+		_mm_pause();
+	}
+	else
+	{
+		SwitchToThread();
+	}
+}
+
+void JobSystem::block(int threadIndex, const JobCounter* pCounter)
+{
+	// Register as the waiter unless the counter is done or has one already,
+	// the job that brings the count to zero then sees us
+	long waiter = static_cast<long>(threadIndex + 1) << JobCounter::WAITER_SHIFT;
+	long jobs = pCounter->mcJobs;
+	for (;;)
+	{
+		if ((jobs & JobCounter::COUNT_MASK) == 0 || (jobs & ~JobCounter::COUNT_MASK) != 0)
+		{
+			return;
+		}
+		long previous = InterlockedCompareExchange(&pCounter->mcJobs, jobs | waiter, jobs);
+		if (previous == jobs)
+		{
+			break;
+		}
+		jobs = previous;
+	}
+
+	mDoneEvents[threadIndex]->wait();
+
+	// Unregister so the counter can be used again, no job decreases it now
+	jobs = pCounter->mcJobs;
+	for (;;)
+	{
+		long previous = InterlockedCompareExchange(&pCounter->mcJobs, jobs & JobCounter::COUNT_MASK, jobs);
+		if (previous == jobs)
+		{
+			break;
+		}
+		jobs = previous;
+	}
+}
+
+void JobSystem::park(int threadIndex, unsigned int& random)
+{
+	// Announce that we park before the last look for jobs, the interlocked
+	// increment is a full barrier so either we see a job that was pushed or
+	// the pusher sees us and posts the semaphore
+	InterlockedIncrement(&mcParked);
+	QueuedJob job;
+	bool found = findJob(threadIndex, job, random);
+	if (!found && !mQuit)
+	{
+		mWakeSemaphore.wait();
+	}
+	InterlockedDecrement(&mcParked);
+
+	if (found)
+	{
+		execute(job);
+	}
+}
+
+void JobSystem::wakeWorkers(int cJobs)
+{
+	// The pushed jobs have to be visible before we read the number of parked
+	// workers, which the interlocked read ensures. A worker that finds a job
+	// before it blocks leaves a post unused, it only makes a later park return
+	// at once.
+	long cParked = InterlockedExchangeAdd(&mcParked, 0);
+	if (cParked > 0)
+	{
+		mWakeSemaphore.post(cJobs < cParked ? cJobs : static_cast<int>(cParked));
+	}
+}
\ No newline at end of file
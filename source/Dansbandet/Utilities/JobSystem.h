@@ -0,0 +1,299 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Work-stealing job system. One worker thread per core runs short jobs from
+* Chase-Lev deques and steals from the other workers when its own deque is empty.
+*/
+
+#ifndef __JOB_SYSTEM_H__
+#define __JOB_SYSTEM_H__
+
+#include "Semaphore.h"
+#include <pthread.h>
+#include <vector>
+
+namespace utilities
+{
+
+/**
+* A job function
+* @param pData the data the job was run with
+*/
+typedef void (*JobFunction)(void* pData);
+
+/**
+* A job, a function and its data
+*/
+struct Job
+{
+	JobFunction function;
+	void* pData;
+
+	Job() : function(NULL), pData(NULL) {}
+	Job(JobFunction function, void* pData) : function(function), pData(pData) {}
+};
+
+/**
+* Counts the jobs that haven't finished. Jobs that depend on other jobs wait
+* for their counter with JobSystem::wait(), which runs other jobs meanwhile.
+* Only one thread at a time may wait for a counter.
+*/
+class JobCounter
+{
+public:
+	/**
+	* Constructor
+	*/
+	JobCounter() : mcJobs(0) {}
+
+	/**
+	* Checks if all jobs have finished
+	* @return true if all jobs that were run with the counter have finished
+	*/
+	inline bool isDone() const
+	{
+		return (mcJobs & COUNT_MASK) == 0;
+	}
+
+	/**
+	* Returns the number of jobs that haven't finished
+	* @return number of unfinished jobs
+	*/
+	inline int getCount() const
+	{
+		return static_cast<int>(mcJobs & COUNT_MASK);
+	}
+
+private:
+	friend class JobSystem;
+
+	/** The bits of mcJobs that hold the number of unfinished jobs */
+	static const long COUNT_MASK = 0x00ffffff;
+	/** The bits above hold the index + 1 of a thread blocked on the counter */
+	static const int WAITER_SHIFT = 24;
+
+	/** Number of unfinished jobs and the blocked thread, packed so the job
+	* that finishes last learns who to wake in the same decrement */
+	mutable volatile long mcJobs;
+
+	// Not copyable
+	JobCounter(const JobCounter&);
+	JobCounter& operator=(const JobCounter&);
+};
+
+/**
+* Runs jobs on one worker thread per core. Typical usage:
+* @code
+* JobCounter counter;
+* for (int i = 0; i < cChunks; i++)
+* {
+*	jobSystem.run(Job(updateBugs, &chunks[i]), &counter);
+* }
+* jobSystem.wait(&counter);
+* @endcode
+* Each thread has its own work-stealing deque. A thread pushes and pops jobs
+* at the bottom of its own deque without locking and idle threads steal from
+* the top of the other deques. A thread that waits for a counter runs jobs
+* until the counter is done, so jobs can wait for other jobs without blocking
+* a worker. When there are no jobs left to help with, the waiting thread
+* blocks on an event that the job finishing the counter sets. Workers that
+* have been idle for a while park on a semaphore and use no CPU until new
+* jobs are run. Jobs can be run from the thread that
+* created the job system and from jobs. Use Thread for long-running services
+* instead, a job that never returns occupies a worker.
+*/
+class JobSystem
+{
+public:
+	/** Number of jobs that fit in each deque, more jobs are run at once */
+	static const int DEQUE_SIZE = 4096;
+
+	/** Maximum number of threads, including the creating thread */
+	static const int THREAD_COUNT_MAX = 127;
+
+	/**
+	* Constructor, starts the worker threads. The thread that creates the job
+	* system helps running jobs when it waits.
+	* @param cWorkers number of worker threads, 0 for one less than the number of cores
+	*/
+	JobSystem(int cWorkers = 0);
+
+	/**
+	* Destructor, stops the worker threads. Wait for all counters before.
+	*/
+	~JobSystem();
+
+	/**
+	* Runs a job on any thread
+	* @param job the job
+	* @param pCounter counter that is increased now and decreased when the job
+	* has finished, may be NULL
+	*/
+	void run(const Job& job, JobCounter* pCounter);
+
+	/**
+	* Runs several jobs on any thread
+	* @param pJobs the jobs
+	* @param cJobs number of jobs
+	* @param pCounter counter that is increased by cJobs now and decreased when
+	* each job has finished, may be NULL
+	*/
+	void run(const Job* pJobs, int cJobs, JobCounter* pCounter);
+
+	/**
+	* Runs jobs until all jobs of the counter have finished, blocks when the
+	* remaining jobs run on other threads
+	* @param pCounter the counter
+	*/
+	void wait(const JobCounter* pCounter);
+
+	/**
+	* Returns the number of threads that run jobs, including the thread that
+	* created the job system
+	* @return number of threads
+	*/
+	inline int getThreadCount() const
+	{
+		return static_cast<int>(mDeques.size());
+	}
+
+	/**
+	* Returns the index of the calling thread
+	* @return 0 for the thread that created the job system, 1 to
+	* getThreadCount() - 1 for the workers, -1 for other threads
+	*/
+	int getThreadIndex() const;
+
+private:
+	/** A job in a deque and the counter to decrease when it has finished */
+	struct QueuedJob
+	{
+		Job job;
+		JobCounter* pCounter;
+	};
+
+	/**
+	* Chase-Lev work-stealing deque with a fixed size. Only the owner pushes and
+	* pops at the bottom, any thread may steal from the top.
+	*/
+	class Deque
+	{
+	public:
+		Deque();
+
+		/**
+		* Pushes a job at the bottom, only the owner
+		* @return false if the deque is full
+		*/
+		bool push(const QueuedJob& job);
+
+		/**
+		* Pops the job at the bottom, only the owner
+		* @return false if the deque is empty
+		*/
+		bool pop(QueuedJob& job);
+
+		/**
+		* Steals the job at the top, any thread
+		* @return false if the deque is empty or another thread took the job
+		*/
+		bool steal(QueuedJob& job);
+
+	private:
+		/** Index of the next job to steal, wraps around */
+		volatile long mTop;
+		/** Index of the next job to push, wraps around */
+		volatile long mBottom;
+		std::vector<QueuedJob> mJobs;
+	};
+
+	/** The data a worker thread is started with */
+	struct WorkerData
+	{
+		JobSystem* pJobSystem;
+		int index;
+	};
+
+	/**
+	* The main function of a worker thread
+	* @param pData the WorkerData of the worker
+	*/
+	static void* runWorker(void* pData);
+
+	/**
+	* Gets a job from the deque of a thread or steals one from another thread
+	* @param threadIndex index of the thread
+	* @param job set to the job
+	* @param random state of the random victim selection, updated
+	* @return true if a job was found
+	*/
+	bool findJob(int threadIndex, QueuedJob& job, unsigned int& random);
+
+	/**
+	* Runs a job and decreases its counter, wakes the thread blocked on the
+	* counter when it is done
+	* @param job the job
+	*/
+	void execute(const QueuedJob& job);
+
+	/**
+	* Waits a little when no job was found, yields the core when idle for a while
+	* @param cIdle number of times in a row no job was found
+	*/
+	static void idle(int cIdle);
+
+	/**
+	* Blocks a thread until the counter is done. Returns at once if the counter
+	* is done or another thread already blocks on it.
+	* @param threadIndex index of the thread
+	* @param pCounter the counter
+	*/
+	void block(int threadIndex, const JobCounter* pCounter);
+
+	/**
+	* Blocks an idle worker until jobs are run or the job system is destroyed
+	* @param threadIndex index of the worker
+	* @param random state of the random victim selection, updated
+	*/
+	void park(int threadIndex, unsigned int& random);
+
+	/**
+	* Wakes parked workers after jobs have been pushed
+	* @param cJobs number of pushed jobs
+	*/
+	void wakeWorkers(int cJobs);
+
+	std::vector<Deque*>			mDeques;		/**< The deque of each thread, 0 is the creating thread */
+	std::vector<pthread_t>		mWorkers;
+	std::vector<WorkerData>		mWorkerData;
+	pthread_key_t				mThreadIndexKey;	/**< Thread index + 1 of the calling thread, 0 if not ours */
+	volatile bool				mQuit;
+	volatile long				mcParked;		/**< Number of workers that are parked or about to park */
+	Semaphore					mWakeSemaphore;	/**< Parked workers wait on this */
+	std::vector<AutoResetEvent*>	mDoneEvents;	/**< Set when the counter a thread blocks on is done */
+
+	// Not copyable
+	JobSystem(const JobSystem&);
+	JobSystem& operator=(const JobSystem&);
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,315 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Jump Point Search over a PathCostMap for open areas with uniform cost.
+*/
+
+#include "JumpPointSearch.h"
+
+using namespace utilities;
+
+JumpPointSearch::JumpPointSearch(const PathCostMap& costMap) :
+	mCostMap(costMap), mNodes(costMap.getWidth() * costMap.getHeight()), mOpen(costMap.getWidth() * costMap.getHeight())
+{
+	mWidth = costMap.getWidth();
+	mcExpanded = 0;
+}
+
+JumpPointSearch::~JumpPointSearch()
+{
+}
+
+int JumpPointSearch::findPath(const MapCoordinate& start, const MapCoordinate& goal, const PathBounds& bounds, VectorList<MapCoordinate>* pPath)
+{
+	mNodes.nextGeneration();
+	mOpen.clear();
+	mcExpanded = 0;
+	mBounds = bounds;
+	mGoal = goal;
+
+	if (!isWalkable(start.x, start.y) || !isWalkable(goal.x, goal.y))
+	{
+		return PATH_NOT_FOUND;
+	}
+
+	int startIndex = start.y * mWidth + start.x;
+	int goalIndex = goal.y * mWidth + goal.x;
+
+	mNodes.get(startIndex).cost = 0;
+	mOpen.push(startIndex, getPathHeuristic(start, goal));
+
+	int directionsX[8];
+	int directionsY[8];
+
+	while (!mOpen.empty())
+	{
+		int index = mOpen.pop();
+		PathSearchNode& node = mNodes.get(index);
+		node.closed = true;
+		mcExpanded++;
+
+		if (index == goalIndex)
+		{
+			if (pPath != NULL)
+			{
+				buildPath(goalIndex, pPath);
+			}
+			return node.cost;
+		}
+
+		MapCoordinate current(index % mWidth, index / mWidth);
+		int cDirections = 0;
+		getPrunedDirections(current.x, current.y, node.parent, cDirections, directionsX, directionsY);
+
+		for (int i = 0; i < cDirections; i++)
+		{
+			MapCoordinate jumpPoint;
+			if (!jump(current.x, current.y, directionsX[i], directionsY[i], jumpPoint))
+			{
+				continue;
+			}
+
+			int jumpIndex = jumpPoint.y * mWidth + jumpPoint.x;
+			PathSearchNode& jumpNode = mNodes.get(jumpIndex);
+			if (jumpNode.closed)
+			{
+				continue;
+			}
+
+			// With uniform cost the jump costs the same as the heuristic
+			int cost = node.cost + getPathHeuristic(current, jumpPoint);
+			if (cost < jumpNode.cost)
+			{
+				jumpNode.cost = cost;
+				jumpNode.parent = index;
+				mOpen.push(jumpIndex, cost + getPathHeuristic(jumpPoint, goal));
+			}
+		}
+	}
+
+	return PATH_NOT_FOUND;
+}
+
+bool JumpPointSearch::jump(int x, int y, int dx, int dy, MapCoordinate& jumpPoint) const
+{
+	bool diagonal = dx != 0 && dy != 0;
+
+	for (;;)
+	{
+		// We can't cut corners when stepping diagonally
+		if (diagonal && (!isWalkable(x + dx, y) || !isWalkable(x, y + dy)))
+		{
+			return false;
+		}
+
+		x += dx;
+		y += dy;
+		if (!isWalkable(x, y))
+		{
+			return false;
+		}
+
+		if (x == mGoal.x && y == mGoal.y)
+		{
+			jumpPoint = MapCoordinate(x, y);
+			return true;
+		}
+
+		if (diagonal)
+		{
+			// A diagonal jump stops where any of the straight jumps finds a jump point
+			MapCoordinate straightJumpPoint;
+			if (jump(x, y, dx, 0, straightJumpPoint) || jump(x, y, 0, dy, straightJumpPoint))
+			{
+				jumpPoint = MapCoordinate(x, y);
+				return true;
+			}
+		}
+		else if (dx != 0)
+		{
+			// Forced neighbour: an opening above or below that was blocked behind us
+			if ((isWalkable(x, y - 1) && !isWalkable(x - dx, y - 1)) ||
+				(isWalkable(x, y + 1) && !isWalkable(x - dx, y + 1)))
+			{
+				jumpPoint = MapCoordinate(x, y);
+				return true;
+			}
+		}
+		else
+		{
+			if ((isWalkable(x - 1, y) && !isWalkable(x - 1, y - dy)) ||
+				(isWalkable(x + 1, y) && !isWalkable(x + 1, y - dy)))
+			{
+				jumpPoint = MapCoordinate(x, y);
+				return true;
+			}
+		}
+	}
+}
+
+void JumpPointSearch::getPrunedDirections(int x, int y, int parentIndex, int& cDirections, int directionsX[8], int directionsY[8]) const
+{
+	cDirections = 0;
+
+	// The start node looks in all directions
+	if (parentIndex == -1)
+	{
+		for (int direction = 0; direction < 8; direction++)
+		{
+			if (canPathStep(mCostMap, mBounds, x, y, PATH_DIRECTIONS_X[direction], PATH_DIRECTIONS_Y[direction]))
+			{
+				directionsX[cDirections] = PATH_DIRECTIONS_X[direction];
+				directionsY[cDirections] = PATH_DIRECTIONS_Y[direction];
+				cDirections++;
+			}
+		}
+		return;
+	}
+
+	int parentX = parentIndex % mWidth;
+	int parentY = parentIndex / mWidth;
+	int dx = x > parentX ? 1 : (x < parentX ? -1 : 0);
+	int dy = y > parentY ? 1 : (y < parentY ? -1 : 0);
+
+	if (dx != 0 && dy != 0)
+	{
+		bool horizontalWalkable = isWalkable(x + dx, y);
+		bool verticalWalkable = isWalkable(x, y + dy);
+		if (verticalWalkable)
+		{
+			directionsX[cDirections] = 0;
+			directionsY[cDirections] = dy;
+			cDirections++;
+		}
+		if (horizontalWalkable)
+		{
+			directionsX[cDirections] = dx;
+			directionsY[cDirections] = 0;
+			cDirections++;
+		}
+		if (horizontalWalkable && verticalWalkable)
+		{
+			directionsX[cDirections] = dx;
+			directionsY[cDirections] = dy;
+			cDirections++;
+		}
+	}
+	else if (dx != 0)
+	{
+		bool nextWalkable = isWalkable(x + dx, y);
+		bool aboveWalkable = isWalkable(x, y - 1);
+		bool belowWalkable = isWalkable(x, y + 1);
+		if (nextWalkable)
+		{
+			directionsX[cDirections] = dx;
+			directionsY[cDirections] = 0;
+			cDirections++;
+			if (aboveWalkable)
+			{
+				directionsX[cDirections] = dx;
+				directionsY[cDirections] = -1;
+				cDirections++;
+			}
+			if (belowWalkable)
+			{
+				directionsX[cDirections] = dx;
+				directionsY[cDirections] = 1;
+				cDirections++;
+			}
+		}
+		if (aboveWalkable)
+		{
+			directionsX[cDirections] = 0;
+			directionsY[cDirections] = -1;
+			cDirections++;
+		}
+		if (belowWalkable)
+		{
+			directionsX[cDirections] = 0;
+			directionsY[cDirections] = 1;
+			cDirections++;
+		}
+	}
+	else
+	{
+		bool nextWalkable = isWalkable(x, y + dy);
+		bool leftWalkable = isWalkable(x - 1, y);
+		bool rightWalkable = isWalkable(x + 1, y);
+		if (nextWalkable)
+		{
+			directionsX[cDirections] = 0;
+			directionsY[cDirections] = dy;
+			cDirections++;
+			if (leftWalkable)
+			{
+				directionsX[cDirections] = -1;
+				directionsY[cDirections] = dy;
+				cDirections++;
+			}
+			if (rightWalkable)
+			{
+				directionsX[cDirections] = 1;
+				directionsY[cDirections] = dy;
+				cDirections++;
+			}
+		}
+		if (leftWalkable)
+		{
+			directionsX[cDirections] = -1;
+			directionsY[cDirections] = 0;
+			cDirections++;
+		}
+		if (rightWalkable)
+		{
+			directionsX[cDirections] = 1;
+			directionsY[cDirections] = 0;
+			cDirections++;
+		}
+	}
+}
+
+void JumpPointSearch::buildPath(int goalIndex, VectorList<MapCoordinate>* pPath)
+{
+	// Walk back from the goal and fill in the cells between the jump points
+	mReversePath.clear();
+	for (int index = goalIndex; mNodes.get(index).parent != -1; index = mNodes.get(index).parent)
+	{
+		int parentIndex = mNodes.get(index).parent;
+		MapCoordinate cell(index % mWidth, index / mWidth);
+		MapCoordinate parent(parentIndex % mWidth, parentIndex / mWidth);
+		int dx = parent.x > cell.x ? 1 : (parent.x < cell.x ? -1 : 0);
+		int dy = parent.y > cell.y ? 1 : (parent.y < cell.y ? -1 : 0);
+
+		while (cell != parent)
+		{
+			mReversePath.push_back(cell);
+
+			// A jump is always a straight or diagonal line, never both
+			cell.x += dx;
+			cell.y += dy;
+		}
+	}
+
+	for (int i = static_cast<int>(mReversePath.size()) - 1; i >= 0; i--)
+	{
+		pPath->add(mReversePath[i]);
+	}
+}
\ No newline at end of file
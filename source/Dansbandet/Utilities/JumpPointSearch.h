@@ -0,0 +1,148 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Jump Point Search over a PathCostMap for open areas with uniform cost.
+*/
+
+#ifndef __JUMP_POINT_SEARCH_H__
+#define __JUMP_POINT_SEARCH_H__
+
+#include "PathCostMap.h"
+#include "VectorList.h"
+#include "GenerationArray.h"
+#include "IndexedPriorityQueue.h"
+#include <vector>
+
+namespace utilities
+{
+
+/**
+* Jump Point Search (Harabor & Grastien), a variant of A* that prunes symmetric
+* paths by jumping along straight and diagonal lines until it finds a node with
+* a forced neighbour. Only the jump points are added to the open list, which
+* makes it a lot faster than plain A* in large open areas.
+* @note JPS assumes uniform cost, all cells that aren't PATH_COST_BLOCKED are
+* treated as PATH_COST_DEFAULT. Use GridAStar if the cell costs matter.
+* Diagonal moves may not cut corners, just as in GridAStar.
+*/
+class JumpPointSearch
+{
+public:
+	/**
+	* Constructor
+	* @param costMap the map to search in, needs to outlive the JumpPointSearch
+	*/
+	JumpPointSearch(const PathCostMap& costMap);
+
+	/**
+	* Destructor
+	*/
+	~JumpPointSearch();
+
+	/**
+	* Searches for the shortest path between two coordinates.
+	* @param start the coordinate to start from
+	* @param goal the coordinate we want to reach
+	* @param bounds the search is restricted to these bounds
+	* @param pPath if not NULL the path is added to it cell by cell, excluding start
+	* but including goal
+	* @return cost of the path with uniform cell costs, PATH_NOT_FOUND if there is no path
+	* @throws VectorList::FullException if the path doesn't fit in pPath
+	*/
+	int findPath(const MapCoordinate& start, const MapCoordinate& goal, const PathBounds& bounds, VectorList<MapCoordinate>* pPath);
+
+	/**
+	* Searches for the shortest path in the whole map.
+	* @see findPath(const MapCoordinate&, const MapCoordinate&, const PathBounds&, VectorList<MapCoordinate>*)
+	*/
+	inline int findPath(const MapCoordinate& start, const MapCoordinate& goal, VectorList<MapCoordinate>* pPath)
+	{
+		return findPath(start, goal, getPathBounds(mCostMap), pPath);
+	}
+
+	/**
+	* Returns the number of jump points that were expanded in the last search
+	* @return number of expanded nodes
+	*/
+	inline int getExpandedCount() const
+	{
+		return mcExpanded;
+	}
+
+private:
+	/**
+	* Checks if a coordinate is inside the bounds and not blocked
+	* @param x the x-coordinate
+	* @param y the y-coordinate
+	* @return true if walkable
+	*/
+	inline bool isWalkable(int x, int y) const
+	{
+		return isPathWalkable(mCostMap, mBounds, x, y);
+	}
+
+	/**
+	* Jumps from a coordinate in a direction until a jump point is found
+	* @param x the x-coordinate to jump from
+	* @param y the y-coordinate to jump from
+	* @param dx the x-direction, -1, 0 or 1
+	* @param dy the y-direction, -1, 0 or 1
+	* @param jumpPoint set to the jump point if one was found
+	* @return true if a jump point was found
+	*/
+	bool jump(int x, int y, int dx, int dy, MapCoordinate& jumpPoint) const;
+
+	/**
+	* Adds the directions we need to look in from a node, pruned by the direction
+	* we came from.
+	* @param x the x-coordinate of the node
+	* @param y the y-coordinate of the node
+	* @param parentIndex index of the parent node, -1 for the start node
+	* @param cDirections set to the number of directions
+	* @param directionsX filled with the x-directions, room for 8
+	* @param directionsY filled with the y-directions, room for 8
+	*/
+	void getPrunedDirections(int x, int y, int parentIndex, int& cDirections, int directionsX[8], int directionsY[8]) const;
+
+	/**
+	* Adds the path to the goal to pPath, the straight lines between the jump
+	* points are filled in cell by cell.
+	* @param goalIndex index of the goal node
+	* @param pPath the list to add the path to
+	*/
+	void buildPath(int goalIndex, VectorList<MapCoordinate>* pPath);
+
+	const PathCostMap&					mCostMap;
+	int									mWidth;
+	PathBounds							mBounds;		/**< The bounds of the current search */
+	MapCoordinate						mGoal;			/**< The goal of the current search */
+	GenerationArray<PathSearchNode>		mNodes;			/**< State of each map coordinate in the current search */
+	IndexedPriorityQueue				mOpen;			/**< Open jump points ordered by estimated total cost */
+	std::vector<MapCoordinate>			mReversePath;	/**< Scratch buffer when building the path */
+	int									mcExpanded;
+
+	// Not copyable
+	JumpPointSearch(const JumpPointSearch&);
+	JumpPointSearch& operator=(const JumpPointSearch&);
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,201 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Binary map file format that can be memory mapped and used directly as the
+* backing store of a read-only Vector2D. The file consists of a MapFileHeader
+* followed by padding up to MAP_FILE_DATA_ALIGNMENT and then the cells in
+* row-major order, exactly as they are laid out in memory. Thus the cell type
+* needs to be a POD-type without pointers.
+*/
+
+#ifndef __MAP_FILE_H__
+#define __MAP_FILE_H__
+
+#include "Macros.h"
+#include "Exception.h"
+#include "Vector2D.h"
+#include "MemoryMappedFile.h"
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace utilities
+{
+
+/** Magic number that starts all map files, "DBMP" in little endian */
+const unsigned int MAP_FILE_MAGIC = 0x504D4244;
+
+/** The current version of the map file format, increase when the layout changes */
+const unsigned int MAP_FILE_VERSION = 1;
+
+/** Alignment of the cell data from the start of the file, in bytes */
+const unsigned int MAP_FILE_DATA_ALIGNMENT = 64;
+
+/**
+* The header of a map file. All values are stored in little endian.
+*/
+struct MapFileHeader
+{
+	unsigned int magic;			/**< Always MAP_FILE_MAGIC */
+	unsigned int version;		/**< Version of the format, MAP_FILE_VERSION */
+	unsigned int headerSize;	/**< sizeof(MapFileHeader) when the file was written */
+	unsigned int cellSize;		/**< sizeof() the cell type */
+	int width;					/**< Width of the map in cells */
+	int height;					/**< Height of the map in cells */
+	unsigned int dataOffset;	/**< Offset from the start of the file to the first cell */
+	unsigned int dataSize;		/**< Size of the cell data in bytes, cellSize * width * height */
+};
+
+/**
+* Thrown when a map file is corrupt, of another version or doesn't match the cell type.
+*/
+class MapFileInvalidException : public Exception
+{
+public:
+	MapFileInvalidException(const std::string& filePath) :
+		Exception("MapFileInvalidException: Invalid or incompatible map file " + filePath, 70006) {}
+};
+
+/**
+* Thrown when a map file couldn't be written.
+*/
+class MapFileWriteException : public Exception
+{
+public:
+	MapFileWriteException(const std::string& filePath) :
+		Exception("MapFileWriteException: Could not write map file " + filePath, 70007) {}
+};
+
+/**
+* Converts an in-memory map into the binary map file format. Any shifting of the
+* vector is applied, i.e. the cell at get(0,0) will be the first cell in the file.
+* @param filePath the file to write to, will be overwritten if it exists
+* @param map the map to convert
+* @throws MapFileWriteException if the file couldn't be written
+*/
+template <typename T>
+void writeMapFile(const std::string& filePath, const Vector2D<T>& map)
+{
+	MapFileHeader header;
+	header.magic = MAP_FILE_MAGIC;
+	header.version = MAP_FILE_VERSION;
+	header.headerSize = sizeof(MapFileHeader);
+	header.cellSize = sizeof(T);
+	header.width = map.getWidth();
+	header.height = map.getHeight();
+	header.dataOffset = MAP_FILE_DATA_ALIGNMENT;
+	header.dataSize = sizeof(T) * map.getWidth() * map.getHeight();
+
+	std::vector<T> cells(map.getWidth() * map.getHeight());
+	if (!cells.empty())
+	{
+		map.copyTo(&cells[0]);
+	}
+
+	std::ofstream file(filePath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		throw MapFileWriteException(filePath);
+	}
+
+	char padding[MAP_FILE_DATA_ALIGNMENT] = {0};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(MapFileHeader));
+	file.write(padding, MAP_FILE_DATA_ALIGNMENT - sizeof(MapFileHeader));
+	if (!cells.empty())
+	{
+		file.write(reinterpret_cast<const char*>(&cells[0]), header.dataSize);
+	}
+
+	if (!file.good())
+	{
+		throw MapFileWriteException(filePath);
+	}
+}
+
+/**
+* A map file that is memory mapped and accessed through a read-only Vector2D.
+* Nothing is parsed or copied when the map is opened, only the header is
+* validated. The cells are paged in by the OS when they're first accessed.
+*/
+template <typename T>
+class MappedMap
+{
+public:
+	/**
+	* Constructor, maps the specified map file.
+	* @param filePath path to the map file
+	* @throws MemoryMappedFile::OpenException if the file couldn't be opened
+	* @throws MapFileInvalidException if the file isn't a valid map file for T
+	*/
+	MappedMap(const std::string& filePath) : mFile(filePath), mpMap(NULL)
+	{
+		const MapFileHeader* pHeader = static_cast<const MapFileHeader*>(mFile.getData());
+
+		// The sizes are validated with divisions and subtractions, a corrupt
+		// header could otherwise make a product or sum wrap around and match
+		if (mFile.getSize() < sizeof(MapFileHeader) ||
+			pHeader->magic != MAP_FILE_MAGIC ||
+			pHeader->version != MAP_FILE_VERSION ||
+			pHeader->headerSize != sizeof(MapFileHeader) ||
+			pHeader->cellSize != sizeof(T) ||
+			pHeader->width <= 0 || pHeader->height <= 0 ||
+			static_cast<size_t>(pHeader->width) > pHeader->dataSize / sizeof(T) / static_cast<size_t>(pHeader->height) ||
+			pHeader->dataSize != sizeof(T) * pHeader->width * pHeader->height ||
+			pHeader->dataOffset < sizeof(MapFileHeader) ||
+			pHeader->dataOffset % MAP_FILE_DATA_ALIGNMENT != 0 ||
+			pHeader->dataOffset > mFile.getSize() ||
+			pHeader->dataSize > mFile.getSize() - pHeader->dataOffset)
+		{
+			throw MapFileInvalidException(filePath);
+		}
+
+		const char* pData = static_cast<const char*>(mFile.getData()) + pHeader->dataOffset;
+		mpMap = myNew Vector2D<T>(pHeader->width, pHeader->height, reinterpret_cast<const T*>(pData));
+	}
+
+	/**
+	* Destructor, unmaps the file
+	*/
+	~MappedMap()
+	{
+		SAFE_DELETE(mpMap);
+	}
+
+	/**
+	* Returns the read-only view of the map
+	* @return read-only vector that uses the file as backing store
+	*/
+	inline const Vector2D<T>& getMap() const
+	{
+		return *mpMap;
+	}
+
+private:
+	// Not copyable, we own the mapping
+	MappedMap(const MappedMap&);
+	MappedMap& operator=(const MappedMap&);
+
+	MemoryMappedFile	mFile;	/**< The mapped file */
+	Vector2D<T>*		mpMap;	/**< View of the cells in the mapped file */
+};
+}
+
+#endif
\ No newline at end of file
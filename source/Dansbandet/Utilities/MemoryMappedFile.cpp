@@ -0,0 +1,91 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Read-only memory mapping of a whole file.
+*/
+
+#include "MemoryMappedFile.h"
+#include <windows.h>
+
+using namespace utilities;
+
+MemoryMappedFile::MemoryMappedFile(const std::string& filePath)
+{
+	mFile = INVALID_HANDLE_VALUE;
+	mMapping = NULL;
+	mpData = NULL;
+	mSize = 0;
+
+	// We let the OS know that we'll access the file randomly, no need to read ahead
+	mFile = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+	if (mFile == INVALID_HANDLE_VALUE)
+	{
+		throw OpenException(filePath);
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(mFile, &fileSize) || fileSize.QuadPart == 0)
+	{
+		close();
+		throw OpenException(filePath);
+	}
+	mSize = static_cast<size_t>(fileSize.QuadPart);
+
+	mMapping = CreateFileMappingA(mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mMapping == NULL)
+	{
+		close();
+		throw OpenException(filePath);
+	}
+
+	mpData = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+	if (mpData == NULL)
+	{
+		close();
+		throw OpenException(filePath);
+	}
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	close();
+}
+
+void MemoryMappedFile::close()
+{
+	if (mpData != NULL)
+	{
+		UnmapViewOfFile(mpData);
+		mpData = NULL;
+	}
+	if (mMapping != NULL)
+	{
+		CloseHandle(mMapping);
+		mMapping = NULL;
+	}
+	if (mFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mFile);
+		mFile = INVALID_HANDLE_VALUE;
+	}
+	mSize = 0;
+}
\ No newline at end of file
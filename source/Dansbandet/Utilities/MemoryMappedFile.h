@@ -0,0 +1,100 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Read-only memory mapping of a whole file.
+*/
+
+#ifndef __MEMORY_MAPPED_FILE_H__
+#define __MEMORY_MAPPED_FILE_H__
+
+#include "Macros.h"
+#include "Exception.h"
+#include <string>
+
+namespace utilities
+{
+
+/**
+* Maps a whole file read-only into memory. The pages are loaded by the OS when
+* they're first accessed, so opening a file costs the same regardless of its size.
+*/
+class MemoryMappedFile
+{
+public:
+	/**
+	* Thrown when the file can't be opened or mapped.
+	*/
+	class OpenException : public Exception
+	{
+	public:
+		OpenException(const std::string& filePath) :
+			Exception("MemoryMappedFileOpenException: Could not map file " + filePath, 70005) {}
+	};
+
+	/**
+	* Constructor, maps the specified file.
+	* @param filePath path to the file to map
+	* @throws OpenException if the file couldn't be opened or mapped
+	*/
+	MemoryMappedFile(const std::string& filePath);
+
+	/**
+	* Destructor, unmaps the file.
+	*/
+	~MemoryMappedFile();
+
+	/**
+	* Returns the start of the mapped file. The address is aligned to at least
+	* the page size.
+	* @return pointer to the first byte of the file
+	*/
+	inline const void* getData() const
+	{
+		return mpData;
+	}
+
+	/**
+	* Returns the size of the file
+	* @return size of the file in bytes
+	*/
+	inline size_t getSize() const
+	{
+		return mSize;
+	}
+
+private:
+	/**
+	* Closes all handles and unmaps the view
+	*/
+	void close();
+
+	// Not copyable, we own the mapping
+	MemoryMappedFile(const MemoryMappedFile&);
+	MemoryMappedFile& operator=(const MemoryMappedFile&);
+
+	void*	mFile;		/**< Handle to the file */
+	void*	mMapping;	/**< Handle to the file mapping */
+	void*	mpData;		/**< The mapped view of the file */
+	size_t	mSize;		/**< Size of the file in bytes */
+};
+}
+
+#endif
\ No newline at end of file
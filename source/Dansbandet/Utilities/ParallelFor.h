@@ -0,0 +1,435 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Data-parallel loops on the JobSystem. Index ranges, VectorList elements and
+* Vector2D rows are split recursively and the parts are stolen by idle workers.
+*/
+
+#ifndef __PARALLEL_FOR_H__
+#define __PARALLEL_FOR_H__
+
+#include "JobSystem.h"
+#include "VectorList.h"
+#include "Vector2D.h"
+
+namespace utilities
+{
+
+/** Lets the loop choose the grain size from the range and the number of threads */
+const int PARALLEL_GRAIN_AUTO = 0;
+
+/**
+* The smallest automatic grain size. Loops with automatic grain size and fewer
+* items than this run inline on the calling thread. Loops where each item is
+* expensive, e.g. a whole map tile, should specify their grain size instead.
+*/
+const int PARALLEL_GRAIN_AUTO_MIN = 256;
+
+/** Number of parts per thread with automatic grain size, more parts balance better */
+const int PARALLEL_PARTS_PER_THREAD = 4;
+
+/** A range is halved at most this many times in each job, enough for any int range */
+const int PARALLEL_SPLIT_COUNT_MAX = 32;
+
+/**
+* Returns the grain size a loop will use
+* @param pJobSystem the job system to run on, NULL to run on the calling thread
+* @param count number of items in the loop
+* @param grain the requested grain size, PARALLEL_GRAIN_AUTO to choose one
+* @return the largest number of items that are run without splitting, i.e.
+* count if the whole loop shall run inline
+*/
+inline int getParallelGrain(const JobSystem* pJobSystem, int count, int grain)
+{
+	if (pJobSystem == NULL || pJobSystem->getThreadCount() == 1)
+	{
+		return count;
+	}
+	if (grain <= PARALLEL_GRAIN_AUTO)
+	{
+		grain = count / (pJobSystem->getThreadCount() * PARALLEL_PARTS_PER_THREAD);
+		if (grain < PARALLEL_GRAIN_AUTO_MIN)
+		{
+			grain = PARALLEL_GRAIN_AUTO_MIN;
+		}
+	}
+	return grain;
+}
+
+/**
+* A job that runs a part of parallelFor(). The upper halves of the range are
+* given to other threads until the rest is no larger than the grain size.
+*/
+template <typename Function>
+struct ParallelForTask
+{
+	JobSystem* pJobSystem;
+	const Function* pFunction;
+	int begin;
+	int end;
+	int grain;
+
+	static void run(void* pData)
+	{
+		const ParallelForTask& task = *static_cast<const ParallelForTask*>(pData);
+		ParallelForTask splits[PARALLEL_SPLIT_COUNT_MAX];
+		JobCounter counter;
+		int end = task.end;
+		for (int i = 0; i < PARALLEL_SPLIT_COUNT_MAX && end - task.begin > task.grain; i++)
+		{
+			int middle = task.begin + (end - task.begin) / 2;
+			splits[i] = task;
+			splits[i].begin = middle;
+			splits[i].end = end;
+			task.pJobSystem->run(Job(run, &splits[i]), &counter);
+			end = middle;
+		}
+
+		(*task.pFunction)(task.begin, end);
+		task.pJobSystem->wait(&counter);
+	}
+};
+
+/**
+* A job that runs a part of parallelReduce(), splits like ParallelForTask and
+* combines the results of the parts from left to right.
+*/
+template <typename Result, typename Function, typename Combine>
+struct ParallelReduceTask
+{
+	JobSystem* pJobSystem;
+	const Function* pFunction;
+	const Combine* pCombine;
+	int begin;
+	int end;
+	int grain;
+	Result result;
+
+	static void run(void* pData)
+	{
+		ParallelReduceTask& task = *static_cast<ParallelReduceTask*>(pData);
+		ParallelReduceTask splits[PARALLEL_SPLIT_COUNT_MAX];
+		JobCounter counter;
+		int end = task.end;
+		int cSplits = 0;
+		while (cSplits < PARALLEL_SPLIT_COUNT_MAX && end - task.begin > task.grain)
+		{
+			int middle = task.begin + (end - task.begin) / 2;
+			splits[cSplits] = task;
+			splits[cSplits].begin = middle;
+			splits[cSplits].end = end;
+			task.pJobSystem->run(Job(run, &splits[cSplits]), &counter);
+			cSplits++;
+			end = middle;
+		}
+
+		task.result = (*task.pFunction)(task.begin, end);
+		task.pJobSystem->wait(&counter);
+
+		// The last split is the part closest to ours
+		for (int i = cSplits - 1; i >= 0; i--)
+		{
+			task.result = (*task.pCombine)(task.result, splits[i].result);
+		}
+	}
+};
+
+/**
+* Calls function(begin, end) for parts of [begin, end), in parallel on the
+* job system. The parts are at most grain items unless the loop runs inline.
+* The function is called concurrently and has to be thread-safe. Call from the
+* thread that created the job system or from a job, other threads run the
+* whole loop inline.
+* @param pJobSystem the job system to run on, NULL to run on the calling thread
+* @param begin the first index
+* @param end one past the last index
+* @param grain the largest number of items to run in one call, PARALLEL_GRAIN_AUTO
+* to choose one from the range and the number of threads
+* @param function functor with operator()(int begin, int end) const
+*/
+template <typename Function>
+void parallelFor(JobSystem* pJobSystem, int begin, int end, int grain, const Function& function)
+{
+	if (begin >= end)
+	{
+		return;
+	}
+
+	grain = getParallelGrain(pJobSystem, end - begin, grain);
+	if (end - begin <= grain)
+	{
+		function(begin, end);
+		return;
+	}
+
+	ParallelForTask<Function> task;
+	task.pJobSystem = pJobSystem;
+	task.pFunction = &function;
+	task.begin = begin;
+	task.end = end;
+	task.grain = grain;
+	ParallelForTask<Function>::run(&task);
+}
+
+/**
+* Calculates function(begin, end) for parts of [begin, end) in parallel and
+* combines the results. The parts are always combined in order from left to
+* right, combine thus only has to be associative.
+* @param pJobSystem the job system to run on, NULL to run on the calling thread
+* @param begin the first index
+* @param end one past the last index
+* @param grain see parallelFor()
+* @param identity the result of an empty range
+* @param function functor with Result operator()(int begin, int end) const
+* @param combine functor with Result operator()(const Result&, const Result&) const
+* @return the combined result of all parts
+*/
+template <typename Result, typename Function, typename Combine>
+Result parallelReduce(JobSystem* pJobSystem, int begin, int end, int grain, const Result& identity, const Function& function, const Combine& combine)
+{
+	if (begin >= end)
+	{
+		return identity;
+	}
+
+	grain = getParallelGrain(pJobSystem, end - begin, grain);
+	if (end - begin <= grain)
+	{
+		return function(begin, end);
+	}
+
+	ParallelReduceTask<Result, Function, Combine> task;
+	task.pJobSystem = pJobSystem;
+	task.pFunction = &function;
+	task.pCombine = &combine;
+	task.begin = begin;
+	task.end = end;
+	task.grain = grain;
+	task.result = identity;
+	ParallelReduceTask<Result, Function, Combine>::run(&task);
+	return task.result;
+}
+
+/**
+* Splits an index range of a VectorList into the segments that are contiguous
+* in memory and calls function(pElements, index, count) for each of them.
+*/
+template <typename T, typename Function>
+struct VectorListSegments
+{
+	VectorList<T>* pList;
+	const Function* pFunction;
+
+	void operator()(int begin, int end) const
+	{
+		while (begin < end)
+		{
+			int count;
+			T* pElements = pList->getSegment(begin, count);
+			if (count > end - begin)
+			{
+				count = end - begin;
+			}
+			(*pFunction)(pElements, begin, count);
+			begin += count;
+		}
+	}
+};
+
+/**
+* Reduces an index range of a VectorList segment by segment, see VectorListSegments
+*/
+template <typename T, typename Result, typename Function, typename Combine>
+struct VectorListSegmentsReduce
+{
+	const VectorList<T>* pList;
+	const Function* pFunction;
+	const Combine* pCombine;
+
+	Result operator()(int begin, int end) const
+	{
+		int count;
+		const T* pElements = pList->getSegment(begin, count);
+		if (count >= end - begin)
+		{
+			return (*pFunction)(pElements, begin, end - begin);
+		}
+
+		// The range wraps around the end of the array
+		Result result = (*pFunction)(pElements, begin, count);
+		begin += count;
+		pElements = pList->getSegment(begin, count);
+		return (*pCombine)(result, (*pFunction)(pElements, begin, end - begin));
+	}
+};
+
+/**
+* Runs function on all elements of a VectorList in parallel. The function is
+* called with contiguous elements, a part that wraps around the end of the
+* list's array is split in two calls.
+* @param pJobSystem the job system to run on, NULL to run on the calling thread
+* @param list the list, may not be resized during the loop
+* @param grain the largest number of elements in one part, see parallelFor()
+* @param function functor with operator()(T* pElements, int index, int count) const,
+* pElements[0] is list[index]
+*/
+template <typename T, typename Function>
+void parallelFor(JobSystem* pJobSystem, VectorList<T>& list, int grain, const Function& function)
+{
+	VectorListSegments<T, Function> segments;
+	segments.pList = &list;
+	segments.pFunction = &function;
+	parallelFor(pJobSystem, 0, list.size(), grain, segments);
+}
+
+/**
+* Reduces all elements of a VectorList in parallel, see parallelReduce() and
+* parallelFor(JobSystem*, VectorList<T>&, int, const Function&)
+* @param function functor with Result operator()(const T* pElements, int index, int count) const
+*/
+template <typename T, typename Result, typename Function, typename Combine>
+Result parallelReduce(JobSystem* pJobSystem, const VectorList<T>& list, int grain, const Result& identity, const Function& function, const Combine& combine)
+{
+	VectorListSegmentsReduce<T, Result, Function, Combine> segments;
+	segments.pList = &list;
+	segments.pFunction = &function;
+	segments.pCombine = &combine;
+	return parallelReduce(pJobSystem, 0, list.size(), grain, identity, segments, combine);
+}
+
+/**
+* Splits a band of Vector2D rows into the row segments that are contiguous in
+* memory and calls function(pElements, x, y, count) for each of them.
+*/
+template <typename T, typename Function>
+struct Vector2DRowSegments
+{
+	Vector2D<T>* pVector;
+	const Function* pFunction;
+
+	void operator()(int beginY, int endY) const
+	{
+		int width = pVector->getWidth();
+		for (int y = beginY; y < endY; y++)
+		{
+			for (int x = 0; x < width; )
+			{
+				int count;
+				T* pElements = pVector->getRowSegment(x, y, count);
+				(*pFunction)(pElements, x, y, count);
+				x += count;
+			}
+		}
+	}
+};
+
+/**
+* Reduces a band of Vector2D rows segment by segment, see Vector2DRowSegments
+*/
+template <typename T, typename Result, typename Function, typename Combine>
+struct Vector2DRowSegmentsReduce
+{
+	const Vector2D<T>* pVector;
+	const Function* pFunction;
+	const Combine* pCombine;
+	const Result* pIdentity;
+
+	Result operator()(int beginY, int endY) const
+	{
+		Result result = *pIdentity;
+		int width = pVector->getWidth();
+		for (int y = beginY; y < endY; y++)
+		{
+			for (int x = 0; x < width; )
+			{
+				int count;
+				const T* pElements = pVector->getRowSegment(x, y, count);
+				result = (*pCombine)(result, (*pFunction)(pElements, x, y, count));
+				x += count;
+			}
+		}
+		return result;
+	}
+};
+
+/**
+* Runs function on all elements of a Vector2D in parallel, split in bands of
+* whole rows. The function is called with contiguous elements of one row, a row
+* that wraps because of the shifting is split in two calls.
+* @param pJobSystem the job system to run on, NULL to run on the calling thread
+* @param vector the 2D vector
+* @param grain the largest number of rows in one band, see parallelFor()
+* @param function functor with operator()(T* pElements, int x, int y, int count) const,
+* pElements[0] is vector.get(x, y)
+* @throws Vector2D<T>::ReadOnlyException if the vector is read-only, use parallelReduce() on views
+*/
+template <typename T, typename Function>
+void parallelFor(JobSystem* pJobSystem, Vector2D<T>& vector, int grain, const Function& function)
+{
+	// Thrown here instead of from the jobs
+	if (vector.isReadOnly())
+	{
+		throw typename Vector2D<T>::ReadOnlyException();
+	}
+
+	if (grain <= PARALLEL_GRAIN_AUTO && vector.getWidth() > 0)
+	{
+		// Choose the number of rows from the number of elements
+		grain = getParallelGrain(pJobSystem, vector.getWidth() * vector.getHeight(), grain) / vector.getWidth();
+		if (grain < 1)
+		{
+			grain = 1;
+		}
+	}
+
+	Vector2DRowSegments<T, Function> segments;
+	segments.pVector = &vector;
+	segments.pFunction = &function;
+	parallelFor(pJobSystem, 0, vector.getHeight(), grain, segments);
+}
+
+/**
+* Reduces all elements of a Vector2D in parallel, see parallelReduce() and
+* parallelFor(JobSystem*, Vector2D<T>&, int, const Function&)
+* @param function functor with Result operator()(const T* pElements, int x, int y, int count) const
+*/
+template <typename T, typename Result, typename Function, typename Combine>
+Result parallelReduce(JobSystem* pJobSystem, const Vector2D<T>& vector, int grain, const Result& identity, const Function& function, const Combine& combine)
+{
+	if (grain <= PARALLEL_GRAIN_AUTO && vector.getWidth() > 0)
+	{
+		grain = getParallelGrain(pJobSystem, vector.getWidth() * vector.getHeight(), grain) / vector.getWidth();
+		if (grain < 1)
+		{
+			grain = 1;
+		}
+	}
+
+	Vector2DRowSegmentsReduce<T, Result, Function, Combine> segments;
+	segments.pVector = &vector;
+	segments.pFunction = &function;
+	segments.pCombine = &combine;
+	segments.pIdentity = &identity;
+	return parallelReduce(pJobSystem, 0, vector.getHeight(), grain, identity, segments, combine);
+}
+}
+
+#endif
\ No newline at end of file
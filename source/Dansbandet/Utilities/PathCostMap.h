@@ -0,0 +1,181 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Common definitions for the grid pathfinders. The map is a Vector2D with one
+* traversal cost per map coordinate, where PATH_COST_BLOCKED is a wall.
+* Movement is 8-directional and diagonal moves may not cut corners.
+*/
+
+#ifndef __PATH_COST_MAP_H__
+#define __PATH_COST_MAP_H__
+
+#include "Vector2D.h"
+#include "Vec2Int.h"
+#include <cstdlib>
+#include <climits>
+
+namespace utilities
+{
+
+/** A map with the traversal cost of each map coordinate */
+typedef Vector2D<unsigned char> PathCostMap;
+
+/** The cost of a map coordinate that can't be traversed, e.g. a wall */
+const unsigned char PATH_COST_BLOCKED = 0;
+
+/** The cost of a map coordinate in an open area */
+const unsigned char PATH_COST_DEFAULT = 1;
+
+/** Cost of a straight step between two cells with cost 1 */
+const int PATH_STEP_STRAIGHT = 10;
+
+/** Cost of a diagonal step between two cells with cost 1 */
+const int PATH_STEP_DIAGONAL = 14;
+
+/** Returned by the pathfinders when no path exists */
+const int PATH_NOT_FOUND = -1;
+
+/** The 8 directions we can move in, the first 4 are straight the last 4 diagonal */
+const int PATH_DIRECTIONS_X[8] = {1, 0, -1, 0, 1, -1, -1, 1};
+const int PATH_DIRECTIONS_Y[8] = {0, 1, 0, -1, 1, 1, -1, -1};
+
+/**
+* An inclusive rectangle of map coordinates that a search is restricted to
+*/
+struct PathBounds
+{
+	int minX;
+	int minY;
+	int maxX;
+	int maxY;
+
+	/**
+	* Constructor
+	* @param minX the smallest x-coordinate inside the bounds
+	* @param minY the smallest y-coordinate inside the bounds
+	* @param maxX the largest x-coordinate inside the bounds
+	* @param maxY the largest y-coordinate inside the bounds
+	*/
+	PathBounds(int minX = 0, int minY = 0, int maxX = -1, int maxY = -1) :
+		minX(minX), minY(minY), maxX(maxX), maxY(maxY) {}
+
+	/**
+	* Checks if the coordinate is inside the bounds
+	* @param x the x-coordinate
+	* @param y the y-coordinate
+	* @return true if the coordinate is inside
+	*/
+	inline bool contains(int x, int y) const
+	{
+		return x >= minX && x <= maxX && y >= minY && y <= maxY;
+	}
+};
+
+/**
+* The state of a map coordinate during a search
+*/
+struct PathSearchNode
+{
+	int cost;		/**< Cheapest known cost from the start, INT_MAX if unknown */
+	int parent;		/**< Index of the node we came from, -1 if none */
+	bool closed;	/**< If the node has been expanded */
+
+	PathSearchNode() : cost(INT_MAX), parent(-1), closed(false) {}
+};
+
+/**
+* Returns bounds that cover the whole map
+* @param costMap the map
+* @return bounds of the whole map
+*/
+inline PathBounds getPathBounds(const PathCostMap& costMap)
+{
+	return PathBounds(0, 0, costMap.getWidth() - 1, costMap.getHeight() - 1);
+}
+
+/**
+* Checks if a coordinate can be traversed
+* @param costMap the map
+* @param bounds the bounds we're restricted to
+* @param x the x-coordinate
+* @param y the y-coordinate
+* @return true if the coordinate is inside the bounds and not blocked
+*/
+inline bool isPathWalkable(const PathCostMap& costMap, const PathBounds& bounds, int x, int y)
+{
+	return bounds.contains(x, y) && costMap.get(x, y) != PATH_COST_BLOCKED;
+}
+
+/**
+* Returns the cost of a step between two neighbouring cells. The cost is the
+* average of the two cells, which makes it symmetric.
+* @param costMap the map
+* @param from the cell we step from
+* @param to the cell we step to
+* @param diagonal if it's a diagonal step
+* @return cost of the step
+*/
+inline int getPathStepCost(const PathCostMap& costMap, const MapCoordinate& from, const MapCoordinate& to, bool diagonal)
+{
+	int cellCosts = costMap.get(from.x, from.y) + costMap.get(to.x, to.y);
+	return diagonal ? (PATH_STEP_DIAGONAL * cellCosts) >> 1 : (PATH_STEP_STRAIGHT * cellCosts) >> 1;
+}
+
+/**
+* Checks if we can take a step in the specified direction, i.e. the target
+* isn't blocked and a diagonal step doesn't cut a corner.
+* @param costMap the map
+* @param bounds the bounds we're restricted to
+* @param x the x-coordinate we step from
+* @param y the y-coordinate we step from
+* @param dx the x-direction, -1, 0 or 1
+* @param dy the y-direction, -1, 0 or 1
+* @return true if the step is allowed
+*/
+inline bool canPathStep(const PathCostMap& costMap, const PathBounds& bounds, int x, int y, int dx, int dy)
+{
+	if (!isPathWalkable(costMap, bounds, x + dx, y + dy))
+	{
+		return false;
+	}
+	if (dx != 0 && dy != 0)
+	{
+		return isPathWalkable(costMap, bounds, x + dx, y) && isPathWalkable(costMap, bounds, x, y + dy);
+	}
+	return true;
+}
+
+/**
+* Octile distance heuristic, admissible as long as no cell is cheaper than 1.
+* @param from the coordinate to measure from
+* @param to the coordinate to measure to
+* @return estimated cost between the coordinates
+*/
+inline int getPathHeuristic(const MapCoordinate& from, const MapCoordinate& to)
+{
+	int dx = abs(from.x - to.x);
+	int dy = abs(from.y - to.y);
+	int diagonal = dx < dy ? dx : dy;
+	return PATH_STEP_STRAIGHT * (dx + dy) + (PATH_STEP_DIAGONAL - 2 * PATH_STEP_STRAIGHT) * diagonal;
+}
+}
+
+#endif
\ No newline at end of file
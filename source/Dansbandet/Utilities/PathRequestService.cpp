@@ -0,0 +1,489 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Schedules path requests over several frames within a time budget. Requests are
+* served in priority order, identical requests share one search and finished
+* paths are cached so a swarm walking to the same goal only searches once.
+*/
+
+#include "PathRequestService.h"
+#include <algorithm>
+
+using namespace utilities;
+
+namespace
+{
+/**
+* Share of the update budget that may be spent looking for cache hits and
+* joins once all slots are busy, the rest is left for stepping the searches
+*/
+const float WAITING_SCAN_BUDGET_SHARE = 0.5f;
+}
+
+PathRequestService::PathRequestService(const PathCostMap& costMap, int cConcurrentSearches, int clusterSize, int cacheSize) :
+	mCostMap(costMap), mLegSearch(costMap), mSlots(cConcurrentSearches)
+{
+	mClusterSize = clusterSize;
+	mcClustersX = (costMap.getWidth() + clusterSize - 1) / clusterSize;
+	mCacheSize = cacheSize;
+	mCacheClock = 0;
+	mNextRequestId = 0;
+	mNextSlotOrder = 0;
+
+	for (size_t i = 0; i < mSlots.size(); i++)
+	{
+		mSlots[i].pSearch = myNew GridAStar(costMap);
+		mSlots[i].active = false;
+		mSlots[i].priority = Priority_Far;
+		mSlots[i].order = 0;
+	}
+}
+
+PathRequestService::~PathRequestService()
+{
+	for (size_t i = 0; i < mSlots.size(); i++)
+	{
+		SAFE_DELETE(mSlots[i].pSearch);
+	}
+}
+
+int PathRequestService::requestPath(const MapCoordinate& start, const MapCoordinate& goal, Priorities priority)
+{
+	int requestId = mNextRequestId;
+	mNextRequestId++;
+
+	Request& request = mRequests[requestId];
+	request.start = start;
+	request.goal = goal;
+	request.priority = priority;
+	request.status = RequestStatus_Pending;
+
+	mQueues[priority].push_back(requestId);
+	return requestId;
+}
+
+void PathRequestService::releaseRequest(int requestId)
+{
+	std::map<int, Request>::iterator requestIt = mRequests.find(requestId);
+	if (requestIt == mRequests.end())
+	{
+		return;
+	}
+
+	// The id is skipped when it's popped from the queue, but we need to remove it
+	// from a search so the search can be dropped when nobody waits for it.
+	if (requestIt->second.status == RequestStatus_Pending)
+	{
+		for (size_t i = 0; i < mSlots.size(); i++)
+		{
+			SearchSlot& slot = mSlots[i];
+			if (!slot.active)
+			{
+				continue;
+			}
+
+			for (size_t j = 0; j < slot.requests.size(); j++)
+			{
+				if (slot.requests[j] == requestId)
+				{
+					slot.requests.erase(slot.requests.begin() + j);
+					break;
+				}
+			}
+
+			if (slot.requests.empty())
+			{
+				slot.active = false;
+			}
+		}
+	}
+
+	mRequests.erase(requestIt);
+}
+
+PathRequestService::RequestStatuses PathRequestService::getStatus(int requestId) const
+{
+	std::map<int, Request>::const_iterator requestIt = mRequests.find(requestId);
+	if (requestIt == mRequests.end())
+	{
+		return RequestStatus_Invalid;
+	}
+	return requestIt->second.status;
+}
+
+bool PathRequestService::getPath(int requestId, VectorList<MapCoordinate>& path) const
+{
+	std::map<int, Request>::const_iterator requestIt = mRequests.find(requestId);
+	if (requestIt == mRequests.end() || requestIt->second.status != RequestStatus_Found)
+	{
+		return false;
+	}
+
+	const std::vector<MapCoordinate>& requestPath = requestIt->second.path;
+	for (size_t i = 0; i < requestPath.size(); i++)
+	{
+		path.add(requestPath[i]);
+	}
+	return true;
+}
+
+void PathRequestService::update(float budget)
+{
+	mTimer.start();
+
+	startSearches(budget);
+	while (mTimer.getTime(Timer::ReturnType_MilliSeconds) < budget)
+	{
+		int slot = getNextSlot();
+		if (slot == -1)
+		{
+			break;
+		}
+
+		if (mSlots[slot].pSearch->step(SEARCH_STEP_EXPANSIONS) != GridAStar::SearchStatus_Searching)
+		{
+			completeSearch(slot);
+
+			// A slot was freed, let the next request in
+			startSearches(budget);
+		}
+	}
+}
+
+void PathRequestService::onCellChanged(const MapCoordinate& cell)
+{
+	// A new wall only invalidates the paths through it, but a removed wall can
+	// make any cached path too long.
+	if (mCostMap.get(cell.x, cell.y) == PATH_COST_BLOCKED)
+	{
+		std::map<RequestKey, CacheEntry>::iterator cacheIt = mCache.begin();
+		while (cacheIt != mCache.end())
+		{
+			const std::vector<MapCoordinate>& path = cacheIt->second.path;
+			if (std::find(path.begin(), path.end(), cell) != path.end())
+			{
+				mCache.erase(cacheIt++);
+			}
+			else
+			{
+				++cacheIt;
+			}
+		}
+	}
+	else
+	{
+		mCache.clear();
+	}
+
+	for (size_t i = 0; i < mSlots.size(); i++)
+	{
+		SearchSlot& slot = mSlots[i];
+		if (slot.active)
+		{
+			const Request& request = mRequests[slot.requests.front()];
+			slot.pSearch->beginSearch(slot.start, request.goal, getPathBounds(mCostMap));
+		}
+	}
+}
+
+int PathRequestService::getPendingCount() const
+{
+	int cPending = 0;
+	for (std::map<int, Request>::const_iterator requestIt = mRequests.begin(); requestIt != mRequests.end(); ++requestIt)
+	{
+		if (requestIt->second.status == RequestStatus_Pending)
+		{
+			cPending++;
+		}
+	}
+	return cPending;
+}
+
+PathRequestService::RequestKey PathRequestService::getKey(const Request& request) const
+{
+	return RequestKey(getClusterIndex(request.start), request.goal.y * mCostMap.getWidth() + request.goal.x);
+}
+
+void PathRequestService::startSearches(float budget)
+{
+	bool slotsFull = false;
+	for (int priority = 0; priority < Priority_Lim; priority++)
+	{
+		// A preempted search is requeued in a lower priority queue, never in
+		// the one we're walking through
+		// Requests that stay in the queue are moved down over the removed ones,
+		// so the queue is compacted in one pass
+		std::deque<int>& queue = mQueues[priority];
+		size_t readIndex = 0;
+		size_t writeIndex = 0;
+		bool budgetSpent = false;
+		for (; readIndex < queue.size(); readIndex++)
+		{
+			float scanBudget = slotsFull ? budget * WAITING_SCAN_BUDGET_SHARE : budget;
+			if (mTimer.getTime(Timer::ReturnType_MilliSeconds) >= scanBudget)
+			{
+				budgetSpent = true;
+				break;
+			}
+
+			int requestId = queue[readIndex];
+			std::map<int, Request>::iterator requestIt = mRequests.find(requestId);
+
+			// Released while in the queue
+			if (requestIt == mRequests.end())
+			{
+				continue;
+			}
+
+			if (serveFromCache(requestId))
+			{
+				continue;
+			}
+
+			const Request& request = requestIt->second;
+			RequestKey key = getKey(request);
+
+			// Join a search with the same key
+			bool joined = false;
+			for (size_t i = 0; i < mSlots.size() && !joined; i++)
+			{
+				if (mSlots[i].active && mSlots[i].key == key)
+				{
+					mSlots[i].requests.push_back(requestId);
+					if (request.priority < mSlots[i].priority)
+					{
+						mSlots[i].priority = request.priority;
+					}
+					joined = true;
+				}
+			}
+			if (joined)
+			{
+				continue;
+			}
+
+			// All slots are busy with searches of the same or higher priority,
+			// lower priorities can't get a slot either. The rest of the
+			// requests are still served from the cache or join running
+			// searches, the others keep their place in the queue.
+			int slotIndex = slotsFull ? -1 : getFreeSlot(request.priority);
+			if (slotIndex == -1)
+			{
+				slotsFull = true;
+				queue[writeIndex] = requestId;
+				writeIndex++;
+				continue;
+			}
+
+			SearchSlot& slot = mSlots[slotIndex];
+			slot.active = true;
+			slot.priority = request.priority;
+			slot.order = mNextSlotOrder;
+			mNextSlotOrder++;
+			slot.key = key;
+			slot.start = request.start;
+			slot.requests.clear();
+			slot.requests.push_back(requestId);
+			slot.pSearch->beginSearch(request.start, request.goal, getPathBounds(mCostMap));
+		}
+
+		// The requests we didn't get to keep their place after the kept ones
+		queue.erase(std::copy(queue.begin() + readIndex, queue.end(), queue.begin() + writeIndex), queue.end());
+		if (budgetSpent)
+		{
+			return;
+		}
+	}
+}
+
+bool PathRequestService::serveFromCache(int requestId)
+{
+	Request& request = mRequests[requestId];
+	std::map<RequestKey, CacheEntry>::iterator cacheIt = mCache.find(getKey(request));
+	if (cacheIt == mCache.end())
+	{
+		return false;
+	}
+
+	CacheEntry& entry = cacheIt->second;
+	const std::vector<MapCoordinate>& cachedPath = entry.path;
+
+	// Find the last coordinate of the cached path that is still in our cluster,
+	// -1 is the start of the cached path.
+	int startCluster = getClusterIndex(request.start);
+	int joinIndex = -1;
+	for (int i = static_cast<int>(cachedPath.size()) - 1; i >= 0; i--)
+	{
+		if (getClusterIndex(cachedPath[i]) == startCluster)
+		{
+			joinIndex = i;
+			break;
+		}
+	}
+	MapCoordinate joinCell = joinIndex == -1 ? entry.start : cachedPath[joinIndex];
+
+	request.path.clear();
+	if (request.start != joinCell)
+	{
+		int clusterX = (startCluster % mcClustersX) * mClusterSize;
+		int clusterY = (startCluster / mcClustersX) * mClusterSize;
+		PathBounds clusterBounds(clusterX, clusterY,
+			(std::min)(clusterX + mClusterSize, mCostMap.getWidth()) - 1,
+			(std::min)(clusterY + mClusterSize, mCostMap.getHeight()) - 1);
+
+		mPathBuffer.clear();
+		if (mLegSearch.findPath(request.start, joinCell, clusterBounds, &mPathBuffer) == PATH_NOT_FOUND)
+		{
+			return false;
+		}
+		for (int i = 0; i < mPathBuffer.size(); i++)
+		{
+			request.path.push_back(mPathBuffer[i]);
+		}
+	}
+	request.path.insert(request.path.end(), cachedPath.begin() + (joinIndex + 1), cachedPath.end());
+	request.status = RequestStatus_Found;
+
+	mCacheClock++;
+	entry.lastUsed = mCacheClock;
+	return true;
+}
+
+void PathRequestService::addToCache(const RequestKey& key, const MapCoordinate& start, const std::vector<MapCoordinate>& path)
+{
+	if (mCacheSize == 0)
+	{
+		return;
+	}
+
+	if (static_cast<int>(mCache.size()) >= mCacheSize && mCache.find(key) == mCache.end())
+	{
+		std::map<RequestKey, CacheEntry>::iterator oldestIt = mCache.begin();
+		for (std::map<RequestKey, CacheEntry>::iterator cacheIt = mCache.begin(); cacheIt != mCache.end(); ++cacheIt)
+		{
+			if (cacheIt->second.lastUsed < oldestIt->second.lastUsed)
+			{
+				oldestIt = cacheIt;
+			}
+		}
+		mCache.erase(oldestIt);
+	}
+
+	mCacheClock++;
+	CacheEntry& entry = mCache[key];
+	entry.start = start;
+	entry.path = path;
+	entry.lastUsed = mCacheClock;
+}
+
+int PathRequestService::getFreeSlot(Priorities priority)
+{
+	int lowestSlot = -1;
+	for (size_t i = 0; i < mSlots.size(); i++)
+	{
+		if (!mSlots[i].active)
+		{
+			return static_cast<int>(i);
+		}
+
+		// Preempt the lowest priority, and of those the newest search since it
+		// has done the least work.
+		if (mSlots[i].priority > priority &&
+			(lowestSlot == -1 || mSlots[i].priority > mSlots[lowestSlot].priority ||
+			(mSlots[i].priority == mSlots[lowestSlot].priority && mSlots[i].order > mSlots[lowestSlot].order)))
+		{
+			lowestSlot = static_cast<int>(i);
+		}
+	}
+
+	if (lowestSlot != -1)
+	{
+		requeueSlot(lowestSlot);
+	}
+	return lowestSlot;
+}
+
+int PathRequestService::getNextSlot() const
+{
+	int nextSlot = -1;
+	for (size_t i = 0; i < mSlots.size(); i++)
+	{
+		if (mSlots[i].active &&
+			(nextSlot == -1 || mSlots[i].priority < mSlots[nextSlot].priority ||
+			(mSlots[i].priority == mSlots[nextSlot].priority && mSlots[i].order < mSlots[nextSlot].order)))
+		{
+			nextSlot = static_cast<int>(i);
+		}
+	}
+	return nextSlot;
+}
+
+void PathRequestService::completeSearch(int slotIndex)
+{
+	SearchSlot& slot = mSlots[slotIndex];
+	slot.active = false;
+
+	bool found = slot.pSearch->getStatus() == GridAStar::SearchStatus_Found;
+	std::vector<MapCoordinate> path;
+	if (found)
+	{
+		mPathBuffer.clear();
+		slot.pSearch->getPath(&mPathBuffer);
+		path.reserve(mPathBuffer.size());
+		for (int i = 0; i < mPathBuffer.size(); i++)
+		{
+			path.push_back(mPathBuffer[i]);
+		}
+		addToCache(slot.key, slot.start, path);
+	}
+
+	// Requests from another start in the same cluster are served from the cache,
+	// if that fails they need their own search and are queued again first.
+	for (int i = static_cast<int>(slot.requests.size()) - 1; i >= 0; i--)
+	{
+		int requestId = slot.requests[i];
+		Request& request = mRequests[requestId];
+		if (request.start == slot.start)
+		{
+			request.path = path;
+			request.status = found ? RequestStatus_Found : RequestStatus_NotFound;
+		}
+		else if (!found || !serveFromCache(requestId))
+		{
+			mQueues[request.priority].push_front(requestId);
+		}
+	}
+	slot.requests.clear();
+}
+
+void PathRequestService::requeueSlot(int slotIndex)
+{
+	SearchSlot& slot = mSlots[slotIndex];
+	slot.active = false;
+
+	// Backwards so the order in the queues is kept
+	for (int i = static_cast<int>(slot.requests.size()) - 1; i >= 0; i--)
+	{
+		int requestId = slot.requests[i];
+		mQueues[mRequests[requestId].priority].push_front(requestId);
+	}
+	slot.requests.clear();
+}
\ No newline at end of file
@@ -0,0 +1,281 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Schedules path requests over several frames within a time budget. Requests are
+* served in priority order, identical requests share one search and finished
+* paths are cached so a swarm walking to the same goal only searches once.
+*/
+
+#ifndef __PATH_REQUEST_SERVICE_H__
+#define __PATH_REQUEST_SERVICE_H__
+
+#include "PathCostMap.h"
+#include "GridAStar.h"
+#include "VectorList.h"
+#include "Timer.h"
+#include <vector>
+#include <deque>
+#include <map>
+
+namespace utilities
+{
+
+/**
+* Time-sliced path request scheduler. Typical usage:
+* @code
+* int id = service.requestPath(bugPosition, wormholePosition, PathRequestService::Priority_Far);
+* // once per frame
+* service.update(2.0f);
+* if (service.getStatus(id) == PathRequestService::RequestStatus_Found)
+* {
+*	service.getPath(id, path);
+*	service.releaseRequest(id);
+* }
+* @endcode
+* Searches are resumable and are stepped until the budget of the frame is spent,
+* higher priority searches first. Requests with the same goal that start in the
+* same cluster share a search, and the result is cached under that key. A request
+* served from the cache only searches from its start to the cached path inside
+* its own cluster.
+*/
+class PathRequestService
+{
+public:
+	/** Higher priorities are searched first and may preempt lower priority searches */
+	enum Priorities
+	{
+		Priority_Boss,
+		Priority_NearPlayer,
+		Priority_Far,
+		Priority_Lim,
+	};
+
+	enum RequestStatuses
+	{
+		RequestStatus_Invalid,		/**< No request with that id */
+		RequestStatus_Pending,
+		RequestStatus_Found,
+		RequestStatus_NotFound,
+	};
+
+	/** Default number of searches that are in progress at the same time */
+	static const int CONCURRENT_SEARCHES_DEFAULT = 4;
+
+	/** Default width and height of the clusters used as cache key */
+	static const int CLUSTER_SIZE_DEFAULT = 16;
+
+	/** Default maximum number of cached paths */
+	static const int CACHE_SIZE_DEFAULT = 256;
+
+	/**
+	* Constructor
+	* @param costMap the map to search in, needs to outlive the service
+	* @param cConcurrentSearches number of searches that can be in progress at the
+	* same time, each one allocates node state for the whole map
+	* @param clusterSize width and height of the clusters used as cache key
+	* @param cacheSize maximum number of cached paths, 0 disables the cache
+	*/
+	PathRequestService(const PathCostMap& costMap, int cConcurrentSearches = CONCURRENT_SEARCHES_DEFAULT,
+		int clusterSize = CLUSTER_SIZE_DEFAULT, int cacheSize = CACHE_SIZE_DEFAULT);
+
+	/**
+	* Destructor
+	*/
+	~PathRequestService();
+
+	/**
+	* Queues a path request
+	* @param start the coordinate to start from
+	* @param goal the coordinate we want to reach
+	* @param priority the priority class of the request
+	* @return id of the request
+	*/
+	int requestPath(const MapCoordinate& start, const MapCoordinate& goal, Priorities priority);
+
+	/**
+	* Releases a request, a pending request is cancelled. The id is invalid afterwards.
+	* @param requestId id of the request
+	*/
+	void releaseRequest(int requestId);
+
+	/**
+	* Returns the status of a request
+	* @param requestId id of the request
+	* @return status of the request
+	*/
+	RequestStatuses getStatus(int requestId) const;
+
+	/**
+	* Adds the path of a finished request to path, excluding start but including goal
+	* @param requestId id of the request
+	* @param path the list to add the path to
+	* @return true if the request has found a path
+	* @throws VectorList::FullException if the path doesn't fit
+	*/
+	bool getPath(int requestId, VectorList<MapCoordinate>& path) const;
+
+	/**
+	* Serves and steps requests until the budget is spent or there are no more
+	* pending requests. Call once per frame.
+	* @param budget the time budget in milliseconds
+	*/
+	void update(float budget);
+
+	/**
+	* Removes the affected paths from the cache and restarts the searches in
+	* progress, call when the cost of a map coordinate has changed.
+	* @param cell the map coordinate that changed
+	*/
+	void onCellChanged(const MapCoordinate& cell);
+
+	/**
+	* Returns the number of requests that haven't been served yet
+	* @return number of pending requests
+	*/
+	int getPendingCount() const;
+
+private:
+	/** Number of nodes a search expands between two checks of the budget */
+	static const int SEARCH_STEP_EXPANSIONS = 128;
+
+	/** (start cluster, goal index), used both for deduplication and as cache key */
+	typedef std::pair<int, int> RequestKey;
+
+	struct Request
+	{
+		MapCoordinate start;
+		MapCoordinate goal;
+		Priorities priority;
+		RequestStatuses status;
+		std::vector<MapCoordinate> path;
+	};
+
+	/**
+	* A search in progress and the requests that wait for it
+	*/
+	struct SearchSlot
+	{
+		GridAStar* pSearch;
+		bool active;
+		Priorities priority;
+		int order;					/**< Slots with the same priority are stepped in the order they were started */
+		RequestKey key;
+		MapCoordinate start;
+		std::vector<int> requests;	/**< Requests with the same key, the first one has the same start as the search */
+	};
+
+	struct CacheEntry
+	{
+		MapCoordinate start;
+		std::vector<MapCoordinate> path;
+		unsigned int lastUsed;
+	};
+
+	/**
+	* Returns the dedup and cache key of a request
+	* @param request the request
+	* @return key of the request
+	*/
+	RequestKey getKey(const Request& request) const;
+
+	/**
+	* Returns the cluster a coordinate belongs to
+	* @param cell the map coordinate
+	* @return index of the cluster
+	*/
+	inline int getClusterIndex(const MapCoordinate& cell) const
+	{
+		return (cell.y / mClusterSize) * mcClustersX + cell.x / mClusterSize;
+	}
+
+	/**
+	* Serves queued requests from the cache, joins them to running searches
+	* with the same key and starts new searches while there are free slots.
+	* Stops when all requests have been looked at or the budget is spent, once
+	* all slots are busy only part of the budget is used so the running
+	* searches get the rest.
+	* @param budget the time budget in milliseconds
+	*/
+	void startSearches(float budget);
+
+	/**
+	* Tries to serve a request from the cache
+	* @param requestId id of the request
+	* @return true if the request was served
+	*/
+	bool serveFromCache(int requestId);
+
+	/**
+	* Adds a path to the cache, evicts the least recently used entry if it's full
+	* @param key the key of the path
+	* @param start the start of the path
+	* @param path the path, excluding start
+	*/
+	void addToCache(const RequestKey& key, const MapCoordinate& start, const std::vector<MapCoordinate>& path);
+
+	/**
+	* Returns a free slot, preempts a lower priority search if necessary
+	* @param priority the priority of the search we want to start
+	* @return index of the slot, -1 if no slot is available
+	*/
+	int getFreeSlot(Priorities priority);
+
+	/**
+	* Returns the slot to step next
+	* @return index of the slot, -1 if no search is in progress
+	*/
+	int getNextSlot() const;
+
+	/**
+	* Delivers the result of a finished search to its requests and frees the slot
+	* @param slot index of the slot
+	*/
+	void completeSearch(int slot);
+
+	/**
+	* Frees a slot and puts its requests back first in their queues
+	* @param slot index of the slot
+	*/
+	void requeueSlot(int slot);
+
+	const PathCostMap&				mCostMap;
+	int								mClusterSize;
+	int								mcClustersX;
+	int								mCacheSize;
+	unsigned int					mCacheClock;	/**< Increased for every cache access, used for LRU eviction */
+	int								mNextRequestId;
+	int								mNextSlotOrder;
+	Timer							mTimer;
+	GridAStar						mLegSearch;		/**< Searches from a start to a cached path */
+	VectorList<MapCoordinate>		mPathBuffer;
+
+	std::map<int, Request>			mRequests;
+	std::deque<int>					mQueues[Priority_Lim];
+	std::vector<SearchSlot>			mSlots;
+	std::map<RequestKey, CacheEntry> mCache;
+
+	// Not copyable
+	PathRequestService(const PathRequestService&);
+	PathRequestService& operator=(const PathRequestService&);
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,393 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Minimal perfect hash table for a static set of HashedString names, e.g. the
+* event types. Maps each name to a dense index with a few arithmetic operations
+* and one memory read.
+*/
+
+#include "PerfectHash.h"
+#include "Macros.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <cctype>
+
+using namespace utilities;
+
+namespace
+{
+/** Largest displacement, they are stored as unsigned short */
+const unsigned int DISPLACEMENT_MAX = 0xffff;
+
+/**
+* Sorts bucket indices with the largest bucket first, the large buckets are
+* the hardest to place so they are placed while most slots are free
+*/
+class BucketSizeGreater
+{
+public:
+	BucketSizeGreater(const std::vector<std::vector<int> >& buckets) : mBuckets(buckets) {}
+
+	bool operator()(int left, int right) const
+	{
+		return mBuckets[left].size() > mBuckets[right].size();
+	}
+
+private:
+	const std::vector<std::vector<int> >& mBuckets;
+
+	// Not assignable
+	BucketSizeGreater& operator=(const BucketSizeGreater&);
+};
+
+/**
+* Sorts key indices by the key
+*/
+class KeyLess
+{
+public:
+	KeyLess(const std::vector<HashedStringId>& keys) : mKeys(keys) {}
+
+	bool operator()(int left, int right) const
+	{
+		return mKeys[left] < mKeys[right];
+	}
+
+private:
+	const std::vector<HashedStringId>& mKeys;
+
+	// Not assignable
+	KeyLess& operator=(const KeyLess&);
+};
+
+/**
+* Sorts name indices by the constant name
+*/
+class ConstantNameLess
+{
+public:
+	ConstantNameLess(const std::vector<std::string>& constantNames) : mConstantNames(constantNames) {}
+
+	bool operator()(int left, int right) const
+	{
+		return mConstantNames[left] < mConstantNames[right];
+	}
+
+private:
+	const std::vector<std::string>& mConstantNames;
+
+	// Not assignable
+	ConstantNameLess& operator=(const ConstantNameLess&);
+};
+
+/**
+* Converts a name to the end of a constant name, e.g. bug_killed to BUG_KILLED
+*/
+std::string getConstantName(const char* pName)
+{
+	std::string constantName(pName);
+	for (size_t i = 0; i < constantName.size(); i++)
+	{
+		unsigned char c = static_cast<unsigned char>(constantName[i]);
+		constantName[i] = isalnum(c) && c < 128 ? static_cast<char>(toupper(c)) : '_';
+	}
+	return constantName;
+}
+
+/**
+* Escapes a name so it can be written in a string literal
+*/
+std::string getEscapedName(const char* pName)
+{
+	std::string escapedName;
+	for (const char* pChar = pName; *pChar != '\0'; pChar++)
+	{
+		if (*pChar == '"' || *pChar == '\\')
+		{
+			escapedName += '\\';
+		}
+		escapedName += *pChar;
+	}
+	return escapedName;
+}
+}
+
+PerfectHashTable::PerfectHashTable()
+{
+	mpDisplacements = NULL;
+	mpKeys = NULL;
+	mcBuckets = 0;
+	mcKeys = 0;
+	mSeed = 0;
+}
+
+PerfectHashTable::PerfectHashTable(const unsigned short* pDisplacements, int cBuckets, const HashedStringId* pKeys, int cKeys, unsigned int seed)
+{
+	mpDisplacements = pDisplacements;
+	mpKeys = pKeys;
+	mcBuckets = static_cast<unsigned int>(cBuckets);
+	mcKeys = static_cast<unsigned int>(cKeys);
+	mSeed = seed;
+}
+
+PerfectHashTable::~PerfectHashTable()
+{
+}
+
+bool PerfectHashTable::build(const HashedStringId* pKeys, int cKeys)
+{
+	mDisplacements.clear();
+	mKeys.clear();
+	mpDisplacements = NULL;
+	mpKeys = NULL;
+	mcBuckets = 0;
+	mcKeys = 0;
+	mSeed = 0;
+
+	// Equal keys would end up in the same slot
+	std::vector<HashedStringId> sortedKeys(pKeys, pKeys + cKeys);
+	std::sort(sortedKeys.begin(), sortedKeys.end());
+	if (std::adjacent_find(sortedKeys.begin(), sortedKeys.end()) != sortedKeys.end())
+	{
+		return false;
+	}
+	if (cKeys == 0)
+	{
+		return true;
+	}
+
+	mcKeys = static_cast<unsigned int>(cKeys);
+	mcBuckets = (mcKeys + BUCKET_SIZE - 1) / BUCKET_SIZE;
+	for (unsigned int attempt = 0; attempt < SEED_ATTEMPTS; attempt++)
+	{
+		if (place(pKeys, attempt * 0x9e3779b9u))
+		{
+			mpDisplacements = &mDisplacements[0];
+			mpKeys = &mKeys[0];
+			return true;
+		}
+	}
+
+	// Practically impossible with distinct 64-bit keys
+	mcKeys = 0;
+	mcBuckets = 0;
+	return false;
+}
+
+bool PerfectHashTable::place(const HashedStringId* pKeys, unsigned int seed)
+{
+	std::vector<std::vector<int> > buckets(mcBuckets);
+	for (unsigned int i = 0; i < mcKeys; i++)
+	{
+		buckets[reduce(static_cast<unsigned int>(pKeys[i]) ^ seed, mcBuckets)].push_back(i);
+	}
+
+	std::vector<int> bucketOrder(mcBuckets);
+	for (unsigned int i = 0; i < mcBuckets; i++)
+	{
+		bucketOrder[i] = i;
+	}
+	std::sort(bucketOrder.begin(), bucketOrder.end(), BucketSizeGreater(buckets));
+
+	std::vector<bool> taken(mcKeys, false);
+	std::vector<unsigned int> slots;
+	mDisplacements.assign(mcBuckets, 0);
+	mKeys.assign(mcKeys, 0);
+	for (unsigned int i = 0; i < mcBuckets; i++)
+	{
+		const std::vector<int>& bucket = buckets[bucketOrder[i]];
+		if (bucket.empty())
+		{
+			break;
+		}
+
+		// Find the first displacement that puts all keys in the bucket in
+		// different free slots
+		bool placed = false;
+		for (unsigned int displacement = 0; displacement <= DISPLACEMENT_MAX && !placed; displacement++)
+		{
+			slots.clear();
+			for (size_t k = 0; k < bucket.size(); k++)
+			{
+				unsigned int slot = reduce(mix(static_cast<unsigned int>(pKeys[bucket[k]] >> 32), displacement, seed), mcKeys);
+				if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end())
+				{
+					break;
+				}
+				slots.push_back(slot);
+			}
+
+			if (slots.size() == bucket.size())
+			{
+				for (size_t k = 0; k < bucket.size(); k++)
+				{
+					taken[slots[k]] = true;
+					mKeys[slots[k]] = pKeys[bucket[k]];
+				}
+				mDisplacements[bucketOrder[i]] = static_cast<unsigned short>(displacement);
+				placed = true;
+			}
+		}
+
+		if (!placed)
+		{
+			return false;
+		}
+	}
+
+	mSeed = seed;
+	return true;
+}
+
+bool PerfectHashTable::writeHeader(const char* const* ppNames, int cNames, const char* pTableName, const char* pFilePath)
+{
+	std::ofstream file(pFilePath);
+	if (!file.is_open())
+	{
+		ERROR_MESSAGE("PerfectHashTable: Couldn't open " << pFilePath);
+		return false;
+	}
+
+	std::string tableName(pTableName);
+	file << "// Generated by PerfectHashTable::writeHeader(), don't edit\n\n";
+	file << "#ifndef __" << tableName << "_H__\n";
+	file << "#define __" << tableName << "_H__\n\n";
+	file << "#include \"../Utilities/HashedString.h\"\n\n";
+
+	std::vector<HashedStringId> keys(cNames);
+	for (int i = 0; i < cNames; i++)
+	{
+		keys[i] = HashedString::hashName(ppNames[i]);
+	}
+
+	// Report all names with the same hash, the build fails on the #error
+	std::vector<int> keyOrder(cNames);
+	for (int i = 0; i < cNames; i++)
+	{
+		keyOrder[i] = i;
+	}
+	std::sort(keyOrder.begin(), keyOrder.end(), KeyLess(keys));
+	bool collision = false;
+	for (int i = 1; i < cNames; i++)
+	{
+		if (keys[keyOrder[i]] == keys[keyOrder[i - 1]])
+		{
+			file << "#error \"" << tableName << ": " << getEscapedName(ppNames[keyOrder[i - 1]]) << " and " <<
+				getEscapedName(ppNames[keyOrder[i]]) << " have the same hash, rename one of them\"\n";
+			ERROR_MESSAGE("PerfectHashTable: " << ppNames[keyOrder[i - 1]] << " and " << ppNames[keyOrder[i]] << " have the same hash");
+			collision = true;
+		}
+	}
+
+	// Names that only differ in characters that aren't allowed in an
+	// identifier get the same index constant, e.g. bug-killed and bug.killed
+	std::vector<std::string> constantNames(cNames);
+	for (int i = 0; i < cNames; i++)
+	{
+		constantNames[i] = getConstantName(ppNames[i]);
+	}
+	std::sort(keyOrder.begin(), keyOrder.end(), ConstantNameLess(constantNames));
+	for (int i = 1; i < cNames; i++)
+	{
+		if (constantNames[keyOrder[i]] == constantNames[keyOrder[i - 1]])
+		{
+			file << "#error \"" << tableName << ": " << getEscapedName(ppNames[keyOrder[i - 1]]) << " and " <<
+				getEscapedName(ppNames[keyOrder[i]]) << " both get the constant " << tableName << "_INDEX_" <<
+				constantNames[keyOrder[i]] << ", rename one of them\"\n";
+			ERROR_MESSAGE("PerfectHashTable: " << ppNames[keyOrder[i - 1]] << " and " << ppNames[keyOrder[i]] << " get the same index constant");
+			collision = true;
+		}
+	}
+
+	PerfectHashTable table;
+	if (!collision && (cNames == 0 || !table.build(&keys[0], cNames)))
+	{
+		file << "#error \"" << tableName << ": The table couldn't be built\"\n";
+		collision = true;
+	}
+	if (collision)
+	{
+		file << "\n#endif";
+		return false;
+	}
+
+	file << "const unsigned int " << tableName << "_SEED = " << table.mSeed << "u;\n";
+	file << "const int " << tableName << "_BUCKET_COUNT = " << table.mcBuckets << ";\n";
+	file << "const int " << tableName << "_KEY_COUNT = " << table.mcKeys << ";\n\n";
+
+	file << "const unsigned short " << tableName << "_DISPLACEMENTS[" << tableName << "_BUCKET_COUNT] =\n{\n";
+	for (unsigned int i = 0; i < table.mcBuckets; i++)
+	{
+		file << (i % 16 == 0 ? "\t" : " ") << table.mDisplacements[i] << (i + 1 < table.mcBuckets ? "," : "") << (i % 16 == 15 || i + 1 == table.mcBuckets ? "\n" : "");
+	}
+	file << "};\n\n";
+
+	// The names in index order
+	std::vector<int> nameAtIndex(cNames);
+	for (int i = 0; i < cNames; i++)
+	{
+		nameAtIndex[table.getIndex(keys[i])] = i;
+	}
+
+	file << "const utilities::HashedStringId " << tableName << "_KEYS[" << tableName << "_KEY_COUNT] =\n{\n";
+	for (int i = 0; i < cNames; i++)
+	{
+		file << "\t0x" << std::hex << std::setw(16) << std::setfill('0') << table.mKeys[i] << std::dec << std::setfill(' ') << "ULL" <<
+			(i + 1 < cNames ? "," : " ") << "\t// " << ppNames[nameAtIndex[i]] << "\n";
+	}
+	file << "};\n\n";
+
+	file << "const char* const " << tableName << "_NAMES[" << tableName << "_KEY_COUNT] =\n{\n";
+	for (int i = 0; i < cNames; i++)
+	{
+		file << "\t\"" << getEscapedName(ppNames[nameAtIndex[i]]) << "\"" << (i + 1 < cNames ? "," : "") << "\n";
+	}
+	file << "};\n\n";
+
+	for (int i = 0; i < cNames; i++)
+	{
+		file << "const int " << tableName << "_INDEX_" << constantNames[nameAtIndex[i]] << " = " << i << ";\n";
+	}
+
+	// Fails to compile if the hash function has changed since the header was
+	// generated, checked with the first name that StaticHashedString can hash
+	for (int i = 0; i < cNames; i++)
+	{
+		const char* pName = ppNames[nameAtIndex[i]];
+		size_t length = strlen(pName);
+		if (length > 0 && length <= 32)
+		{
+			file << "\n// The header needs to be generated again if the hash function has changed\n";
+			file << "typedef char " << tableName << "_HASH_CHECK[utilities::StaticHashedString<";
+			for (size_t c = 0; c < length; c++)
+			{
+				file << (c > 0 ? ", " : "") << static_cast<int>(pName[c]);
+			}
+			file << ">::value == 0x" << std::hex << std::setw(16) << std::setfill('0') << table.mKeys[i] << std::dec << "ULL ? 1 : -1];\n";
+			break;
+		}
+	}
+
+	file << "\n#endif";
+	return file.good();
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Minimal perfect hash table for a static set of HashedString names, e.g. the
+* event types. Maps each name to a dense index with a few arithmetic operations
+* and one memory read.
+*/
+
+#ifndef __PERFECT_HASH_H__
+#define __PERFECT_HASH_H__
+
+#include "HashedString.h"
+#include <vector>
+
+namespace utilities
+{
+
+/**
+* Minimal perfect hash table built with hash and displace (CHD). The keys are
+* divided into buckets of about BUCKET_SIZE keys and each bucket gets a
+* displacement that places all its keys in free slots, so n keys get the
+* indices 0 to n-1. The table is either built at startup with build() or
+* generated with writeHeader() and compiled in:
+* @code
+* #include "EventTypes.h"
+* PerfectHashTable eventTypes(EVENT_TYPES_DISPLACEMENTS, EVENT_TYPES_BUCKET_COUNT, EVENT_TYPES_KEYS, EVENT_TYPES_KEY_COUNT, EVENT_TYPES_SEED);
+* int index = eventTypes.getIndex(event.getType().getHashValue());
+* @endcode
+* The name lists, e.g. EventTypes.txt and ResourceNames.txt, are custom build
+* steps in Utilities that run HashTableGenerator, which calls writeHeader() and
+* writes the header next to the list before Utilities is compiled. The
+* generated headers are checked in. Two names with the same hash can't be
+* placed and two names that differ only in characters that can't be used in a
+* constant get the same index constant, the generator then fails the build
+* and the generated header contains an #error.
+*/
+class PerfectHashTable
+{
+public:
+	/** Returned by getIndex() when the key isn't in the table */
+	static const int NOT_FOUND = -1;
+
+	/** Average number of keys in a bucket */
+	static const int BUCKET_SIZE = 4;
+
+	/**
+	* Constructor, creates an empty table
+	*/
+	PerfectHashTable();
+
+	/**
+	* Constructor, uses a table that was generated with writeHeader(). The
+	* arrays aren't copied and need to outlive the table.
+	* @param pDisplacements the displacement of each bucket
+	* @param cBuckets number of buckets
+	* @param pKeys the key at each index
+	* @param cKeys number of keys
+	* @param seed the seed the table was built with
+	*/
+	PerfectHashTable(const unsigned short* pDisplacements, int cBuckets, const HashedStringId* pKeys, int cKeys, unsigned int seed);
+
+	/**
+	* Destructor
+	*/
+	~PerfectHashTable();
+
+	/**
+	* Builds the table from a set of keys
+	* @param pKeys the keys
+	* @param cKeys number of keys
+	* @return false if two keys are equal, the table is then empty
+	*/
+	bool build(const HashedStringId* pKeys, int cKeys);
+
+	/**
+	* Returns the index of a key
+	* @param key the key
+	* @return index of the key between 0 and getSize() - 1, NOT_FOUND if the key isn't in the table
+	*/
+	inline int getIndex(HashedStringId key) const
+	{
+		if (mcKeys == 0)
+		{
+			return NOT_FOUND;
+		}
+		int index = getIndexUnchecked(key);
+		return mpKeys[index] == key ? index : NOT_FOUND;
+	}
+
+	/**
+	* Returns the index of a key without checking that the key is in the table,
+	* only one memory read.
+	* @param key the key, needs to be in the table
+	* @return index of the key, some index if the key isn't in the table
+	*/
+	inline int getIndexUnchecked(HashedStringId key) const
+	{
+		unsigned int bucket = reduce(static_cast<unsigned int>(key) ^ mSeed, mcBuckets);
+		return static_cast<int>(reduce(mix(static_cast<unsigned int>(key >> 32), mpDisplacements[bucket], mSeed), mcKeys));
+	}
+
+	/**
+	* Returns the key at an index
+	* @param index the index, between 0 and getSize() - 1
+	* @return the key
+	*/
+	inline HashedStringId getKey(int index) const
+	{
+		return mpKeys[index];
+	}
+
+	/**
+	* Returns the number of keys
+	* @return number of keys
+	*/
+	inline int getSize() const
+	{
+		return static_cast<int>(mcKeys);
+	}
+
+	/**
+	* Hashes the names, builds a table and writes it as a header with constant
+	* arrays and one index constant per name, e.g. EVENT_TYPES_INDEX_BUG_KILLED.
+	* If two names have the same hash or the same index constant the header
+	* contains an #error instead.
+	* @param ppNames the names
+	* @param cNames number of names
+	* @param pTableName prefix of the generated constants, e.g. "EVENT_TYPES"
+	* @param pFilePath the header to write
+	* @return true if the table was written, false on a collision or if the file couldn't be written
+	*/
+	static bool writeHeader(const char* const* ppNames, int cNames, const char* pTableName, const char* pFilePath);
+
+private:
+	/** Seeds to try before giving up, a seed only fails if a bucket can't be placed */
+	static const unsigned int SEED_ATTEMPTS = 64;
+
+	/**
+	* Maps a 32-bit value to the range [0, range) without a division
+	*/
+	static inline unsigned int reduce(unsigned int value, unsigned int range)
+	{
+		return static_cast<unsigned int>((static_cast<unsigned long long>(value) * range) >> 32);
+	}
+
+	/**
+	* Mixes the high half of a key with the displacement of its bucket
+	*/
+	static inline unsigned int mix(unsigned int keyHigh, unsigned int displacement, unsigned int seed)
+	{
+		unsigned int value = keyHigh ^ seed ^ (displacement * 0x9e3779b9u);
+		value ^= value >> 16;
+		value *= 0x85ebca6bu;
+		return value ^ (value >> 13);
+	}
+
+	/**
+	* Tries to place all keys with a seed
+	* @param pKeys the keys
+	* @param seed the seed
+	* @return true if all buckets could be placed
+	*/
+	bool place(const HashedStringId* pKeys, unsigned int seed);
+
+	const unsigned short*		mpDisplacements;
+	const HashedStringId*		mpKeys;
+	unsigned int				mcBuckets;
+	unsigned int				mcKeys;
+	unsigned int				mSeed;
+	std::vector<unsigned short>	mDisplacements;	/**< Used when the table is built */
+	std::vector<HashedStringId>	mKeys;			/**< Used when the table is built */
+
+	// Not copyable
+	PerfectHashTable(const PerfectHashTable&);
+	PerfectHashTable& operator=(const PerfectHashTable&);
+};
+}
+
+#endif
\ No newline at end of file
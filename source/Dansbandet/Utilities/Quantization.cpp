@@ -0,0 +1,292 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Quantized encodings of positions, directions and map coordinates for network
+* snapshots. All encodings are written to a BitWriter and read from a BitReader,
+* both for single values and for whole entity arrays.
+*/
+
+#include "Quantization.h"
+#include "Vec3FloatArray.h"
+#include <emmintrin.h>
+#include <cmath>
+
+using namespace utilities;
+
+namespace
+{
+/** Number of bits for each size class of a map coordinate delta */
+const int DELTA_SIZE_BITS[4] = {2, 5, 10, 32};
+
+/**
+* Writes a map coordinate delta as a 2 bit size class followed by the zigzag
+* encoded delta
+* @param delta the difference from the baseline
+* @param writer the writer to write to
+*/
+void writeDelta(int delta, BitWriter& writer)
+{
+	unsigned int value = encodeZigZag(delta);
+	int sizeClass = 0;
+	while (sizeClass < 3 && value >= (1u << DELTA_SIZE_BITS[sizeClass]))
+	{
+		sizeClass++;
+	}
+	writer.write(sizeClass, 2);
+	writer.write(value, DELTA_SIZE_BITS[sizeClass]);
+}
+
+/**
+* Reads a delta written with writeDelta()
+* @param reader the reader to read from
+* @return the difference from the baseline
+*/
+int readDelta(BitReader& reader)
+{
+	int sizeClass = reader.read(2);
+	return decodeZigZag(reader.read(DELTA_SIZE_BITS[sizeClass]));
+}
+
+/**
+* Returns -1.0f for negative values and 1.0f otherwise
+*/
+inline float getSign(float value)
+{
+	return value < 0.0f ? -1.0f : 1.0f;
+}
+}
+
+PositionQuantizer::PositionQuantizer(int mapWidth, int mapHeight, float minY, float maxY, int cBitsY)
+{
+	mcBitsY = cBitsY;
+	mMaxStepXZ = static_cast<float>((1 << BITS_XZ) - 1);
+	mMaxStepY = static_cast<float>((1 << cBitsY) - 1);
+
+	mMin = Vec3Float(0.0f, minY, 0.0f);
+	mScale.x = mMaxStepXZ / (mapWidth * MAP_IN_WORLD_COORDS);
+	mScale.y = maxY > minY ? mMaxStepY / (maxY - minY) : 0.0f;
+	mScale.z = mMaxStepXZ / (mapHeight * MAP_IN_WORLD_COORDS);
+	mStep.x = 1.0f / mScale.x;
+	mStep.y = maxY > minY ? 1.0f / mScale.y : 0.0f;
+	mStep.z = 1.0f / mScale.z;
+}
+
+PositionQuantizer::~PositionQuantizer()
+{
+}
+
+unsigned int PositionQuantizer::quantize(float value, float min, float scale, float maxStep)
+{
+	float step = (value - min) * scale;
+	if (step < 0.0f)
+	{
+		step = 0.0f;
+	}
+	else if (step > maxStep)
+	{
+		step = maxStep;
+	}
+	return static_cast<unsigned int>(step + 0.5f);
+}
+
+void PositionQuantizer::encode(const Vec3Float& position, BitWriter& writer) const
+{
+	writer.write(quantize(position.x, mMin.x, mScale.x, mMaxStepXZ), BITS_XZ);
+	writer.write(quantize(position.z, mMin.z, mScale.z, mMaxStepXZ), BITS_XZ);
+	writer.write(quantize(position.y, mMin.y, mScale.y, mMaxStepY), mcBitsY);
+}
+
+Vec3Float PositionQuantizer::decode(BitReader& reader) const
+{
+	Vec3Float position;
+	position.x = mMin.x + reader.read(BITS_XZ) * mStep.x;
+	position.z = mMin.z + reader.read(BITS_XZ) * mStep.z;
+	position.y = mMin.y + reader.read(mcBitsY) * mStep.y;
+	return position;
+}
+
+void PositionQuantizer::encode(const Vec3FloatArray& positions, BitWriter& writer) const
+{
+	const float* pX = positions.getX();
+	const float* pY = positions.getY();
+	const float* pZ = positions.getZ();
+	int cPositions = positions.size();
+	int cBatched = cPositions & ~3;
+
+	// Same clamping and rounding as quantize(), the values are never negative
+	// after the clamping so truncating value + 0.5 rounds to nearest.
+	__m128 zero = _mm_setzero_ps();
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128 maxStepXZ = _mm_set1_ps(mMaxStepXZ);
+	__m128 maxStepY = _mm_set1_ps(mMaxStepY);
+	__m128 minX = _mm_set1_ps(mMin.x);
+	__m128 minY = _mm_set1_ps(mMin.y);
+	__m128 minZ = _mm_set1_ps(mMin.z);
+	__m128 scaleX = _mm_set1_ps(mScale.x);
+	__m128 scaleY = _mm_set1_ps(mScale.y);
+	__m128 scaleZ = _mm_set1_ps(mScale.z);
+	__declspec(align(16)) int stepsX[4];
+	__declspec(align(16)) int stepsY[4];
+	__declspec(align(16)) int stepsZ[4];
+
+	for (int i = 0; i < cBatched; i += 4)
+	{
+		__m128 x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(pX + i), minX), scaleX);
+		__m128 y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(pY + i), minY), scaleY);
+		__m128 z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(pZ + i), minZ), scaleZ);
+		x = _mm_min_ps(_mm_max_ps(x, zero), maxStepXZ);
+		y = _mm_min_ps(_mm_max_ps(y, zero), maxStepY);
+		z = _mm_min_ps(_mm_max_ps(z, zero), maxStepXZ);
+		_mm_store_si128(reinterpret_cast<__m128i*>(stepsX), _mm_cvttps_epi32(_mm_add_ps(x, half)));
+		_mm_store_si128(reinterpret_cast<__m128i*>(stepsY), _mm_cvttps_epi32(_mm_add_ps(y, half)));
+		_mm_store_si128(reinterpret_cast<__m128i*>(stepsZ), _mm_cvttps_epi32(_mm_add_ps(z, half)));
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			writer.write(stepsX[lane], BITS_XZ);
+			writer.write(stepsZ[lane], BITS_XZ);
+			writer.write(stepsY[lane], mcBitsY);
+		}
+	}
+
+	for (int i = cBatched; i < cPositions; i++)
+	{
+		encode(Vec3Float(pX[i], pY[i], pZ[i]), writer);
+	}
+}
+
+void PositionQuantizer::decode(BitReader& reader, int cPositions, Vec3FloatArray& positions) const
+{
+	positions.resize(cPositions);
+	float* pX = positions.getX();
+	float* pY = positions.getY();
+	float* pZ = positions.getZ();
+
+	for (int i = 0; i < cPositions; i++)
+	{
+		pX[i] = mMin.x + reader.read(BITS_XZ) * mStep.x;
+		pZ[i] = mMin.z + reader.read(BITS_XZ) * mStep.z;
+		pY[i] = mMin.y + reader.read(mcBitsY) * mStep.y;
+	}
+}
+
+Vec3Float PositionQuantizer::getMaxError() const
+{
+	return mStep * 0.5f;
+}
+
+unsigned int utilities::encodeDirection(const Vec3Float& direction, int cBitsPerAxis)
+{
+	float sum = fabsf(direction.x) + fabsf(direction.y) + fabsf(direction.z);
+	float u = 0.0f;
+	float v = 0.0f;
+	if (sum > 0.0f)
+	{
+		u = direction.x / sum;
+		v = direction.z / sum;
+
+		// Fold the lower half of the octahedron over the upper half
+		if (direction.y < 0.0f)
+		{
+			float foldedU = (1.0f - fabsf(v)) * getSign(u);
+			v = (1.0f - fabsf(u)) * getSign(v);
+			u = foldedU;
+		}
+	}
+
+	// -1, 0 and 1 map to 0, half and 2 * half so the axes are exact
+	int half = (1 << (cBitsPerAxis - 1)) - 1;
+	unsigned int stepU = static_cast<unsigned int>(floorf(u * half + 0.5f) + half);
+	unsigned int stepV = static_cast<unsigned int>(floorf(v * half + 0.5f) + half);
+	return stepU | (stepV << cBitsPerAxis);
+}
+
+Vec3Float utilities::decodeDirection(unsigned int code, int cBitsPerAxis)
+{
+	int half = (1 << (cBitsPerAxis - 1)) - 1;
+	unsigned int mask = (1u << cBitsPerAxis) - 1;
+	float u = static_cast<float>(static_cast<int>(code & mask) - half) / half;
+	float v = static_cast<float>(static_cast<int>((code >> cBitsPerAxis) & mask) - half) / half;
+
+	Vec3Float direction(u, 1.0f - fabsf(u) - fabsf(v), v);
+	if (direction.y < 0.0f)
+	{
+		direction.x = (1.0f - fabsf(v)) * getSign(u);
+		direction.z = (1.0f - fabsf(u)) * getSign(v);
+	}
+	direction.normalize();
+	return direction;
+}
+
+void utilities::encodeDirections(const Vec3FloatArray& directions, BitWriter& writer, int cBitsPerAxis)
+{
+	const float* pX = directions.getX();
+	const float* pY = directions.getY();
+	const float* pZ = directions.getZ();
+	for (int i = 0; i < directions.size(); i++)
+	{
+		writer.write(encodeDirection(Vec3Float(pX[i], pY[i], pZ[i]), cBitsPerAxis), cBitsPerAxis * 2);
+	}
+}
+
+void utilities::decodeDirections(BitReader& reader, int cDirections, Vec3FloatArray& directions, int cBitsPerAxis)
+{
+	directions.resize(cDirections);
+	float* pX = directions.getX();
+	float* pY = directions.getY();
+	float* pZ = directions.getZ();
+	for (int i = 0; i < cDirections; i++)
+	{
+		Vec3Float direction = decodeDirection(reader.read(cBitsPerAxis * 2), cBitsPerAxis);
+		pX[i] = direction.x;
+		pY[i] = direction.y;
+		pZ[i] = direction.z;
+	}
+}
+
+void utilities::encodeMapCoordinateDeltas(const MapCoordinate* pMapCoordinates, const MapCoordinate* pBaseline, int cMapCoordinates, BitWriter& writer)
+{
+	for (int i = 0; i < cMapCoordinates; i++)
+	{
+		int deltaX = pMapCoordinates[i].x - pBaseline[i].x;
+		int deltaY = pMapCoordinates[i].y - pBaseline[i].y;
+		bool changed = deltaX != 0 || deltaY != 0;
+		writer.writeBool(changed);
+		if (changed)
+		{
+			writeDelta(deltaX, writer);
+			writeDelta(deltaY, writer);
+		}
+	}
+}
+
+void utilities::decodeMapCoordinateDeltas(BitReader& reader, const MapCoordinate* pBaseline, int cMapCoordinates, MapCoordinate* pMapCoordinates)
+{
+	for (int i = 0; i < cMapCoordinates; i++)
+	{
+		pMapCoordinates[i] = pBaseline[i];
+		if (reader.readBool())
+		{
+			pMapCoordinates[i].x += readDelta(reader);
+			pMapCoordinates[i].y += readDelta(reader);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,223 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Quantized encodings of positions, directions and map coordinates for network
+* snapshots. All encodings are written to a BitWriter and read from a BitReader,
+* both for single values and for whole entity arrays.
+*/
+
+#ifndef __QUANTIZATION_H__
+#define __QUANTIZATION_H__
+
+#include "Vectors.h"
+#include "BitStream.h"
+
+namespace utilities
+{
+
+class Vec3FloatArray;
+
+/**
+* Quantizes world positions relative to the map. x and z are stored with 16
+* bits each over the whole map and y with a configurable number of bits over a
+* height range. Positions outside the map or the height range are clamped.
+* The error of a decoded position is at most half a step on each axis, see
+* getMaxError(). On a 256x256 map the step is 3840/65535 = 0.059 world units.
+*/
+class PositionQuantizer
+{
+public:
+	/** Number of bits used for the x- and z-value */
+	static const int BITS_XZ = 16;
+
+	/** The default number of bits used for the y-value */
+	static const int BITS_Y_DEFAULT = 10;
+
+	/**
+	* Constructor
+	* @param mapWidth width of the map in map coordinates
+	* @param mapHeight height of the map in map coordinates
+	* @param minY the lowest y-value that can be encoded
+	* @param maxY the highest y-value that can be encoded
+	* @param cBitsY number of bits for the y-value, 1 to 16
+	*/
+	PositionQuantizer(int mapWidth, int mapHeight, float minY, float maxY, int cBitsY = BITS_Y_DEFAULT);
+
+	/**
+	* Destructor
+	*/
+	~PositionQuantizer();
+
+	/**
+	* Encodes a position
+	* @param position the position in world coordinates
+	* @param writer the writer to write the position to
+	*/
+	void encode(const Vec3Float& position, BitWriter& writer) const;
+
+	/**
+	* Decodes a position
+	* @param reader the reader to read the position from
+	* @return the decoded position
+	* @throws BitReader::EndOfDataException if the data ends
+	*/
+	Vec3Float decode(BitReader& reader) const;
+
+	/**
+	* Encodes all positions of an array, four positions are quantized at a time
+	* with SSE. The result is identical to calling encode() for each position.
+	* @param positions the positions in world coordinates
+	* @param writer the writer to write the positions to
+	*/
+	void encode(const Vec3FloatArray& positions, BitWriter& writer) const;
+
+	/**
+	* Decodes positions encoded with encode(const Vec3FloatArray&, BitWriter&)
+	* @param reader the reader to read the positions from
+	* @param cPositions number of positions to read
+	* @param positions resized to cPositions and filled with the decoded positions
+	* @throws BitReader::EndOfDataException if the data ends
+	*/
+	void decode(BitReader& reader, int cPositions, Vec3FloatArray& positions) const;
+
+	/**
+	* Returns the largest error of a decoded position on each axis, i.e. half
+	* a step. Positions outside the map or the height range can have a larger
+	* error since they are clamped.
+	* @return the largest error of x, y and z
+	*/
+	Vec3Float getMaxError() const;
+
+	/**
+	* Returns the number of bits an encoded position uses
+	* @return number of bits per position
+	*/
+	inline int getBitsPerPosition() const
+	{
+		return BITS_XZ * 2 + mcBitsY;
+	}
+
+private:
+	/**
+	* Quantizes a value
+	* @param value the value to quantize
+	* @param min the lowest value that can be encoded
+	* @param scale number of steps per unit
+	* @param maxStep the largest step
+	* @return the quantized value
+	*/
+	static unsigned int quantize(float value, float min, float scale, float maxStep);
+
+	Vec3Float	mMin;
+	Vec3Float	mScale;		/**< Number of steps per world unit */
+	Vec3Float	mStep;		/**< World units per step */
+	int			mcBitsY;
+	float		mMaxStepXZ;
+	float		mMaxStepY;
+};
+
+/** The default number of bits per axis for the octahedral direction encoding */
+const int DIRECTION_BITS_DEFAULT = 8;
+
+/**
+* Encodes a direction with octahedral encoding, i.e. the unit sphere is
+* projected onto an octahedron which is unfolded into a square with two
+* cBitsPerAxis-bit axes. Directions along the x-, y- and z-axes are exact.
+* The angular error is below 1 degree with 8 bits per axis, 0.25 degrees
+* with 10 and 0.07 degrees with 12. The direction doesn't have to be
+* normalized, the zero vector is decoded as (0, 1, 0).
+* @param direction the direction to encode
+* @param cBitsPerAxis number of bits for each axis, 2 to 16
+* @return the code, 2 * cBitsPerAxis bits
+*/
+unsigned int encodeDirection(const Vec3Float& direction, int cBitsPerAxis = DIRECTION_BITS_DEFAULT);
+
+/**
+* Decodes a direction encoded with encodeDirection()
+* @param code the code
+* @param cBitsPerAxis the number of bits per axis the direction was encoded with
+* @return the normalized direction
+*/
+Vec3Float decodeDirection(unsigned int code, int cBitsPerAxis = DIRECTION_BITS_DEFAULT);
+
+/**
+* Encodes all directions of an array, see encodeDirection()
+* @param directions the directions to encode
+* @param writer the writer to write the directions to
+* @param cBitsPerAxis number of bits for each axis, 2 to 16
+*/
+void encodeDirections(const Vec3FloatArray& directions, BitWriter& writer, int cBitsPerAxis = DIRECTION_BITS_DEFAULT);
+
+/**
+* Decodes directions encoded with encodeDirections()
+* @param reader the reader to read the directions from
+* @param cDirections number of directions to read
+* @param directions resized to cDirections and filled with the normalized directions
+* @param cBitsPerAxis the number of bits per axis the directions were encoded with
+* @throws BitReader::EndOfDataException if the data ends
+*/
+void decodeDirections(BitReader& reader, int cDirections, Vec3FloatArray& directions, int cBitsPerAxis = DIRECTION_BITS_DEFAULT);
+
+/**
+* Maps a signed value to an unsigned value so values close to 0 get few
+* significant bits: 0, -1, 1, -2, 2... becomes 0, 1, 2, 3, 4...
+* @param value the signed value
+* @return the unsigned value
+*/
+inline unsigned int encodeZigZag(int value)
+{
+	return (static_cast<unsigned int>(value) << 1) ^ static_cast<unsigned int>(value >> 31);
+}
+
+/**
+* Reverses encodeZigZag()
+* @param value the unsigned value
+* @return the signed value
+*/
+inline int decodeZigZag(unsigned int value)
+{
+	return static_cast<int>((value >> 1) ^ (0u - (value & 1)));
+}
+
+/**
+* Encodes map coordinates as the difference from a baseline, e.g. the map
+* coordinates in the last snapshot the receiver acknowledged. The encoding is
+* lossless, an unchanged coordinate takes 1 bit and a coordinate that moved
+* one step 9 bits.
+* @param pMapCoordinates the map coordinates to encode
+* @param pBaseline the baseline map coordinates, the receiver needs the same baseline
+* @param cMapCoordinates number of map coordinates in both arrays
+* @param writer the writer to write the map coordinates to
+*/
+void encodeMapCoordinateDeltas(const MapCoordinate* pMapCoordinates, const MapCoordinate* pBaseline, int cMapCoordinates, BitWriter& writer);
+
+/**
+* Decodes map coordinates encoded with encodeMapCoordinateDeltas()
+* @param reader the reader to read the map coordinates from
+* @param pBaseline the baseline map coordinates that were used when encoding
+* @param cMapCoordinates number of map coordinates in both arrays
+* @param pMapCoordinates array with room for cMapCoordinates map coordinates
+* @throws BitReader::EndOfDataException if the data ends
+*/
+void decodeMapCoordinateDeltas(BitReader& reader, const MapCoordinate* pBaseline, int cMapCoordinates, MapCoordinate* pMapCoordinates);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,50 @@
+// Generated by PerfectHashTable::writeHeader(), don't edit
+
+#ifndef __RESOURCE_NAMES_H__
+#define __RESOURCE_NAMES_H__
+
+#include "../Utilities/HashedString.h"
+
+const unsigned int RESOURCE_NAMES_SEED = 0u;
+const int RESOURCE_NAMES_BUCKET_COUNT = 2;
+const int RESOURCE_NAMES_KEY_COUNT = 7;
+
+const unsigned short RESOURCE_NAMES_DISPLACEMENTS[RESOURCE_NAMES_BUCKET_COUNT] =
+{
+	12, 45
+};
+
+const utilities::HashedStringId RESOURCE_NAMES_KEYS[RESOURCE_NAMES_KEY_COUNT] =
+{
+	0x506c029deb498757ULL,	// RenderQueue
+	0xad367fd2f5e58997ULL,	// Paths
+	0x155d11ccd01c184cULL,	// Agents
+	0x164504f3ba0ba98dULL,	// Sound
+	0x148df21758ceb8a4ULL,	// Orders
+	0x79de6e94d0d3e3f4ULL,	// World
+	0xb4bee5c8e0a8073fULL 	// Network
+};
+
+const char* const RESOURCE_NAMES_NAMES[RESOURCE_NAMES_KEY_COUNT] =
+{
+	"RenderQueue",
+	"Paths",
+	"Agents",
+	"Sound",
+	"Orders",
+	"World",
+	"Network"
+};
+
+const int RESOURCE_NAMES_INDEX_RENDERQUEUE = 0;
+const int RESOURCE_NAMES_INDEX_PATHS = 1;
+const int RESOURCE_NAMES_INDEX_AGENTS = 2;
+const int RESOURCE_NAMES_INDEX_SOUND = 3;
+const int RESOURCE_NAMES_INDEX_ORDERS = 4;
+const int RESOURCE_NAMES_INDEX_WORLD = 5;
+const int RESOURCE_NAMES_INDEX_NETWORK = 6;
+
+// The header needs to be generated again if the hash function has changed
+typedef char RESOURCE_NAMES_HASH_CHECK[utilities::StaticHashedString<82, 101, 110, 100, 101, 114, 81, 117, 101, 117, 101>::value == 0x506c029deb498757ULL ? 1 : -1];
+
+#endif
\ No newline at end of file
@@ -0,0 +1,180 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Lightweight semaphore and auto-reset event. Signalling and waiting stay in user
+* space when nobody has to block, only blocked waiters use a kernel semaphore.
+*/
+
+#include "Semaphore.h"
+#include <climits>
+#include <windows.h>
+#include <emmintrin.h>
+
+using namespace utilities;
+
+Semaphore::Semaphore(int initialCount)
+{
+	mCount = initialCount;
+	mHandle = CreateSemaphoreA(NULL, 0, LONG_MAX, NULL);
+}
+
+Semaphore::~Semaphore()
+{
+	CloseHandle(mHandle);
+}
+
+void Semaphore::post(int count)
+{
+	// Only the blocked threads need the kernel, the rest just take the count
+	long cBlocked = -InterlockedExchangeAdd(&mCount, count);
+	if (cBlocked > 0)
+	{
+		ReleaseSemaphore(mHandle, cBlocked < count ? cBlocked : count, NULL);
+	}
+}
+
+void Semaphore::wait()
+{
+	wait(WAIT_INFINITE);
+}
+
+bool Semaphore::wait(int timeout)
+{
+	if (timeout == 0)
+	{
+		return tryWait();
+	}
+
+	for (int i = 0; i < SPIN_COUNT; i++)
+	{
+		if (tryWait())
+		{
+			return true;
+		}
+		_mm_pause();
+	}
+
+	if (InterlockedDecrement(&mCount) >= 0)
+	{
+		return true;
+	}
+	return waitBlocking(timeout);
+}
+
+bool Semaphore::tryWait()
+{
+	long count = mCount;
+	while (count > 0)
+	{
+		long previous = InterlockedCompareExchange(&mCount, count - 1, count);
+		if (previous == count)
+		{
+			return true;
+		}
+		count = previous;
+	}
+	return false;
+}
+
+bool Semaphore::waitBlocking(int timeout)
+{
+	DWORD milliseconds = timeout == WAIT_INFINITE ? INFINITE : static_cast<DWORD>(timeout);
+	if (WaitForSingleObject(mHandle, milliseconds) == WAIT_OBJECT_0)
+	{
+		return true;
+	}
+
+	// Timed out, stop being counted as blocked. If a post() already counted
+	// us it has released the kernel semaphore once for us, which we consume.
+	long count = mCount;
+	while (count < 0)
+	{
+		long previous = InterlockedCompareExchange(&mCount, count + 1, count);
+		if (previous == count)
+		{
+			return false;
+		}
+		count = previous;
+	}
+	WaitForSingleObject(mHandle, INFINITE);
+	return true;
+}
+
+AutoResetEvent::AutoResetEvent(bool set)
+{
+	mStatus = set ? 1 : 0;
+}
+
+AutoResetEvent::~AutoResetEvent()
+{
+}
+
+void AutoResetEvent::set()
+{
+	// Increase the status by one but never above 1
+	long status = mStatus;
+	for (;;)
+	{
+		long newStatus = status < 1 ? status + 1 : 1;
+		long previous = InterlockedCompareExchange(&mStatus, newStatus, status);
+		if (previous == status)
+		{
+			break;
+		}
+		status = previous;
+	}
+
+	if (status < 0)
+	{
+		mSemaphore.post();
+	}
+}
+
+void AutoResetEvent::wait()
+{
+	wait(WAIT_INFINITE);
+}
+
+bool AutoResetEvent::wait(int timeout)
+{
+	if (InterlockedDecrement(&mStatus) >= 0)
+	{
+		return true;
+	}
+	if (mSemaphore.wait(timeout))
+	{
+		return true;
+	}
+
+	// Timed out, stop waiting unless a set() already counted us
+	long status = mStatus;
+	while (status < 0)
+	{
+		long previous = InterlockedCompareExchange(&mStatus, status + 1, status);
+		if (previous == status)
+		{
+			return false;
+		}
+		status = previous;
+	}
+	mSemaphore.wait();
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Lightweight semaphore and auto-reset event. Signalling and waiting stay in user
+* space when nobody has to block, only blocked waiters use a kernel semaphore.
+*/
+
+#ifndef __SEMAPHORE_H__
+#define __SEMAPHORE_H__
+
+namespace utilities
+{
+
+/** Timeout that waits until signalled */
+const int WAIT_INFINITE = -1;
+
+/**
+* A counting semaphore that works like a futex: the count is an atomic in user
+* space and the kernel is only involved when a thread actually has to block or
+* be woken. A waiter spins shortly before it blocks, so a wakeup that comes
+* right away doesn't cost a context switch.
+*/
+class Semaphore
+{
+public:
+	/**
+	* Constructor
+	* @param initialCount the initial count
+	*/
+	Semaphore(int initialCount = 0);
+
+	/**
+	* Destructor, no thread may wait on the semaphore
+	*/
+	~Semaphore();
+
+	/**
+	* Increases the count and wakes up to count blocked threads
+	* @param count how much to increase the count with
+	*/
+	void post(int count = 1);
+
+	/**
+	* Decreases the count, waits until it's positive first
+	*/
+	void wait();
+
+	/**
+	* Decreases the count if it's positive within the timeout
+	* @param timeout milliseconds to wait, WAIT_INFINITE to wait until posted
+	* @return true if the count was decreased, false if the timeout expired
+	*/
+	bool wait(int timeout);
+
+	/**
+	* Decreases the count if it's positive, never waits
+	* @return true if the count was decreased
+	*/
+	bool tryWait();
+
+private:
+	/** Number of times a waiter tries again before it blocks */
+	static const int SPIN_COUNT = 1000;
+
+	/**
+	* Waits for the kernel semaphore after the count has been decreased below 0
+	* @param timeout milliseconds to wait, WAIT_INFINITE to wait until posted
+	* @return true if we were woken, false if the timeout expired
+	*/
+	bool waitBlocking(int timeout);
+
+	volatile long	mCount;		/**< The count, negative when threads are blocked */
+	void*			mHandle;	/**< The kernel semaphore the blocked threads wait on */
+
+	// Not copyable
+	Semaphore(const Semaphore&);
+	Semaphore& operator=(const Semaphore&);
+};
+
+/**
+* An event that wakes one waiting thread each time it's set. Setting an event
+* that is already set does nothing, i.e. several set() without a waiter in
+* between only wake one wait().
+*/
+class AutoResetEvent
+{
+public:
+	/**
+	* Constructor
+	* @param set if the event is set from the beginning
+	*/
+	AutoResetEvent(bool set = false);
+
+	/**
+	* Destructor, no thread may wait on the event
+	*/
+	~AutoResetEvent();
+
+	/**
+	* Sets the event, wakes a waiting thread if there is one
+	*/
+	void set();
+
+	/**
+	* Waits until the event is set and resets it
+	*/
+	void wait();
+
+	/**
+	* Waits until the event is set and resets it
+	* @param timeout milliseconds to wait, WAIT_INFINITE to wait until set
+	* @return true if the event was set, false if the timeout expired
+	*/
+	bool wait(int timeout);
+
+private:
+	volatile long	mStatus;	/**< 1 when set, 0 when not set and -N when N threads wait */
+	Semaphore		mSemaphore;
+
+	// Not copyable
+	AutoResetEvent(const AutoResetEvent&);
+	AutoResetEvent& operator=(const AutoResetEvent&);
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,247 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* A uniform grid with one bucket per map coordinate for neighbour queries, e.g.
+* finding the nearest target or the bugs close to another bug.
+*/
+
+#include "SpatialGrid.h"
+#include "CoordinateConversion.h"
+#include "ParallelFor.h"
+
+using namespace utilities;
+
+SpatialGrid::SpanIterator::SpanIterator(const int* pCellStarts, int width, int minX, int minY, int maxX, int maxY)
+{
+	mpCellStarts = pCellStarts;
+	mWidth = width;
+	mMinX = minX;
+	mMaxX = maxX;
+	mY = minY;
+	mMaxY = maxY;
+}
+
+bool SpatialGrid::SpanIterator::next(int& begin, int& end)
+{
+	while (mY <= mMaxY)
+	{
+		int rowBegin = mpCellStarts[mY * mWidth + mMinX];
+		int rowEnd = mpCellStarts[mY * mWidth + mMaxX + 1];
+		mY++;
+		if (rowBegin != rowEnd)
+		{
+			begin = rowBegin;
+			end = rowEnd;
+			return true;
+		}
+	}
+	return false;
+}
+
+SpatialGrid::SpatialGrid(int mapWidth, int mapHeight)
+{
+	mWidth = mapWidth;
+	mHeight = mapHeight;
+	mcCells = mapWidth * mapHeight;
+	mCellStarts.resize(mcCells + 1, 0);
+	mpJobSystem = NULL;
+}
+
+SpatialGrid::~SpatialGrid()
+{
+}
+
+void SpatialGrid::rebuild(const Vec3FloatArray& positions)
+{
+	rebuild(positions, NULL);
+}
+
+void SpatialGrid::rebuild(const Vec3FloatArray& positions, const int* pHandles)
+{
+	int cEntities = positions.size();
+	mEntityCells.resize(cEntities);
+	mMapCoordinates.resize(cEntities);
+	mHandles.resize(cEntities);
+	mPositions.resize(cEntities);
+
+	int cChunks = 1;
+	if (mpJobSystem != NULL)
+	{
+		cChunks = (std::min)(mpJobSystem->getThreadCount(), cEntities / REBUILD_CHUNK_SIZE_MIN);
+		if (cChunks < 1)
+		{
+			cChunks = 1;
+		}
+	}
+	mChunkOffsets.assign(cChunks * mcCells, 0);
+
+	// The chunks only depend on the chunk index and not on which thread runs
+	// them, the result is thus the same as a sequential counting sort.
+	CountChunks countChunks = {this, cChunks, &positions};
+	parallelFor(mpJobSystem, 0, cChunks, 1, countChunks);
+
+	calculateOffsets(cChunks);
+
+	ScatterChunks scatterChunks = {this, cChunks, &positions, pHandles};
+	parallelFor(mpJobSystem, 0, cChunks, 1, scatterChunks);
+}
+
+void SpatialGrid::CountChunks::operator()(int begin, int end) const
+{
+	for (int chunk = begin; chunk < end; chunk++)
+	{
+		pGrid->countChunk(chunk, cChunks, *pPositions);
+	}
+}
+
+void SpatialGrid::ScatterChunks::operator()(int begin, int end) const
+{
+	for (int chunk = begin; chunk < end; chunk++)
+	{
+		pGrid->scatterChunk(chunk, cChunks, *pPositions, pHandles);
+	}
+}
+
+void SpatialGrid::countChunk(int chunk, int cChunks, const Vec3FloatArray& positions)
+{
+	int begin = static_cast<int>(static_cast<long long>(positions.size()) * chunk / cChunks);
+	int end = static_cast<int>(static_cast<long long>(positions.size()) * (chunk + 1) / cChunks);
+	if (begin == end)
+	{
+		return;
+	}
+
+	convertToMapCoordinates(positions.getX() + begin, positions.getZ() + begin, end - begin, &mMapCoordinates[begin]);
+
+	int* pCounts = &mChunkOffsets[chunk * mcCells];
+	for (int i = begin; i < end; i++)
+	{
+		int cell = getCellIndex(mMapCoordinates[i]);
+		mEntityCells[i] = cell;
+		pCounts[cell]++;
+	}
+}
+
+void SpatialGrid::calculateOffsets(int cChunks)
+{
+	int offset = 0;
+	for (int cell = 0; cell < mcCells; cell++)
+	{
+		mCellStarts[cell] = offset;
+		for (int chunk = 0; chunk < cChunks; chunk++)
+		{
+			int& chunkOffset = mChunkOffsets[chunk * mcCells + cell];
+			int count = chunkOffset;
+			chunkOffset = offset;
+			offset += count;
+		}
+	}
+	mCellStarts[mcCells] = offset;
+}
+
+void SpatialGrid::scatterChunk(int chunk, int cChunks, const Vec3FloatArray& positions, const int* pHandles)
+{
+	int begin = static_cast<int>(static_cast<long long>(positions.size()) * chunk / cChunks);
+	int end = static_cast<int>(static_cast<long long>(positions.size()) * (chunk + 1) / cChunks);
+
+	const float* pX = positions.getX();
+	const float* pY = positions.getY();
+	const float* pZ = positions.getZ();
+	float* pSortedX = mPositions.getX();
+	float* pSortedY = mPositions.getY();
+	float* pSortedZ = mPositions.getZ();
+	int* pOffsets = &mChunkOffsets[chunk * mcCells];
+
+	for (int i = begin; i < end; i++)
+	{
+		int sortedIndex = pOffsets[mEntityCells[i]]++;
+		mHandles[sortedIndex] = pHandles != NULL ? pHandles[i] : i;
+		pSortedX[sortedIndex] = pX[i];
+		pSortedY[sortedIndex] = pY[i];
+		pSortedZ[sortedIndex] = pZ[i];
+	}
+}
+
+SpatialGrid::SpanIterator SpatialGrid::queryRectangle(const MapCoordinate& min, const MapCoordinate& max) const
+{
+	if (min.x > max.x || min.y > max.y)
+	{
+		// Empty iterator
+		return SpanIterator(&mCellStarts[0], mWidth, 0, 0, 0, -1);
+	}
+
+	// Clamp instead of rejecting rectangles outside the map, like queryRadius()
+	return SpanIterator(&mCellStarts[0], mWidth, clampX(min.x), clampY(min.y), clampX(max.x), clampY(max.y));
+}
+
+SpatialGrid::SpanIterator SpatialGrid::queryRadius(const Vec3Float& center, float radius) const
+{
+	// Clamp instead of rejecting so entities clamped to the edge cells are found
+	MapCoordinate minCell(convertToMapCoordinate(center.x - radius), convertToMapCoordinate(center.z - radius));
+	MapCoordinate maxCell(convertToMapCoordinate(center.x + radius), convertToMapCoordinate(center.z + radius));
+	return SpanIterator(&mCellStarts[0], mWidth, clampX(minCell.x), clampY(minCell.y), clampX(maxCell.x), clampY(maxCell.y));
+}
+
+int SpatialGrid::gatherRadius(const Vec3Float& center, float radius, std::vector<int>& handles, Vec3FloatArray& positions) const
+{
+	handles.clear();
+
+	// Reserve room for all candidates so the lanes can be written directly
+	int cCandidates = 0;
+	int begin = 0;
+	int end = 0;
+	SpanIterator countIt = queryRadius(center, radius);
+	while (countIt.next(begin, end))
+	{
+		cCandidates += end - begin;
+	}
+	positions.resize(cCandidates);
+
+	const float* pX = mPositions.getX();
+	const float* pY = mPositions.getY();
+	const float* pZ = mPositions.getZ();
+	float* pOutX = positions.getX();
+	float* pOutY = positions.getY();
+	float* pOutZ = positions.getZ();
+	float radiusSquared = radius * radius;
+	int cFound = 0;
+
+	SpanIterator it = queryRadius(center, radius);
+	while (it.next(begin, end))
+	{
+		for (int i = begin; i < end; i++)
+		{
+			float diffX = pX[i] - center.x;
+			float diffZ = pZ[i] - center.z;
+			if (diffX * diffX + diffZ * diffZ <= radiusSquared)
+			{
+				handles.push_back(mHandles[i]);
+				pOutX[cFound] = pX[i];
+				pOutY[cFound] = pY[i];
+				pOutZ[cFound] = pZ[i];
+				cFound++;
+			}
+		}
+	}
+
+	positions.resize(cFound);
+	return cFound;
+}
\ No newline at end of file
@@ -0,0 +1,347 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* A uniform grid with one bucket per map coordinate for neighbour queries, e.g.
+* finding the nearest target or the bugs close to another bug.
+*/
+
+#ifndef __SPATIAL_GRID_H__
+#define __SPATIAL_GRID_H__
+
+#include "Vectors.h"
+#include "Vec3FloatArray.h"
+#include "JobSystem.h"
+#include <vector>
+
+namespace utilities
+{
+
+/**
+* Buckets entities by the map coordinate they stand on. The grid is rebuilt
+* from scratch every frame with a counting sort, which stores the entities of
+* each cell next to each other in a structure of arrays. A row of cells is
+* therefore one contiguous range of entities and a query returns ranges that
+* can be processed directly or with SSE:
+* @code
+* grid.rebuild(positions);
+* SpatialGrid::SpanIterator it = grid.queryRadius(center, radius);
+* int begin, end;
+* while (it.next(begin, end))
+* {
+*	for (int i = begin; i < end; i++)
+*	{
+*		// grid.getHandles()[i] at grid.getX()[i], grid.getZ()[i]
+*	}
+* }
+* @endcode
+* The ranges contain all entities in the cells that overlap the query, use
+* gatherRadius() to get only the entities that are inside the radius.
+* Entities outside the map are put in the closest edge cell.
+*/
+class SpatialGrid
+{
+public:
+	/**
+	* Iterates over the rows of cells covered by a query, each row is returned
+	* as a range of entity indices in the grid.
+	*/
+	class SpanIterator
+	{
+	public:
+		/**
+		* Returns the next non-empty range of entities
+		* @param begin set to the first entity index of the range
+		* @param end set to one past the last entity index of the range
+		* @return false if there are no more ranges, begin and end are then unchanged
+		*/
+		bool next(int& begin, int& end);
+
+	private:
+		friend class SpatialGrid;
+
+		/**
+		* Constructor, the bounds need to be inside the grid
+		* @param pCellStarts the first entity index of each cell
+		* @param width width of the grid
+		* @param minX the first column
+		* @param minY the first row
+		* @param maxX the last column
+		* @param maxY the last row, less than minY for an empty query
+		*/
+		SpanIterator(const int* pCellStarts, int width, int minX, int minY, int maxX, int maxY);
+
+		const int*	mpCellStarts;
+		int			mWidth;
+		int			mMinX;
+		int			mMaxX;
+		int			mY;		/**< The next row to return */
+		int			mMaxY;
+	};
+
+	/**
+	* The rebuild is split into chunks of at least this many entities, one per
+	* thread. Below this count the rebuild isn't worth parallelizing.
+	*/
+	static const int REBUILD_CHUNK_SIZE_MIN = 4096;
+
+	/**
+	* Constructor
+	* @param mapWidth width of the map in map coordinates
+	* @param mapHeight height of the map in map coordinates
+	*/
+	SpatialGrid(int mapWidth, int mapHeight);
+
+	/**
+	* Destructor
+	*/
+	~SpatialGrid();
+
+	/**
+	* Rebuilds the grid, the handle of each entity is its index in positions
+	* @param positions the positions of all entities in world coordinates
+	*/
+	void rebuild(const Vec3FloatArray& positions);
+
+	/**
+	* Rebuilds the grid. Large grids are rebuilt in parallel on the job system,
+	* the order of the entities is the same regardless of the number of threads:
+	* sorted by cell and within a cell in the order of positions.
+	* @param positions the positions of all entities in world coordinates
+	* @param pHandles the handle of each entity, e.g. an index into the entity list
+	*/
+	void rebuild(const Vec3FloatArray& positions, const int* pHandles);
+
+	/**
+	* Sets the job system to rebuild on
+	* @param pJobSystem the job system, NULL to rebuild on the calling thread
+	*/
+	inline void setJobSystem(JobSystem* pJobSystem)
+	{
+		mpJobSystem = pJobSystem;
+	}
+
+	/**
+	* Returns the entities in a rectangle of cells. A rectangle outside the map
+	* is clamped to the edge cells, where entities outside the map are stored.
+	* @param min the smallest map coordinate in the rectangle
+	* @param max the largest map coordinate in the rectangle, inclusive
+	* @return iterator over the entity ranges
+	*/
+	SpanIterator queryRectangle(const MapCoordinate& min, const MapCoordinate& max) const;
+
+	/**
+	* Returns the entities in all cells that overlap a circle in the xz-plane
+	* @param center the center of the circle in world coordinates
+	* @param radius the radius of the circle in world units
+	* @return iterator over the entity ranges
+	*/
+	SpanIterator queryRadius(const Vec3Float& center, float radius) const;
+
+	/**
+	* Copies the entities inside a circle in the xz-plane, the y-value is ignored
+	* like in Vec3Float::longerThan(..., false).
+	* @param center the center of the circle in world coordinates
+	* @param radius the radius of the circle in world units
+	* @param handles cleared and filled with the handles of the entities
+	* @param positions resized and filled with the positions of the entities
+	* @return number of entities inside the circle
+	*/
+	int gatherRadius(const Vec3Float& center, float radius, std::vector<int>& handles, Vec3FloatArray& positions) const;
+
+	/**
+	* Returns the cell index of a map coordinate, coordinates outside the map
+	* are moved to the closest edge cell
+	* @param mapCoordinate the map coordinate
+	* @return index of the cell
+	*/
+	inline int getCellIndex(const MapCoordinate& mapCoordinate) const
+	{
+		return clampY(mapCoordinate.y) * mWidth + clampX(mapCoordinate.x);
+	}
+
+	/**
+	* Returns the index of the first entity in a cell
+	* @param cellIndex index of the cell
+	* @return index of the first entity
+	*/
+	inline int getCellBegin(int cellIndex) const
+	{
+		return mCellStarts[cellIndex];
+	}
+
+	/**
+	* Returns one past the index of the last entity in a cell
+	* @param cellIndex index of the cell
+	* @return index after the last entity
+	*/
+	inline int getCellEnd(int cellIndex) const
+	{
+		return mCellStarts[cellIndex + 1];
+	}
+
+	/**
+	* Returns the number of entities in the grid
+	* @return number of entities
+	*/
+	inline int getEntityCount() const
+	{
+		return mPositions.size();
+	}
+
+	/**
+	* Returns the handles of the entities sorted by cell
+	* @return pointer to the handles, getEntityCount() long
+	*/
+	inline const int* getHandles() const
+	{
+		return mHandles.empty() ? NULL : &mHandles[0];
+	}
+
+	/**
+	* Returns the positions of the entities sorted by cell
+	* @return the positions, in the same order as getHandles()
+	*/
+	inline const Vec3FloatArray& getPositions() const
+	{
+		return mPositions;
+	}
+
+	/**
+	* @see Vec3FloatArray::getX()
+	*/
+	inline const float* getX() const
+	{
+		return mPositions.getX();
+	}
+
+	/**
+	* @see Vec3FloatArray::getY()
+	*/
+	inline const float* getY() const
+	{
+		return mPositions.getY();
+	}
+
+	/**
+	* @see Vec3FloatArray::getZ()
+	*/
+	inline const float* getZ() const
+	{
+		return mPositions.getZ();
+	}
+
+	/**
+	* Returns the width of the grid
+	* @return width in map coordinates
+	*/
+	inline int getWidth() const
+	{
+		return mWidth;
+	}
+
+	/**
+	* Returns the height of the grid
+	* @return height in map coordinates
+	*/
+	inline int getHeight() const
+	{
+		return mHeight;
+	}
+
+private:
+	/**
+	* Runs countChunk() on a range of chunks
+	*/
+	struct CountChunks
+	{
+		SpatialGrid* pGrid;
+		int cChunks;
+		const Vec3FloatArray* pPositions;
+
+		void operator()(int begin, int end) const;
+	};
+
+	/**
+	* Runs scatterChunk() on a range of chunks
+	*/
+	struct ScatterChunks
+	{
+		SpatialGrid* pGrid;
+		int cChunks;
+		const Vec3FloatArray* pPositions;
+		const int* pHandles;
+
+		void operator()(int begin, int end) const;
+	};
+
+	/**
+	* Calculates the cell of each entity in a chunk and counts the entities
+	* in each cell
+	* @param chunk index of the chunk
+	* @param cChunks number of chunks
+	* @param positions the positions of all entities
+	*/
+	void countChunk(int chunk, int cChunks, const Vec3FloatArray& positions);
+
+	/**
+	* Calculates where each chunk's entities go in each cell and the start of
+	* each cell from the counts of countChunk()
+	* @param cChunks number of chunks
+	*/
+	void calculateOffsets(int cChunks);
+
+	/**
+	* Moves the entities of a chunk to their sorted place
+	* @param chunk index of the chunk
+	* @param cChunks number of chunks
+	* @param positions the positions of all entities
+	* @param pHandles the handles of all entities, NULL to use the indices
+	*/
+	void scatterChunk(int chunk, int cChunks, const Vec3FloatArray& positions, const int* pHandles);
+
+	inline int clampX(int x) const
+	{
+		return x < 0 ? 0 : (x >= mWidth ? mWidth - 1 : x);
+	}
+
+	inline int clampY(int y) const
+	{
+		return y < 0 ? 0 : (y >= mHeight ? mHeight - 1 : y);
+	}
+
+	int								mWidth;
+	int								mHeight;
+	int								mcCells;
+	std::vector<int>				mCellStarts;		/**< First entity of each cell, mcCells + 1 long */
+	std::vector<int>				mChunkOffsets;		/**< Counts, then insert positions, of each chunk and cell */
+	std::vector<int>				mEntityCells;		/**< The cell of each entity in unsorted order */
+	std::vector<MapCoordinate>		mMapCoordinates;	/**< Scratch buffer for the rebuild */
+	std::vector<int>				mHandles;
+	Vec3FloatArray					mPositions;
+	JobSystem*						mpJobSystem;
+
+	// Not copyable
+	SpatialGrid(const SpatialGrid&);
+	SpatialGrid& operator=(const SpatialGrid&);
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,270 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Flocking and seek steering for large groups of agents, e.g. bug swarms and
+* panicking civilians.
+*/
+
+#include "SteeringEngine.h"
+#include "ParallelFor.h"
+#include <emmintrin.h>
+#include <cmath>
+
+using namespace utilities;
+
+namespace
+{
+/**
+* Loads the last values that don't fill a whole register, the rest is set to 0
+*/
+inline __m128 loadPartial(const float* pValues, int cValues)
+{
+	float values[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	for (int i = 0; i < cValues; i++)
+	{
+		values[i] = pValues[i];
+	}
+	return _mm_loadu_ps(values);
+}
+
+/**
+* Loads four values, or fewer padded with 0 at the end of a range
+*/
+inline __m128 load(const float* pValues, int cValues)
+{
+	return cValues >= 4 ? _mm_loadu_ps(pValues) : loadPartial(pValues, cValues);
+}
+
+/**
+* Adds the lanes in a fixed order so the result is the same on every run
+*/
+inline float sumLanes(__m128 values)
+{
+	__declspec(align(16)) float lanes[4];
+	_mm_store_ps(lanes, values);
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+/**
+* Limits the length of a vector in the xz-plane
+*/
+inline void truncate(float& x, float& z, float maxLength)
+{
+	float lengthSquared = x * x + z * z;
+	if (lengthSquared > maxLength * maxLength)
+	{
+		float scale = maxLength / sqrtf(lengthSquared);
+		x *= scale;
+		z *= scale;
+	}
+}
+}
+
+SteeringEngine::SteeringEngine(int mapWidth, int mapHeight, const SteeringSettings& settings) :
+	mSettings(settings), mGrid(mapWidth, mapHeight)
+{
+	mcTilesX = (mapWidth + TILE_SIZE - 1) / TILE_SIZE;
+	mcTilesY = (mapHeight + TILE_SIZE - 1) / TILE_SIZE;
+	mFront = 0;
+	mpJobSystem = NULL;
+}
+
+SteeringEngine::~SteeringEngine()
+{
+}
+
+void SteeringEngine::setAgents(const Vec3FloatArray& positions, const Vec3FloatArray& velocities)
+{
+	if (positions.size() != velocities.size())
+	{
+		throw Vec3FloatArray::SizeMismatchException();
+	}
+
+	// The targets belong to the old agents if the count changes
+	if (positions.size() != getAgentCount())
+	{
+		mTargets.resize(0);
+	}
+	mPositions[mFront] = positions;
+	mVelocities[mFront] = velocities;
+}
+
+void SteeringEngine::setTargets(const Vec3FloatArray& targets)
+{
+	if (targets.size() != 0 && targets.size() != getAgentCount())
+	{
+		throw Vec3FloatArray::SizeMismatchException();
+	}
+	mTargets = targets;
+}
+
+void SteeringEngine::update(float deltaTime)
+{
+	int cAgents = getAgentCount();
+	int back = 1 - mFront;
+	mPositions[back].resize(cAgents);
+	mVelocities[back].resize(cAgents);
+
+	// The grid sorts the positions, the velocities are sorted the same way
+	// so the neighbours can be read as contiguous ranges
+	mGrid.rebuild(mPositions[mFront]);
+	mSortedVelocityX.resize(cAgents);
+	mSortedVelocityZ.resize(cAgents);
+	const int* pHandles = mGrid.getHandles();
+	const float* pVelocityX = mVelocities[mFront].getX();
+	const float* pVelocityZ = mVelocities[mFront].getZ();
+	for (int i = 0; i < cAgents; i++)
+	{
+		mSortedVelocityX[i] = pVelocityX[pHandles[i]];
+		mSortedVelocityZ[i] = pVelocityZ[pHandles[i]];
+	}
+
+	// Each agent is written by exactly one tile, the number of agents per tile
+	// varies a lot so the tiles are split down to one at a time and stolen
+	UpdateTiles updateTiles = {this, deltaTime};
+	parallelFor(mpJobSystem, 0, mcTilesX * mcTilesY, 1, updateTiles);
+
+	mFront = back;
+}
+
+void SteeringEngine::UpdateTiles::operator()(int begin, int end) const
+{
+	for (int tile = begin; tile < end; tile++)
+	{
+		pEngine->updateTile(tile, deltaTime);
+	}
+}
+
+void SteeringEngine::updateTile(int tile, float deltaTime)
+{
+	int minX = (tile % mcTilesX) * TILE_SIZE;
+	int minY = (tile / mcTilesX) * TILE_SIZE;
+	int maxX = (std::min)(minX + TILE_SIZE, mGrid.getWidth()) - 1;
+	int maxY = (std::min)(minY + TILE_SIZE, mGrid.getHeight()) - 1;
+
+	for (int y = minY; y <= maxY; y++)
+	{
+		int end = mGrid.getCellEnd(y * mGrid.getWidth() + maxX);
+		for (int i = mGrid.getCellBegin(y * mGrid.getWidth() + minX); i < end; i++)
+		{
+			updateAgent(i, deltaTime);
+		}
+	}
+}
+
+void SteeringEngine::updateAgent(int sortedIndex, float deltaTime)
+{
+	const float* pX = mGrid.getX();
+	const float* pZ = mGrid.getZ();
+	float x = pX[sortedIndex];
+	float z = pZ[sortedIndex];
+	float velocityX = mSortedVelocityX[sortedIndex];
+	float velocityZ = mSortedVelocityZ[sortedIndex];
+
+	__m128 agentX = _mm_set1_ps(x);
+	__m128 agentZ = _mm_set1_ps(z);
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 neighbourRadiusSquared = _mm_set1_ps(mSettings.neighbourRadius * mSettings.neighbourRadius);
+	__m128 separationRadiusSquared = _mm_set1_ps(mSettings.separationRadius * mSettings.separationRadius);
+	__m128i laneIndices = _mm_set_epi32(3, 2, 1, 0);
+	__m128 separationX = zero;
+	__m128 separationZ = zero;
+	__m128 neighbourVelocityX = zero;
+	__m128 neighbourVelocityZ = zero;
+	__m128 offsetX = zero;
+	__m128 offsetZ = zero;
+	__m128 cNeighbours = zero;
+
+	SpatialGrid::SpanIterator it = mGrid.queryRadius(Vec3Float(x, 0.0f, z), mSettings.neighbourRadius);
+	int begin = 0;
+	int end = 0;
+	while (it.next(begin, end))
+	{
+		for (int i = begin; i < end; i += 4)
+		{
+			int cLeft = end - i;
+			__m128 valid = _mm_castsi128_ps(_mm_cmplt_epi32(laneIndices, _mm_set1_epi32(cLeft)));
+			__m128 diffX = _mm_sub_ps(load(pX + i, cLeft), agentX);
+			__m128 diffZ = _mm_sub_ps(load(pZ + i, cLeft), agentZ);
+			__m128 distanceSquared = _mm_add_ps(_mm_mul_ps(diffX, diffX), _mm_mul_ps(diffZ, diffZ));
+
+			// The agent itself and agents at the exact same position are skipped
+			__m128 isNeighbour = _mm_and_ps(valid, _mm_and_ps(_mm_cmple_ps(distanceSquared, neighbourRadiusSquared), _mm_cmpgt_ps(distanceSquared, zero)));
+			__m128 isTooClose = _mm_and_ps(isNeighbour, _mm_cmplt_ps(distanceSquared, separationRadiusSquared));
+
+			// Push away with 1 / distance, i.e. -diff / distance^2. Lanes that
+			// aren't too close divide by 1 instead so they can't divide by 0.
+			__m128 divisor = _mm_or_ps(_mm_and_ps(isTooClose, distanceSquared), _mm_andnot_ps(isTooClose, one));
+			__m128 inverse = _mm_div_ps(one, divisor);
+			separationX = _mm_sub_ps(separationX, _mm_and_ps(isTooClose, _mm_mul_ps(diffX, inverse)));
+			separationZ = _mm_sub_ps(separationZ, _mm_and_ps(isTooClose, _mm_mul_ps(diffZ, inverse)));
+
+			neighbourVelocityX = _mm_add_ps(neighbourVelocityX, _mm_and_ps(isNeighbour, load(&mSortedVelocityX[i], cLeft)));
+			neighbourVelocityZ = _mm_add_ps(neighbourVelocityZ, _mm_and_ps(isNeighbour, load(&mSortedVelocityZ[i], cLeft)));
+			offsetX = _mm_add_ps(offsetX, _mm_and_ps(isNeighbour, diffX));
+			offsetZ = _mm_add_ps(offsetZ, _mm_and_ps(isNeighbour, diffZ));
+			cNeighbours = _mm_add_ps(cNeighbours, _mm_and_ps(isNeighbour, one));
+		}
+	}
+
+	float forceX = sumLanes(separationX) * mSettings.separationWeight;
+	float forceZ = sumLanes(separationZ) * mSettings.separationWeight;
+
+	float neighbourCount = sumLanes(cNeighbours);
+	if (neighbourCount > 0.0f)
+	{
+		// Alignment steers towards the average velocity and cohesion towards
+		// the center of the neighbours
+		float inverseCount = 1.0f / neighbourCount;
+		forceX += (sumLanes(neighbourVelocityX) * inverseCount - velocityX) * mSettings.alignmentWeight;
+		forceZ += (sumLanes(neighbourVelocityZ) * inverseCount - velocityZ) * mSettings.alignmentWeight;
+		forceX += sumLanes(offsetX) * inverseCount * mSettings.cohesionWeight;
+		forceZ += sumLanes(offsetZ) * inverseCount * mSettings.cohesionWeight;
+	}
+
+	int agent = mGrid.getHandles()[sortedIndex];
+	if (mTargets.size() != 0)
+	{
+		float toTargetX = mTargets.getX()[agent] - x;
+		float toTargetZ = mTargets.getZ()[agent] - z;
+		float distance = sqrtf(toTargetX * toTargetX + toTargetZ * toTargetZ);
+		if (distance > 0.0f)
+		{
+			float speed = mSettings.maxSpeed / distance;
+			forceX += (toTargetX * speed - velocityX) * mSettings.seekWeight;
+			forceZ += (toTargetZ * speed - velocityZ) * mSettings.seekWeight;
+		}
+	}
+
+	truncate(forceX, forceZ, mSettings.maxForce);
+	velocityX += forceX * deltaTime;
+	velocityZ += forceZ * deltaTime;
+	truncate(velocityX, velocityZ, mSettings.maxSpeed);
+
+	int back = 1 - mFront;
+	mPositions[back].getX()[agent] = x + velocityX * deltaTime;
+	mPositions[back].getY()[agent] = mGrid.getY()[sortedIndex];
+	mPositions[back].getZ()[agent] = z + velocityZ * deltaTime;
+	mVelocities[back].getX()[agent] = velocityX;
+	mVelocities[back].getY()[agent] = mVelocities[mFront].getY()[agent];
+	mVelocities[back].getZ()[agent] = velocityZ;
+}
\ No newline at end of file
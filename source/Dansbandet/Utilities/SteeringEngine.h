@@ -0,0 +1,216 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Flocking and seek steering for large groups of agents, e.g. bug swarms and
+* panicking civilians.
+*/
+
+#ifndef __STEERING_ENGINE_H__
+#define __STEERING_ENGINE_H__
+
+#include "SpatialGrid.h"
+#include "Vec3FloatArray.h"
+#include "JobSystem.h"
+#include <vector>
+
+namespace utilities
+{
+
+/**
+* Settings for SteeringEngine, all distances are in world units
+*/
+struct SteeringSettings
+{
+	float neighbourRadius;		/**< Agents within this distance affect alignment and cohesion */
+	float separationRadius;		/**< Agents within this distance push each other away */
+	float separationWeight;
+	float alignmentWeight;
+	float cohesionWeight;
+	float seekWeight;
+	float maxSpeed;				/**< World units per second */
+	float maxForce;				/**< Maximum change of velocity per second */
+
+	/**
+	* Constructor, sets settings that work for a bug swarm
+	*/
+	SteeringSettings() :
+		neighbourRadius(10.0f), separationRadius(4.0f), separationWeight(60.0f), alignmentWeight(1.0f),
+		cohesionWeight(1.0f), seekWeight(2.0f), maxSpeed(20.0f), maxForce(60.0f) {}
+};
+
+/**
+* Moves agents with separation, alignment, cohesion and seek in the xz-plane.
+* The agents are bucketed in a SpatialGrid and the map is divided into tiles
+* of cells. The tiles run as jobs on the job system set with setJobSystem(),
+* or on the calling thread when none is set. Each tile reads the positions
+* and velocities of the last frame and writes the new ones to a second
+* buffer, so there are no locks and the result doesn't depend on the number
+* of threads or the order the tiles are updated in.
+* @code
+* engine.setAgents(positions, velocities);
+* engine.setTargets(targets);
+* // every frame:
+* engine.update(deltaTime);
+* render(engine.getPositions());
+* @endcode
+*/
+class SteeringEngine
+{
+public:
+	/** Width and height of a tile in map coordinates */
+	static const int TILE_SIZE = 8;
+
+	/**
+	* Constructor
+	* @param mapWidth width of the map in map coordinates
+	* @param mapHeight height of the map in map coordinates
+	* @param settings the steering settings
+	*/
+	SteeringEngine(int mapWidth, int mapHeight, const SteeringSettings& settings = SteeringSettings());
+
+	/**
+	* Destructor
+	*/
+	~SteeringEngine();
+
+	/**
+	* Replaces the agents. If the number of agents changes the targets are
+	* cleared, i.e. seeking is turned off until setTargets() is called again.
+	* @param positions the positions of the agents
+	* @param velocities the velocities of the agents, needs the same size as positions
+	* @throws Vec3FloatArray::SizeMismatchException if the sizes differ
+	*/
+	void setAgents(const Vec3FloatArray& positions, const Vec3FloatArray& velocities);
+
+	/**
+	* Sets the position each agent seeks towards
+	* @param targets one target per agent, or an empty array to turn off seeking
+	* @throws Vec3FloatArray::SizeMismatchException if targets isn't empty and
+	* doesn't have one target per agent
+	*/
+	void setTargets(const Vec3FloatArray& targets);
+
+	/**
+	* Moves all agents one step
+	* @param deltaTime the time of the step in seconds
+	*/
+	void update(float deltaTime);
+
+	/**
+	* Sets the job system to update on, also used by the grid rebuild
+	* @param pJobSystem the job system, NULL to update on the calling thread
+	*/
+	inline void setJobSystem(JobSystem* pJobSystem)
+	{
+		mpJobSystem = pJobSystem;
+		mGrid.setJobSystem(pJobSystem);
+	}
+
+	/**
+	* Returns the positions after the last update()
+	* @return positions of the agents
+	*/
+	inline const Vec3FloatArray& getPositions() const
+	{
+		return mPositions[mFront];
+	}
+
+	/**
+	* Returns the velocities after the last update()
+	* @return velocities of the agents
+	*/
+	inline const Vec3FloatArray& getVelocities() const
+	{
+		return mVelocities[mFront];
+	}
+
+	/**
+	* Returns the number of agents
+	* @return number of agents
+	*/
+	inline int getAgentCount() const
+	{
+		return mPositions[mFront].size();
+	}
+
+	/**
+	* Changes the steering settings
+	* @param settings the new settings
+	*/
+	inline void setSettings(const SteeringSettings& settings)
+	{
+		mSettings = settings;
+	}
+
+	/**
+	* Returns the steering settings
+	* @return the steering settings
+	*/
+	inline const SteeringSettings& getSettings() const
+	{
+		return mSettings;
+	}
+
+private:
+	/**
+	* Runs updateTile() on a range of tiles
+	*/
+	struct UpdateTiles
+	{
+		SteeringEngine* pEngine;
+		float deltaTime;
+
+		void operator()(int begin, int end) const;
+	};
+
+	/**
+	* Updates all agents in a tile
+	* @param tile index of the tile
+	* @param deltaTime the time of the step in seconds
+	*/
+	void updateTile(int tile, float deltaTime);
+
+	/**
+	* Updates one agent, reads from the front buffers and writes to the back buffers
+	* @param sortedIndex the index of the agent in the grid
+	* @param deltaTime the time of the step in seconds
+	*/
+	void updateAgent(int sortedIndex, float deltaTime);
+
+	SteeringSettings	mSettings;
+	SpatialGrid			mGrid;
+	int					mcTilesX;
+	int					mcTilesY;
+	int					mFront;				/**< Index of the buffers with the latest state */
+	Vec3FloatArray		mPositions[2];
+	Vec3FloatArray		mVelocities[2];
+	Vec3FloatArray		mTargets;
+	std::vector<float>	mSortedVelocityX;	/**< Velocities in the order of the grid */
+	std::vector<float>	mSortedVelocityZ;
+	JobSystem*			mpJobSystem;
+
+	// Not copyable
+	SteeringEngine(const SteeringEngine&);
+	SteeringEngine& operator=(const SteeringEngine&);
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,169 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Sweep and prune broad phase for the collisions between tanks, bugs,
+* projectiles and civilians.
+*/
+
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+using namespace utilities;
+
+SweepAndPrune::SweepAndPrune(int maxPairs) : mPairs(maxPairs)
+{
+	mcPairs = 0;
+	mPairBufferFull = false;
+	mcSwaps = 0;
+	mFullSortNeeded = false;
+}
+
+SweepAndPrune::~SweepAndPrune()
+{
+}
+
+void SweepAndPrune::resizeOrder(int cBodies)
+{
+	int cOldBodies = static_cast<int>(mOrder.size());
+	if (cBodies < cOldBodies)
+	{
+		int cKept = 0;
+		for (int i = 0; i < cOldBodies; i++)
+		{
+			if (mOrder[i] < cBodies)
+			{
+				mOrder[cKept] = mOrder[i];
+				cKept++;
+			}
+		}
+		mOrder.resize(cBodies);
+	}
+	else
+	{
+		// New bodies are appended and moved into place by the sort, if there are
+		// many of them, e.g. in the first frame, the order is sorted from scratch.
+		mFullSortNeeded = (cBodies - cOldBodies) * 4 > cBodies;
+		for (int i = cOldBodies; i < cBodies; i++)
+		{
+			mOrder.push_back(i);
+		}
+	}
+
+	mMinX.resize(cBodies);
+	mMaxX.resize(cBodies);
+	mMinY.resize(cBodies);
+	mMaxY.resize(cBodies);
+	mMinZ.resize(cBodies);
+	mMaxZ.resize(cBodies);
+}
+
+void SweepAndPrune::sortOrder()
+{
+	mcSwaps = 0;
+	int cBodies = static_cast<int>(mOrder.size());
+	if (mFullSortNeeded)
+	{
+		mSortScratch.resize(cBodies);
+		for (int i = 0; i < cBodies; i++)
+		{
+			mSortScratch[i] = std::make_pair(mMinX[i], mOrder[i]);
+		}
+		std::sort(mSortScratch.begin(), mSortScratch.end());
+		for (int i = 0; i < cBodies; i++)
+		{
+			mMinX[i] = mSortScratch[i].first;
+			mOrder[i] = mSortScratch[i].second;
+		}
+		mFullSortNeeded = false;
+		return;
+	}
+
+	for (int i = 1; i < cBodies; i++)
+	{
+		float minX = mMinX[i];
+		int body = mOrder[i];
+		int j = i;
+		while (j > 0 && mMinX[j - 1] > minX)
+		{
+			mMinX[j] = mMinX[j - 1];
+			mOrder[j] = mOrder[j - 1];
+			j--;
+		}
+		mMinX[j] = minX;
+		mOrder[j] = body;
+		mcSwaps += i - j;
+	}
+}
+
+void SweepAndPrune::update(const Vec3FloatArray& positions, const float* pRadii)
+{
+	int cBodies = positions.size();
+	resizeOrder(cBodies);
+
+	const float* pX = positions.getX();
+	const float* pY = positions.getY();
+	const float* pZ = positions.getZ();
+
+	// Sort on the new x-values in last frame's order, which is nearly sorted
+	for (int i = 0; i < cBodies; i++)
+	{
+		int body = mOrder[i];
+		mMinX[i] = pX[body] - pRadii[body];
+	}
+	sortOrder();
+
+	for (int i = 0; i < cBodies; i++)
+	{
+		int body = mOrder[i];
+		float radius = pRadii[body];
+		mMaxX[i] = pX[body] + radius;
+		mMinY[i] = pY[body] - radius;
+		mMaxY[i] = pY[body] + radius;
+		mMinZ[i] = pZ[body] - radius;
+		mMaxZ[i] = pZ[body] + radius;
+	}
+
+	// Sweep, only the bodies that start before this one ends can overlap it
+	mcPairs = 0;
+	mPairBufferFull = false;
+	int maxPairs = static_cast<int>(mPairs.size());
+	for (int i = 0; i < cBodies; i++)
+	{
+		float maxX = mMaxX[i];
+		for (int j = i + 1; j < cBodies && mMinX[j] <= maxX; j++)
+		{
+			if (mMinY[j] <= mMaxY[i] && mMaxY[j] >= mMinY[i] &&
+				mMinZ[j] <= mMaxZ[i] && mMaxZ[j] >= mMinZ[i])
+			{
+				if (mcPairs == maxPairs)
+				{
+					mPairBufferFull = true;
+					return;
+				}
+
+				int first = mOrder[i];
+				int second = mOrder[j];
+				mPairs[mcPairs] = first < second ? CollisionPair(first, second) : CollisionPair(second, first);
+				mcPairs++;
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Sweep and prune broad phase for the collisions between tanks, bugs,
+* projectiles and civilians.
+*/
+
+#ifndef __SWEEP_AND_PRUNE_H__
+#define __SWEEP_AND_PRUNE_H__
+
+#include "Vec3FloatArray.h"
+#include <vector>
+#include <utility>
+
+namespace utilities
+{
+
+/**
+* Two bodies whose bounding boxes overlap, first is always less than second
+*/
+struct CollisionPair
+{
+	int first;	/**< Index of the first body */
+	int second;	/**< Index of the second body */
+
+	/**
+	* Constructor
+	* @param first index of the first body
+	* @param second index of the second body
+	*/
+	CollisionPair(int first = -1, int second = -1) : first(first), second(second) {}
+};
+
+/**
+* Finds all pairs of bodies with overlapping axis aligned bounding boxes. The
+* bodies are kept sorted along x between frames, since they only move a little
+* each frame the order is restored with an insertion sort in close to linear
+* time. The sorted bodies are then swept once and only bodies that overlap on
+* x are tested on y and z.
+* @code
+* SweepAndPrune broadPhase(MAX_PAIRS);
+* // every frame:
+* broadPhase.update(positions, radii);
+* for (int i = 0; i < broadPhase.getPairCount(); i++)
+* {
+*	// narrow phase on broadPhase.getPairs()[i]
+* }
+* @endcode
+* A body is identified by its index in the positions, when a body is removed
+* and another moved into its index the pair results are still correct but the
+* sort needs more work that frame.
+*/
+class SweepAndPrune
+{
+public:
+	/**
+	* Constructor
+	* @param maxPairs the size of the pair buffer, it's allocated once
+	*/
+	explicit SweepAndPrune(int maxPairs);
+
+	/**
+	* Destructor
+	*/
+	~SweepAndPrune();
+
+	/**
+	* Sorts the bodies and finds the overlapping pairs. The bounding box of a
+	* body is its position +- its radius on all axes.
+	* @param positions the positions of all bodies
+	* @param pRadii the radius of each body
+	*/
+	void update(const Vec3FloatArray& positions, const float* pRadii);
+
+	/**
+	* Returns the pairs found by the last update()
+	* @return pointer to getPairCount() pairs
+	*/
+	inline const CollisionPair* getPairs() const
+	{
+		return mPairs.empty() ? NULL : &mPairs[0];
+	}
+
+	/**
+	* Returns the number of pairs found by the last update()
+	* @return number of pairs
+	*/
+	inline int getPairCount() const
+	{
+		return mcPairs;
+	}
+
+	/**
+	* Checks if there were more pairs than fit in the pair buffer in the last
+	* update(), the pairs that didn't fit were dropped.
+	* @return true if pairs were dropped
+	*/
+	inline bool isPairBufferFull() const
+	{
+		return mPairBufferFull;
+	}
+
+	/**
+	* Returns the number of swaps the insertion sort needed in the last update(),
+	* a measure of how much the order changed since the frame before. It's 0
+	* when the order was sorted from scratch.
+	* @return number of swaps
+	*/
+	inline int getSwapCount() const
+	{
+		return mcSwaps;
+	}
+
+private:
+	/**
+	* Adds new bodies to and removes old bodies from the sorted order
+	* @param cBodies the number of bodies this frame
+	*/
+	void resizeOrder(int cBodies);
+
+	/**
+	* Sorts mOrder and mMinX on mMinX, with insertion sort unless many bodies were added
+	*/
+	void sortOrder();
+
+	std::vector<int>			mOrder;		/**< Body indices sorted on the minimum x-value */
+	std::vector<float>			mMinX;		/**< Bounding boxes in sorted order */
+	std::vector<float>			mMaxX;
+	std::vector<float>			mMinY;
+	std::vector<float>			mMaxY;
+	std::vector<float>			mMinZ;
+	std::vector<float>			mMaxZ;
+	std::vector<CollisionPair>	mPairs;
+	int							mcPairs;
+	bool						mPairBufferFull;
+	int							mcSwaps;
+	bool						mFullSortNeeded;	/**< If many bodies were added since the last sort */
+	std::vector<std::pair<float, int> >	mSortScratch;	/**< Used when sorting from scratch */
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,267 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Finds the nearest targets of many seekers at once, e.g. which player tank or
+* civilian each bug should attack.
+*/
+
+#include "TargetQuery.h"
+#include "ParallelFor.h"
+#include <emmintrin.h>
+#include <algorithm>
+
+using namespace utilities;
+
+namespace
+{
+/** Seekers are searched in the k-d tree in parallel parts of at most this many */
+const int PARALLEL_SEEKER_GRAIN = 512;
+
+/**
+* Orders target indices along one axis when building the k-d tree
+*/
+struct AxisLess
+{
+	const float* pValues;
+
+	AxisLess(const float* pValues) : pValues(pValues) {}
+
+	bool operator()(int first, int second) const
+	{
+		return pValues[first] < pValues[second];
+	}
+};
+}
+
+void TargetQuery::NearestList::add(int index, float distanceSquared)
+{
+	// Insertion sort, k is small. Equal distances are ordered by index.
+	int position = cFound < k ? cFound : k - 1;
+	if (cFound == k && (distanceSquared > pDistancesSquared[position] ||
+		(distanceSquared == pDistancesSquared[position] && index > pIndices[position])))
+	{
+		return;
+	}
+
+	while (position > 0 && (distanceSquared < pDistancesSquared[position - 1] ||
+		(distanceSquared == pDistancesSquared[position - 1] && index < pIndices[position - 1])))
+	{
+		pDistancesSquared[position] = pDistancesSquared[position - 1];
+		pIndices[position] = pIndices[position - 1];
+		position--;
+	}
+	pDistancesSquared[position] = distanceSquared;
+	pIndices[position] = index;
+	if (cFound < k)
+	{
+		cFound++;
+	}
+}
+
+TargetQuery::TargetQuery()
+{
+	mpJobSystem = NULL;
+	mUseKdTree = false;
+}
+
+TargetQuery::~TargetQuery()
+{
+}
+
+void TargetQuery::setTargets(const Vec3FloatArray& targets)
+{
+	int cTargets = targets.size();
+	mUseKdTree = cTargets >= KD_TREE_TARGET_COUNT_MIN;
+	mTreeIndices.resize(cTargets);
+	mTreeX.assign(targets.getX(), targets.getX() + cTargets);
+	mTreeZ.assign(targets.getZ(), targets.getZ() + cTargets);
+
+	for (int i = 0; i < cTargets; i++)
+	{
+		mTreeIndices[i] = i;
+	}
+
+	if (mUseKdTree)
+	{
+		buildKdTree(0, cTargets, 0);
+
+		// Reorder the positions to tree order so the search reads them sequentially
+		const float* pX = targets.getX();
+		const float* pZ = targets.getZ();
+		for (int i = 0; i < cTargets; i++)
+		{
+			mTreeX[i] = pX[mTreeIndices[i]];
+			mTreeZ[i] = pZ[mTreeIndices[i]];
+		}
+	}
+}
+
+void TargetQuery::buildKdTree(int begin, int end, int depth)
+{
+	if (end - begin <= 1)
+	{
+		return;
+	}
+
+	// mTreeX and mTreeZ are in the original order during the build
+	int median = (begin + end) >> 1;
+	std::nth_element(mTreeIndices.begin() + begin, mTreeIndices.begin() + median, mTreeIndices.begin() + end,
+		AxisLess((depth & 1) == 0 ? &mTreeX[0] : &mTreeZ[0]));
+
+	buildKdTree(begin, median, depth + 1);
+	buildKdTree(median + 1, end, depth + 1);
+}
+
+void TargetQuery::searchKdTree(int begin, int end, int depth, float x, float z, NearestList& nearest) const
+{
+	while (begin < end)
+	{
+		int median = (begin + end) >> 1;
+		float diffX = mTreeX[median] - x;
+		float diffZ = mTreeZ[median] - z;
+		nearest.add(mTreeIndices[median], diffX * diffX + diffZ * diffZ);
+
+		// Search the side of the seeker first, then the other side only if the
+		// splitting line is close enough. Equal distances are searched too so
+		// ties are resolved the same way as the brute force search.
+		float diffSplit = (depth & 1) == 0 ? -diffX : -diffZ;
+		bool seekerBelow = diffSplit < 0.0f;
+		if (seekerBelow)
+		{
+			searchKdTree(begin, median, depth + 1, x, z, nearest);
+		}
+		else
+		{
+			searchKdTree(median + 1, end, depth + 1, x, z, nearest);
+		}
+
+		if (diffSplit * diffSplit > nearest.getMaxDistanceSquared())
+		{
+			return;
+		}
+
+		if (seekerBelow)
+		{
+			begin = median + 1;
+		}
+		else
+		{
+			end = median;
+		}
+		depth++;
+	}
+}
+
+void TargetQuery::findNearestBruteForce4(const float* pSeekerX, const float* pSeekerZ, int* pTargetIndices, float* pDistancesSquared) const
+{
+	__m128 seekerX = _mm_loadu_ps(pSeekerX);
+	__m128 seekerZ = _mm_loadu_ps(pSeekerZ);
+	__m128 bestDistances = _mm_set1_ps(FLT_MAX);
+	__m128i bestIndices = _mm_set1_epi32(NO_TARGET);
+
+	// Strictly less keeps the lowest index on ties
+	for (int target = 0; target < getTargetCount(); target++)
+	{
+		__m128 diffX = _mm_sub_ps(seekerX, _mm_set1_ps(mTreeX[target]));
+		__m128 diffZ = _mm_sub_ps(seekerZ, _mm_set1_ps(mTreeZ[target]));
+		__m128 distances = _mm_add_ps(_mm_mul_ps(diffX, diffX), _mm_mul_ps(diffZ, diffZ));
+		__m128i closer = _mm_castps_si128(_mm_cmplt_ps(distances, bestDistances));
+		bestDistances = _mm_min_ps(distances, bestDistances);
+		bestIndices = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(target)), _mm_andnot_si128(closer, bestIndices));
+	}
+
+	_mm_storeu_ps(pDistancesSquared, bestDistances);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(pTargetIndices), bestIndices);
+}
+
+void TargetQuery::findNearest(const Vec3FloatArray& seekers, int* pTargetIndices, float* pDistancesSquared) const
+{
+	const float* pX = seekers.getX();
+	const float* pZ = seekers.getZ();
+	int cSeekers = seekers.size();
+
+	if (mUseKdTree)
+	{
+		SearchKdTree search = {this, pX, pZ, pTargetIndices, pDistancesSquared};
+		parallelFor(mpJobSystem, 0, cSeekers, PARALLEL_SEEKER_GRAIN, search);
+		return;
+	}
+
+	int cBatched = cSeekers & ~3;
+	for (int i = 0; i < cBatched; i += 4)
+	{
+		findNearestBruteForce4(pX + i, pZ + i, pTargetIndices + i, pDistancesSquared + i);
+	}
+
+	// Pad the last seekers to a whole batch
+	if (cBatched < cSeekers)
+	{
+		float x[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+		float z[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+		int indices[4];
+		float distancesSquared[4];
+		int cLeft = cSeekers - cBatched;
+		for (int i = 0; i < cLeft; i++)
+		{
+			x[i] = pX[cBatched + i];
+			z[i] = pZ[cBatched + i];
+		}
+		findNearestBruteForce4(x, z, indices, distancesSquared);
+		for (int i = 0; i < cLeft; i++)
+		{
+			pTargetIndices[cBatched + i] = indices[i];
+			pDistancesSquared[cBatched + i] = distancesSquared[i];
+		}
+	}
+}
+
+void TargetQuery::SearchKdTree::operator()(int begin, int end) const
+{
+	for (int i = begin; i < end; i++)
+	{
+		NearestList nearest = {&pTargetIndices[i], &pDistancesSquared[i], 1, 0};
+		pQuery->searchKdTree(0, pQuery->getTargetCount(), 0, pX[i], pZ[i], nearest);
+	}
+}
+
+int TargetQuery::findNearest(const Vec3Float& seeker, int k, int* pTargetIndices, float* pDistancesSquared) const
+{
+	NearestList nearest = {pTargetIndices, pDistancesSquared, k, 0};
+	if (k <= 0)
+	{
+		return 0;
+	}
+
+	if (mUseKdTree)
+	{
+		searchKdTree(0, getTargetCount(), 0, seeker.x, seeker.z, nearest);
+	}
+	else
+	{
+		for (int target = 0; target < getTargetCount(); target++)
+		{
+			float diffX = mTreeX[target] - seeker.x;
+			float diffZ = mTreeZ[target] - seeker.z;
+			nearest.add(target, diffX * diffX + diffZ * diffZ);
+		}
+	}
+	return nearest.cFound;
+}
\ No newline at end of file
@@ -0,0 +1,318 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Task graph for the frame. Nodes declare the resources they read and write,
+* independent nodes run in parallel on the JobSystem and each node is timed.
+*/
+
+#include "TaskGraph.h"
+#include "PerfectHash.h"
+#include "ResourceNames.h"
+#include <algorithm>
+#include <map>
+#include <windows.h>
+
+using namespace utilities;
+
+namespace
+{
+/**
+* The nodes that have accessed a resource since it was last written
+*/
+struct ResourceState
+{
+	int lastWriter;
+	std::vector<int> readers;
+
+	ResourceState() : lastWriter(-1) {}
+};
+
+/**
+* The states of the resources, the resources in ResourceNames.txt are indexed
+* with the perfect hash table generated into ResourceNames.h and the rest are
+* kept in a map
+*/
+class ResourceStates
+{
+public:
+	ResourceStates() :
+		mNames(RESOURCE_NAMES_DISPLACEMENTS, RESOURCE_NAMES_BUCKET_COUNT, RESOURCE_NAMES_KEYS, RESOURCE_NAMES_KEY_COUNT, RESOURCE_NAMES_SEED),
+		mNamedStates(RESOURCE_NAMES_KEY_COUNT) {}
+
+	ResourceState& operator[](HashedStringId resource)
+	{
+		int index = mNames.getIndex(resource);
+		return index != PerfectHashTable::NOT_FOUND ? mNamedStates[index] : mOtherStates[resource];
+	}
+
+private:
+	PerfectHashTable mNames;
+	std::vector<ResourceState> mNamedStates;
+	std::map<HashedStringId, ResourceState> mOtherStates;
+
+	// Not copyable
+	ResourceStates(const ResourceStates&);
+	ResourceStates& operator=(const ResourceStates&);
+};
+}
+
+TaskGraph::TaskGraph()
+{
+	mCompiled = true;
+	mpJobSystem = NULL;
+	mpCounter = NULL;
+	mRunTime = 0.0f;
+}
+
+TaskGraph::~TaskGraph()
+{
+}
+
+int TaskGraph::addNode(const std::string& name, JobFunction function, void* pData)
+{
+	mNodes.push_back(Node());
+	Node& node = mNodes.back();
+	node.name = name;
+	node.job = Job(function, pData);
+	node.cWaiting = 0;
+	node.startTime = 0.0f;
+	node.endTime = 0.0f;
+	mCompiled = false;
+	return getNodeCount() - 1;
+}
+
+void TaskGraph::addRead(const HashedString& resource)
+{
+	mNodes.back().reads.push_back(resource);
+	mCompiled = false;
+}
+
+void TaskGraph::addWrite(const HashedString& resource)
+{
+	mNodes.back().writes.push_back(resource);
+	mCompiled = false;
+}
+
+void TaskGraph::addDependency(int node)
+{
+	if (node < 0 || node >= getNodeCount() - 1)
+	{
+		throw InvalidDependencyException();
+	}
+	mNodes.back().explicitDependencies.push_back(node);
+	mCompiled = false;
+}
+
+void TaskGraph::clear()
+{
+	mNodes.clear();
+	mNodeJobs.clear();
+	mCompiled = true;
+}
+
+void TaskGraph::run(JobSystem* pJobSystem)
+{
+	if (!mCompiled)
+	{
+		compile();
+	}
+
+	mTimer.start();
+
+	if (pJobSystem == NULL)
+	{
+		// The nodes were added in a valid order
+		for (size_t i = 0; i < mNodes.size(); i++)
+		{
+			mNodes[i].startTime = mTimer.getTime(Timer::ReturnType_MilliSeconds);
+			mNodes[i].job.function(mNodes[i].job.pData);
+			mNodes[i].endTime = mTimer.getTime(Timer::ReturnType_MilliSeconds);
+		}
+		mRunTime = mTimer.getTime(Timer::ReturnType_MilliSeconds);
+		return;
+	}
+
+	for (size_t i = 0; i < mNodes.size(); i++)
+	{
+		mNodes[i].cWaiting = static_cast<long>(mNodes[i].dependencies.size());
+	}
+
+	// A node queues its successors before its own job is counted as done, the
+	// counter thus doesn't reach zero until the last node has finished
+	JobCounter counter;
+	mpJobSystem = pJobSystem;
+	mpCounter = &counter;
+	for (size_t i = 0; i < mNodes.size(); i++)
+	{
+		if (mNodes[i].dependencies.empty())
+		{
+			pJobSystem->run(Job(runNode, &mNodeJobs[i]), &counter);
+		}
+	}
+	pJobSystem->wait(&counter);
+
+	mpJobSystem = NULL;
+	mpCounter = NULL;
+	mRunTime = mTimer.getTime(Timer::ReturnType_MilliSeconds);
+}
+
+const std::vector<int>& TaskGraph::getNodeDependencies(int node)
+{
+	if (!mCompiled)
+	{
+		compile();
+	}
+	return mNodes[node].dependencies;
+}
+
+float TaskGraph::getCriticalPath(std::vector<int>& path)
+{
+	if (!mCompiled)
+	{
+		compile();
+	}
+
+	// The nodes are in dependency order so each node's longest chain can be
+	// calculated from the chains of its dependencies
+	std::vector<float> chainTimes(mNodes.size());
+	std::vector<int> chainParents(mNodes.size());
+	int last = -1;
+	for (size_t i = 0; i < mNodes.size(); i++)
+	{
+		const Node& node = mNodes[i];
+		float longestDependency = 0.0f;
+		chainParents[i] = -1;
+		for (size_t j = 0; j < node.dependencies.size(); j++)
+		{
+			int dependency = node.dependencies[j];
+			if (chainParents[i] == -1 || chainTimes[dependency] > longestDependency)
+			{
+				longestDependency = chainTimes[dependency];
+				chainParents[i] = dependency;
+			}
+		}
+		chainTimes[i] = longestDependency + getNodeTime(static_cast<int>(i));
+
+		if (last == -1 || chainTimes[i] > chainTimes[last])
+		{
+			last = static_cast<int>(i);
+		}
+	}
+
+	path.clear();
+	if (last == -1)
+	{
+		return 0.0f;
+	}
+	for (int node = last; node != -1; node = chainParents[node])
+	{
+		path.push_back(node);
+	}
+	std::reverse(path.begin(), path.end());
+	return chainTimes[last];
+}
+
+void TaskGraph::compile()
+{
+	ResourceStates resources;
+	for (size_t i = 0; i < mNodes.size(); i++)
+	{
+		Node& node = mNodes[i];
+		int index = static_cast<int>(i);
+		node.dependencies = node.explicitDependencies;
+		node.successors.clear();
+
+		// Read after write
+		for (size_t j = 0; j < node.reads.size(); j++)
+		{
+			ResourceState& resource = resources[node.reads[j].getHashValue()];
+			if (resource.lastWriter != -1)
+			{
+				node.dependencies.push_back(resource.lastWriter);
+			}
+		}
+
+		// Write after write and write after read
+		for (size_t j = 0; j < node.writes.size(); j++)
+		{
+			ResourceState& resource = resources[node.writes[j].getHashValue()];
+			if (resource.lastWriter != -1)
+			{
+				node.dependencies.push_back(resource.lastWriter);
+			}
+			node.dependencies.insert(node.dependencies.end(), resource.readers.begin(), resource.readers.end());
+		}
+
+		// Update the resources after all dependencies are known so a node
+		// that reads and writes the same resource doesn't depend on itself
+		for (size_t j = 0; j < node.writes.size(); j++)
+		{
+			ResourceState& resource = resources[node.writes[j].getHashValue()];
+			resource.lastWriter = index;
+			resource.readers.clear();
+		}
+		for (size_t j = 0; j < node.reads.size(); j++)
+		{
+			ResourceState& resource = resources[node.reads[j].getHashValue()];
+			if (resource.lastWriter != index)
+			{
+				resource.readers.push_back(index);
+			}
+		}
+
+		std::sort(node.dependencies.begin(), node.dependencies.end());
+		node.dependencies.erase(std::unique(node.dependencies.begin(), node.dependencies.end()), node.dependencies.end());
+		for (size_t j = 0; j < node.dependencies.size(); j++)
+		{
+			mNodes[node.dependencies[j]].successors.push_back(index);
+		}
+	}
+
+	mNodeJobs.resize(mNodes.size());
+	for (size_t i = 0; i < mNodes.size(); i++)
+	{
+		mNodeJobs[i].pGraph = this;
+		mNodeJobs[i].node = static_cast<int>(i);
+	}
+	mCompiled = true;
+}
+
+void TaskGraph::runNode(void* pData)
+{
+	const NodeJob& nodeJob = *static_cast<const NodeJob*>(pData);
+	TaskGraph* pGraph = nodeJob.pGraph;
+	Node& node = pGraph->mNodes[nodeJob.node];
+
+	node.startTime = pGraph->mTimer.getTime(Timer::ReturnType_MilliSeconds);
+	node.job.function(node.job.pData);
+	node.endTime = pGraph->mTimer.getTime(Timer::ReturnType_MilliSeconds);
+
+	// The decrement is a full barrier, everything the node wrote is visible to
+	// the successor that is queued by the last finished dependency
+	for (size_t i = 0; i < node.successors.size(); i++)
+	{
+		int successor = node.successors[i];
+		if (InterlockedDecrement(&pGraph->mNodes[successor].cWaiting) == 0)
+		{
+			pGraph->mpJobSystem->run(Job(runNode, &pGraph->mNodeJobs[successor]), pGraph->mpCounter);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,253 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Task graph for the frame. Nodes declare the resources they read and write,
+* independent nodes run in parallel on the JobSystem and each node is timed.
+*/
+
+#ifndef __TASK_GRAPH_H__
+#define __TASK_GRAPH_H__
+
+#include "JobSystem.h"
+#include "HashedString.h"
+#include "Timer.h"
+#include "Exception.h"
+#include <string>
+#include <vector>
+
+namespace utilities
+{
+
+/**
+* A graph of the frame's tasks. The dependencies are derived from the order the
+* nodes are added and the resources they declare: a node runs after the last
+* earlier node that writes a resource it reads or writes, and after the earlier
+* nodes that read a resource it writes. Nodes without a path between them run
+* in parallel.
+*
+* Render preparation of frame N overlaps simulation of frame N+1 by reading the
+* snapshot of the previous frame from a TripleBuffer instead of declaring a
+* read of the simulation's resources:
+* @code
+* graph.addNode("simulate", simulate, &world);
+* graph.addWrite(HashedString("World"));
+* graph.addNode("ai", updateAi, &world);
+* graph.addRead(HashedString("World"));
+* graph.addWrite(HashedString("Orders"));
+* graph.addNode("snapshot", writeSnapshot, &world);	// fills and publishes the TripleBuffer
+* graph.addRead(HashedString("World"));
+* graph.addNode("networkSend", sendSnapshot, &network);
+* graph.addRead(HashedString("World"));
+* graph.addNode("renderPrepare", prepareRender, &renderer);	// acquires the TripleBuffer
+* graph.addWrite(HashedString("RenderQueue"));
+* graph.addNode("renderSubmit", submitRender, &renderer);
+* graph.addRead(HashedString("RenderQueue"));
+*
+* // every frame
+* graph.run(&jobSystem);
+* @endcode
+* Here renderPrepare only depends on the snapshot published earlier and runs
+* at the same time as simulate, ai and networkSend.
+*/
+class TaskGraph
+{
+public:
+	/**
+	* Thrown when a node depends on a node that wasn't added before it
+	*/
+	class InvalidDependencyException : public Exception
+	{
+	public:
+		InvalidDependencyException() : Exception("TaskGraphInvalidDependencyException: A node can only depend on earlier nodes!", 70013) {}
+	};
+
+	/**
+	* Constructor
+	*/
+	TaskGraph();
+
+	/**
+	* Destructor
+	*/
+	~TaskGraph();
+
+	/**
+	* Adds a node, addRead(), addWrite() and addDependency() apply to the last
+	* added node
+	* @param name the name of the node in the timings
+	* @param function the function to run
+	* @param pData the data to run the function with
+	* @return index of the node
+	*/
+	int addNode(const std::string& name, JobFunction function, void* pData);
+
+	/**
+	* Declares that the last added node reads a resource
+	* @param resource name of the resource
+	*/
+	void addRead(const HashedString& resource);
+
+	/**
+	* Declares that the last added node writes a resource
+	* @param resource name of the resource
+	*/
+	void addWrite(const HashedString& resource);
+
+	/**
+	* Makes the last added node run after another node, for dependencies that
+	* aren't described by resources
+	* @param node index of the node to run after
+	* @throws InvalidDependencyException if node isn't an earlier node
+	*/
+	void addDependency(int node);
+
+	/**
+	* Removes all nodes
+	*/
+	void clear();
+
+	/**
+	* Runs all nodes and returns when they have finished. The calling thread
+	* runs jobs meanwhile.
+	* @param pJobSystem the job system to run on, NULL to run the nodes in the
+	* order they were added on the calling thread
+	*/
+	void run(JobSystem* pJobSystem);
+
+	/**
+	* Returns the number of nodes
+	* @return number of nodes
+	*/
+	inline int getNodeCount() const
+	{
+		return static_cast<int>(mNodes.size());
+	}
+
+	/**
+	* Returns the name of a node
+	* @param node index of the node
+	* @return name of the node
+	*/
+	inline const std::string& getNodeName(int node) const
+	{
+		return mNodes[node].name;
+	}
+
+	/**
+	* Returns the nodes a node waits for, including those derived from resources
+	* @param node index of the node
+	* @return indices of the nodes it depends on
+	*/
+	const std::vector<int>& getNodeDependencies(int node);
+
+	/**
+	* Returns when a node started in the last run()
+	* @param node index of the node
+	* @return milliseconds since the run started
+	*/
+	inline float getNodeStartTime(int node) const
+	{
+		return mNodes[node].startTime;
+	}
+
+	/**
+	* Returns how long a node took in the last run()
+	* @param node index of the node
+	* @return time of the node in milliseconds
+	*/
+	inline float getNodeTime(int node) const
+	{
+		return mNodes[node].endTime - mNodes[node].startTime;
+	}
+
+	/**
+	* Returns how long the last run() took
+	* @return time of the whole graph in milliseconds
+	*/
+	inline float getRunTime() const
+	{
+		return mRunTime;
+	}
+
+	/**
+	* Calculates the critical path of the last run(), the chain of dependent
+	* nodes with the longest total time. The frame can't be faster than this
+	* regardless of the number of threads.
+	* @param[out] path set to the nodes of the critical path, in order
+	* @return total time of the critical path in milliseconds
+	*/
+	float getCriticalPath(std::vector<int>& path);
+
+private:
+	/**
+	* A node in the graph
+	*/
+	struct Node
+	{
+		std::string name;
+		Job job;
+		std::vector<HashedString> reads;
+		std::vector<HashedString> writes;
+		std::vector<int> explicitDependencies;	/**< Dependencies added with addDependency() */
+		std::vector<int> dependencies;			/**< All dependencies, set by compile() */
+		std::vector<int> successors;			/**< Nodes that depend on this node */
+		volatile long cWaiting;					/**< Dependencies that haven't finished in the current run */
+		float startTime;
+		float endTime;
+	};
+
+	/**
+	* The data of the job that runs a node
+	*/
+	struct NodeJob
+	{
+		TaskGraph* pGraph;
+		int node;
+	};
+
+	/**
+	* Derives the dependencies from the resources and the successors of each node
+	*/
+	void compile();
+
+	/**
+	* Runs a node and queues the successors that have no more dependencies
+	* @param pData the NodeJob of the node
+	*/
+	static void runNode(void* pData);
+
+	std::vector<Node>		mNodes;
+	std::vector<NodeJob>	mNodeJobs;
+	bool					mCompiled;
+
+	// Current run
+	JobSystem*				mpJobSystem;
+	JobCounter*				mpCounter;
+	Timer					mTimer;
+	float					mRunTime;
+
+	// Not copyable
+	TaskGraph(const TaskGraph&);
+	TaskGraph& operator=(const TaskGraph&);
+};
+}
+
+#endif
\ No newline at end of file
@@ -23,13 +23,37 @@
 */
 
 #include "Thread.h"
+#include <sys/timeb.h>
+#include <errno.h>
 
 using namespace utilities;
 
+namespace
+{
+/**
+* Returns the absolute time for pthread_cond_timedwait()
+* @param timeout milliseconds from now
+*/
+inline timespec getAbsoluteTime(int timeout)
+{
+	__timeb64 now;
+	_ftime64_s(&now);
+	long long milliseconds = now.time * 1000LL + now.millitm + timeout;
+
+	timespec time;
+	time.tv_sec = static_cast<time_t>(milliseconds / 1000);
+	time.tv_nsec = static_cast<long>(milliseconds % 1000) * 1000000;
+	return time;
+}
+}
+
 Thread::Thread()
 {
 	isRunning = false;
 	quit = false;
+	mWorkPending = false;
+	pthread_mutex_init(&mQuitMutex, NULL);
+	pthread_cond_init(&mWorkCondition, NULL);
 }
 
 Thread::~Thread()
@@ -42,30 +66,76 @@ Thread::~Thread()
 		SAFE_MUTEX_DESTROY(&mEventMutex[i]);
 	}
 
+	pthread_cond_destroy(&mWorkCondition);
 	SAFE_MUTEX_DESTROY(&mQuitMutex);
 }
 
 pthread_t Thread::create()
 {
-	pthread_mutex_init(&mQuitMutex, NULL);
 	for(int i = 0; i < MAX_THREADS; i++)
 	{
 		pthread_mutex_init(&mEventMutex[i], NULL);
 	}
 
-	pthread_create(&mThread, NULL, run, (void*)this);
-
+	// Reset before the thread starts so it can't miss an early requestStop()
+	pthread_mutex_lock(&mQuitMutex);
 	quit = false;
+	mWorkPending = false;
+	pthread_mutex_unlock(&mQuitMutex);
+
+	pthread_create(&mThread, NULL, run, (void*)this);
 
 	return mThread;
 }
 
 void Thread::exit()
+{
+	requestStop();
+}
+
+void Thread::requestStop()
 {
 	pthread_mutex_lock(&mQuitMutex);
 	quit = true;
 	isRunning = false;
+	pthread_cond_broadcast(&mWorkCondition);
+	pthread_mutex_unlock(&mQuitMutex);
+}
+
+void Thread::notifyWork()
+{
+	pthread_mutex_lock(&mQuitMutex);
+	mWorkPending = true;
+	pthread_cond_signal(&mWorkCondition);
+	pthread_mutex_unlock(&mQuitMutex);
+}
+
+bool Thread::waitForWork(int timeout)
+{
+	pthread_mutex_lock(&mQuitMutex);
+	if (timeout == WAIT_INFINITE)
+	{
+		while (!mWorkPending && !quit)
+		{
+			pthread_cond_wait(&mWorkCondition, &mQuitMutex);
+		}
+	}
+	else
+	{
+		timespec time = getAbsoluteTime(timeout);
+		while (!mWorkPending && !quit)
+		{
+			if (pthread_cond_timedwait(&mWorkCondition, &mQuitMutex, &time) == ETIMEDOUT)
+			{
+				break;
+			}
+		}
+	}
+
+	bool hasWork = mWorkPending && !quit;
+	mWorkPending = false;
 	pthread_mutex_unlock(&mQuitMutex);
+	return hasWork;
 }
 
 void Thread::lock(int index)
@@ -80,7 +150,10 @@ void Thread::unlock(int index)
 
 bool Thread::getQuit()
 {
-	return quit;
+	pthread_mutex_lock(&mQuitMutex);
+	bool stop = quit;
+	pthread_mutex_unlock(&mQuitMutex);
+	return stop;
 }
 
 void* Thread::run(void* arg)
@@ -23,13 +23,26 @@
 
 #include <pthread.h>
 #include "../Utilities/Macros.h"
+#include "../Utilities/Semaphore.h"
 
 namespace utilities
 {
 const int MAX_THREADS = 5;
 
 /**
-* Base class for threads
+* Base class for threads. Use it for long-running services, short parallel
+* work should be run as jobs in the JobSystem instead. The thread should block
+* in waitForWork() when it's idle instead of polling:
+* @code
+* void Service::mainLoop()
+* {
+*	while (!getQuit())
+*	{
+*		waitForWork();
+*		// process the queue filled by other threads that call notifyWork()
+*	}
+* }
+* @endcode
 */
 class Thread
 {
@@ -50,15 +63,28 @@ public:
 	pthread_t create();
 
 	/**
-	 * Exits thread
+	 * Exits thread, same as requestStop()
 	 */
 	void exit();
 
 	/**
-	 * Checks if thread is running or not
+	 * Asks the thread to stop, wakes it at once if it waits in waitForWork().
+	 * Thread safe.
+	 */
+	void requestStop();
+
+	/**
+	 * Checks if the thread has been asked to stop. Thread safe.
+	 * @return true if requestStop() or exit() has been called
 	 */
 	bool getQuit();
 
+	/**
+	 * Tells the thread that there is work for it and wakes it if it waits in
+	 * waitForWork(). Thread safe.
+	 */
+	void notifyWork();
+
 	/**
 	 * Locks a thread
 	 */
@@ -95,6 +121,15 @@ public:
 	virtual void mainLoop() = 0;
 
 protected:
+	/**
+	 * Blocks until notifyWork() or requestStop() is called or the timeout
+	 * expires. Returns at once if notifyWork() has been called since the last
+	 * wait.
+	 * @param timeout milliseconds to wait, WAIT_INFINITE to wait until woken
+	 * @return true if there is work, false if the timeout expired or the
+	 * thread has been asked to stop
+	 */
+	bool waitForWork(int timeout = WAIT_INFINITE);
 
 	/**
 	 * Sets thread to running or shut down
@@ -105,10 +140,12 @@ protected:
 private:
 	pthread_t		mThread;
 	pthread_mutex_t mEventMutex[MAX_THREADS];
-	pthread_mutex_t mQuitMutex;
+	pthread_mutex_t mQuitMutex;		/**< Protects quit and mWorkPending */
+	pthread_cond_t	mWorkCondition;	/**< Signalled by notifyWork() and requestStop() */
 
 	bool			isRunning;
 	bool			quit;
+	bool			mWorkPending;
 };
 }
 
@@ -24,14 +24,29 @@
 
 #include "Timer.h"
 
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
 using namespace utilities;
 
-const float TICKS_IN_MILLISECONDS	= 1000;
-const float TICKS_IN_SECONDS		= 1000 * TICKS_IN_MILLISECONDS;
-const float TICKS_IN_MINUTES		= 60 * TICKS_IN_SECONDS;
+namespace
+{
+/**
+* Returns the current value of the performance counter
+*/
+inline long long getPerformanceCounter()
+{
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+}
 
 Timer::Timer()
 {
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	mFrequency = frequency.QuadPart;
 	mBegin = 0;
 	mLastTime = 0;
 }
@@ -42,23 +57,22 @@ Timer::~Timer()
 
 void Timer::start()
 {
-	mBegin = clock() * CLK_TCK;
+	mBegin = getPerformanceCounter();
 	mLastTime = mBegin;
 }
 
 float Timer::getTime(ReturnTypes retType)
 {
-	clock_t time = clock() * CLK_TCK;
-	float mElapTicks = (float)(time - mBegin);
+	double elapsedSeconds = (double)(getPerformanceCounter() - mBegin) / (double)mFrequency;
 
 	switch(retType)
 	{
 	case ReturnType_MilliSeconds:
-		return mElapTicks / TICKS_IN_MILLISECONDS;
+		return (float)(elapsedSeconds * 1000.0);
 	case ReturnType_Seconds:
-		return mElapTicks / TICKS_IN_SECONDS;
+		return (float)elapsedSeconds;
 	case ReturnType_Minutes:
-		return mElapTicks / TICKS_IN_MINUTES;
+		return (float)(elapsedSeconds / 60.0);
 	default:
 		ERROR_MESSAGE("Invalid returntype in timer.cpp");
 		break;
@@ -68,8 +82,8 @@ float Timer::getTime(ReturnTypes retType)
 
 float Timer::tick()
 {
-	clock_t newTime = clock() * CLK_TCK;
-	float deltaTime = (float)(newTime - mLastTime) / TICKS_IN_SECONDS;
+	long long newTime = getPerformanceCounter();
+	float deltaTime = (float)((double)(newTime - mLastTime) / (double)mFrequency);
 	mLastTime = newTime;
 	return deltaTime;
-}
+}
\ No newline at end of file
@@ -23,13 +23,13 @@
 
 #include "../Utilities/Macros.h"
 
-#include <time.h>
-
 namespace utilities
 {
 
 /**
  * This class is used to time an event of your choice. 
+ * It uses the high resolution performance counter so it's precise enough to
+ * measure budgets of a fraction of a millisecond.
  */
 	
 class Timer
@@ -71,7 +71,8 @@ public:
 	float tick();
 
 private:
-	clock_t mBegin, mLastTime;
+	long long mBegin, mLastTime;
+	long long mFrequency;	/**< Performance counter ticks per second */
 
 };
 }
@@ -0,0 +1,137 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* Lock-free triple buffer for handing the latest snapshot from one producer
+* thread to one consumer thread, e.g. render data from the simulation.
+*/
+
+#ifndef __TRIPLE_BUFFER_H__
+#define __TRIPLE_BUFFER_H__
+
+#include <intrin.h>
+
+namespace utilities
+{
+
+/**
+* Three buffers where the producer writes to one, the consumer reads from
+* another and the third holds the latest published buffer. Neither side ever
+* waits for the other, the consumer always gets the latest complete snapshot
+* and snapshots it hasn't acquired are skipped.
+* @code
+* // Producer, e.g. the end of the simulation
+* RenderSnapshot& snapshot = snapshots.getWriteBuffer();
+* // fill snapshot
+* snapshots.publish();
+*
+* // Consumer, e.g. render preparation
+* snapshots.acquire();
+* const RenderSnapshot& snapshot = snapshots.getReadBuffer();
+* @endcode
+* Only one thread may produce and only one thread may consume at the same time.
+*/
+template <typename T>
+class TripleBuffer
+{
+public:
+	/**
+	* Constructor, all buffers are default constructed
+	*/
+	TripleBuffer()
+	{
+		mWriteIndex = 0;
+		mMiddle = 1;
+		mReadIndex = 2;
+	}
+
+	/**
+	* Destructor
+	*/
+	~TripleBuffer()
+	{
+	}
+
+	/**
+	* Returns the buffer the producer writes to. The content is whatever was
+	* published some frames ago, not the last published buffer.
+	* @return the write buffer
+	*/
+	inline T& getWriteBuffer()
+	{
+		return mBuffers[mWriteIndex];
+	}
+
+	/**
+	* Publishes the write buffer to the consumer and switches to a new write buffer
+	*/
+	void publish()
+	{
+		// The interlocked exchange is a full barrier, the buffer content is thus
+		// visible before the consumer can see the new index
+		long previous = _InterlockedExchange(&mMiddle, mWriteIndex | FRESH);
+		mWriteIndex = previous & INDEX_MASK;
+	}
+
+	/**
+	* Switches the read buffer to the latest published buffer
+	* @return true if a new buffer was published since the last acquire()
+	*/
+	bool acquire()
+	{
+		if ((mMiddle & FRESH) == 0)
+		{
+			return false;
+		}
+
+		long previous = _InterlockedExchange(&mMiddle, mReadIndex);
+		mReadIndex = previous & INDEX_MASK;
+		return true;
+	}
+
+	/**
+	* Returns the buffer the consumer reads from, the one switched to by the
+	* last acquire()
+	* @return the read buffer
+	*/
+	inline const T& getReadBuffer() const
+	{
+		return mBuffers[mReadIndex];
+	}
+
+private:
+	/** Set in mMiddle when it has been published but not acquired */
+	static const long FRESH = 4;
+
+	/** The bits of mMiddle that hold the buffer index */
+	static const long INDEX_MASK = 3;
+
+	T				mBuffers[3];
+	long			mWriteIndex;	/**< Only used by the producer */
+	long			mReadIndex;		/**< Only used by the consumer */
+	volatile long	mMiddle;		/**< Index of the middle buffer and the FRESH flag */
+
+	// Not copyable
+	TripleBuffer(const TripleBuffer&);
+	TripleBuffer& operator=(const TripleBuffer&);
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* A vector with 2 fixed-point values, the deterministic counterpart to Vec2Float.
+*/
+
+#include "Vec2Fixed.h"
+#include "CoordinateConversion.h"
+
+using namespace utilities;
+
+Vec2Int Vec2Fixed::convertToMapCoordinates() const
+{
+	return Vec2Int(convertToMapCoordinate(x), convertToMapCoordinate(y));
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* A vector with 2 fixed-point values, the deterministic counterpart to Vec2Float.
+*/
+
+#ifndef __VEC2_FIXED_H__
+#define __VEC2_FIXED_H__
+
+#include "Vec3Fixed.h"
+
+namespace utilities
+{
+
+/**
+* A vector with 2 Q16.16 fixed-point values that mirrors the Vec2Float API.
+* @see Vec3Fixed for a vector with 3 fixed-point values
+*/
+struct Vec2Fixed
+{
+	Fixed x;
+	Fixed y;
+
+	/**
+	* Default constructor, takes a x, y coordinate.
+	* @param x x-coordinate, default is 0.
+	* @param y y-coordinate, default is 0.
+	*/
+	explicit inline Vec2Fixed(Fixed x = Fixed(), Fixed y = Fixed()) : x(x), y(y) {}
+
+	/**
+	* Converts a Vec3Fixed into a Vec2Fixed.
+	* @param vec3 the vector to convert from
+	* @param useVec3Z if we want to use the vec3's z-value as our y-value, true as default
+	*/
+	inline Vec2Fixed(const Vec3Fixed& vec3, bool useVec3Z = true) : x(vec3.x), y(useVec3Z ? vec3.z : vec3.y) {}
+
+	/**
+	* Converts a Vec2Float, use only when setting up the simulation
+	* @param vec2Float the vector to convert
+	* @return the nearest fixed-point vector
+	*/
+	static inline Vec2Fixed fromVec2Float(const Vec2Float& vec2Float)
+	{
+		return Vec2Fixed(Fixed::fromFloat(vec2Float.x), Fixed::fromFloat(vec2Float.y));
+	}
+
+	/**
+	* Converts the vector to a Vec2Float, e.g. for rendering
+	* @return the vector as a Vec2Float
+	*/
+	inline Vec2Float toVec2Float() const
+	{
+		return Vec2Float(x.toFloat(), y.toFloat());
+	}
+
+	inline bool operator==(const Vec2Fixed& vec2Fixed) const
+	{
+		return x == vec2Fixed.x && y == vec2Fixed.y;
+	}
+
+	inline bool operator!=(const Vec2Fixed& vec2Fixed) const
+	{
+		return !(*this == vec2Fixed);
+	}
+
+	inline Vec2Fixed& operator+=(const Vec2Fixed& vec2Fixed)
+	{
+		x += vec2Fixed.x;
+		y += vec2Fixed.y;
+		return *this;
+	}
+
+	inline Vec2Fixed& operator-=(const Vec2Fixed& vec2Fixed)
+	{
+		x -= vec2Fixed.x;
+		y -= vec2Fixed.y;
+		return *this;
+	}
+
+	inline Vec2Fixed operator+(const Vec2Fixed& vec2Fixed) const
+	{
+		return Vec2Fixed(x + vec2Fixed.x, y + vec2Fixed.y);
+	}
+
+	inline Vec2Fixed operator-(const Vec2Fixed& vec2Fixed) const
+	{
+		return Vec2Fixed(x - vec2Fixed.x, y - vec2Fixed.y);
+	}
+
+	inline Vec2Fixed operator*(Fixed scalar) const
+	{
+		return Vec2Fixed(x * scalar, y * scalar);
+	}
+
+	/**
+	* Calculate the dot product between this vector and vec2.
+	* @param vec2 The vector to calculate dot value of.
+	* @return the dot value of the two vectors.
+	*/
+	inline Fixed dotProduct(const Vec2Fixed& vec2) const
+	{
+		long long dot = static_cast<long long>(x.getRaw()) * vec2.x.getRaw() + static_cast<long long>(y.getRaw()) * vec2.y.getRaw();
+		return Fixed::fromRaw(static_cast<int>(dot >> Fixed::FRACTION_BITS));
+	}
+
+	/**
+	* Returns the squared length with 32 fraction bits, it can't overflow
+	* @return the squared length of the raw values
+	*/
+	inline unsigned long long getLengthSquaredRaw() const
+	{
+		return static_cast<unsigned long long>(static_cast<long long>(x.getRaw()) * x.getRaw()) +
+			static_cast<unsigned long long>(static_cast<long long>(y.getRaw()) * y.getRaw());
+	}
+
+	/**
+	* Returns the length of the vector, the length needs to be less than 32768
+	* @return length of the vector
+	*/
+	inline Fixed length() const
+	{
+		return Fixed::fromRaw(static_cast<int>(fixedMath::sqrt64(getLengthSquaredRaw())));
+	}
+
+	/**
+	* Set the length of the vector to 1, a zero vector is left as it is.
+	*/
+	inline void normalize()
+	{
+		Fixed length = this->length();
+		if (length != Fixed())
+		{
+			x /= length;
+			y /= length;
+		}
+	}
+
+	/**
+	* Test if the vector is longer than the specified length
+	* @param length the length to test with
+	* @return true if the vector is longer than 'length'
+	*/
+	inline bool longerThan(Fixed length) const
+	{
+		long long lengthRaw = length.getRaw();
+		return getLengthSquaredRaw() > static_cast<unsigned long long>(lengthRaw * lengthRaw);
+	}
+
+	/**
+	* Test if the vector is longer than the parameter vector
+	* @param vec2 the other vector to test with
+	* @return true if the vector is longer than the parameter vector
+	*/
+	inline bool longerThan(const Vec2Fixed& vec2) const
+	{
+		return getLengthSquaredRaw() > vec2.getLengthSquaredRaw();
+	}
+
+	/**
+	* Test if the vector is shorter than the specified length
+	* @param length the length to test with
+	* @return true if the vector is shorter than 'length'
+	*/
+	inline bool shorterThan(Fixed length) const
+	{
+		return !longerThan(length);
+	}
+
+	/**
+	* Test if the vector is shorter than the parameter vector
+	* @param vec2 the other vector to test with
+	* @return true if the vector is shorter than the parameter vector
+	*/
+	inline bool shorterThan(const Vec2Fixed& vec2) const
+	{
+		return !longerThan(vec2);
+	}
+
+	/**
+	* Returns the angle between 1,0 and the vector in radians, counterclockwise
+	* @return the angle in radians, between 0 and 2PI
+	* @see Vec3Fixed::getXZAngleCounterclockwise()
+	*/
+	inline Fixed getAngleCounterclockwise() const
+	{
+		return fixedMath::atan2(y.getRaw(), x.getRaw()) + fixedMath::PI;
+	}
+
+	/**
+	* Converts the vector to map coordinates, rounded down like Vec2Float::convertToMapCoordinates()
+	* @return map-coordinates
+	*/
+	Vec2Int convertToMapCoordinates() const;
+
+	/**
+	* Returns a string with information about the vector in a more human readable way.
+	* @return string with the vector information
+	*/
+	inline std::string toString() const
+	{
+		return toVec2Float().toString();
+	}
+};
+}
+
+#endif
\ No newline at end of file
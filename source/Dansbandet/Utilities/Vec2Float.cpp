@@ -19,6 +19,7 @@
 */
 
 #include "Vectors.h"
+#include "CoordinateConversion.h"
 #include <cmath>
 
 using namespace utilities;
@@ -31,60 +32,12 @@ Vec2Float::Vec2Float(const Vec3Float& vec3, bool useVec3Z) : x(vec3.x), y(vec3.z
 	}
 }
 
-Vec2Float::Vec2Float(const Vec2Int& vec2Int) : x(static_cast<float>(vec2Int.x)), y(static_cast<float>(vec2Int.y))
-{
-}
-
-Vec2Float& Vec2Float::operator =(const utilities::Vec2Float &vec2)
-{
-	x = vec2.x;
-	y = vec2.y;
-	return *this;
-}
-
-Vec2Float Vec2Float::operator *(float scalar) const
-{
-	Vec2Float newVector = *this;
-	newVector.x *= scalar;
-	newVector.y *= scalar;
-	return newVector;
-}
-
-Vec2Float Vec2Float::operator -(const Vec2Float &vec2Float) const
-{
-	Vec2Float newVector = *this;
-	newVector.x -= vec2Float.x;
-	newVector.y -= vec2Float.y;
-	return newVector;
-}
-
-Vec2Float Vec2Float::operator -(const Vec2Int &vec2Int) const
-{
-	return Vec2Float(x - static_cast<float>(vec2Int.x), y - static_cast<float>(vec2Int.y));
-}
-
 Vec2Float Vec2Float::operator -(const Vec3Float &vec3Float) const
 {
 	return Vec2Float(x - vec3Float.x, y - vec3Float.z);
 }
 
-float Vec2Float::length() const
-{
-	return sqrtf(x*x + y*y);
-}
-
-bool Vec2Float::longerThan(float length) const
-{
-	return (x*x + y*y) > (length * length);
-}
-
-bool Vec2Float::longerThan(const Vec2Float& vec2) const
-{
-	return (x*x + y*y) > (vec2.x*vec2.x + vec2.y*vec2.y);
-}
-
 Vec2Int Vec2Float::convertToMapCoordinates() const
 {
-	Vec2Int newVector(static_cast<int>(x*MAP_IN_WORLD_COORDS), static_cast<int>(y*MAP_IN_WORLD_COORDS));
-	return newVector;
+	return Vec2Int(convertToMapCoordinate(x), convertToMapCoordinate(y));
 }
\ No newline at end of file
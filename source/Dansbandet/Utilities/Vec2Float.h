@@ -22,14 +22,15 @@
 #define __VEC2_FLOAT_H__
 
 #include "Macros.h"
+#include "Vec2Int.h"
 
 #include <iomanip>
+#include <cmath>
 
 namespace utilities
 {
 
 // Forward declarations
-struct Vec2Int;
 struct Vec3Float;
 
 /**
@@ -59,35 +60,49 @@ typedef struct Vec2Float
 	* Converts a Vec2Int into a Vec2Float.
 	* @param vec2Int the vector to convert from
 	*/
-	Vec2Float(const Vec2Int& vec2Int);
+	inline Vec2Float(const Vec2Int& vec2Int) : x(static_cast<float>(vec2Int.x)), y(static_cast<float>(vec2Int.y)) {}
 
 	/**
 	* Sets the vector and returns a reference to it
 	* @param vec2 the vectors to copy
 	* @return reference to the vector
 	*/
-	Vec2Float& operator=(const Vec2Float& vec2);
+	inline Vec2Float& operator=(const Vec2Float& vec2)
+	{
+		x = vec2.x;
+		y = vec2.y;
+		return *this;
+	}
 
 	/**
 	* Scalar multiplication, returns a new vector
 	* @param scalar the value to multiply the vector with
 	* @return new vector with the scalar multiplication applied
 	*/
-	Vec2Float operator*(float scalar) const;
+	inline Vec2Float operator*(float scalar) const
+	{
+		return Vec2Float(x * scalar, y * scalar);
+	}
 
 	/**
 	* Returns the difference between the two vectors
 	* @param vec2Float the right-sided vector
 	* @return new difference vector
 	*/
-	Vec2Float operator-(const Vec2Float& vec2Float) const;
+	inline Vec2Float operator-(const Vec2Float& vec2Float) const
+	{
+		return Vec2Float(x - vec2Float.x, y - vec2Float.y);
+	}
 
 	/**
 	* Returns the difference between the two vectors
 	* @param vec2Int the right-sided vector
 	* @return new difference vector as a Vec2Float
 	*/
-	Vec2Float operator-(const Vec2Int& vec2Int) const;
+	inline Vec2Float operator-(const Vec2Int& vec2Int) const
+	{
+		return Vec2Float(x - static_cast<float>(vec2Int.x), y - static_cast<float>(vec2Int.y));
+	}
 
 	/**
 	* Returns the difference between the two vectors
@@ -101,21 +116,30 @@ typedef struct Vec2Float
 	* @return length of the vector
 	* @note use longerThan or shorterThan when testing differences
 	*/
-	float length() const;
+	inline float length() const
+	{
+		return sqrtf(x*x + y*y);
+	}
 	
 	/**
 	* Test if the vector is longer than the specified length
 	* @param length the length to test with
 	* @return true if the vector is longer than 'length'
 	*/
-	bool longerThan(float length) const;
+	inline bool longerThan(float length) const
+	{
+		return (x*x + y*y) > (length * length);
+	}
 
 	/**
 	* Test if the vector is longer than the parameter vector
 	* @param vec2 the other vector to test with
 	* @return true if the vector is longer than the parameter vector
 	*/
-	bool longerThan(const Vec2Float& vec2) const;
+	inline bool longerThan(const Vec2Float& vec2) const
+	{
+		return (x*x + y*y) > (vec2.x*vec2.x + vec2.y*vec2.y);
+	}
 
 	/**
 	* Test if the vector is shorter than the specified length
@@ -140,6 +164,7 @@ typedef struct Vec2Float
 	/**
 	* Converts the vector to map coordinates
 	* @return map-coordinates
+	* @see convertToMapCoordinates() in CoordinateConversion.h for batches
 	*/
 	Vec2Int convertToMapCoordinates() const;
 
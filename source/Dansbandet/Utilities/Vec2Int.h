@@ -51,14 +51,20 @@ typedef struct Vec2Int
 	* @param vec2Int the vector to compare with
 	* @return true if the vectors are equal
 	*/
-	bool operator==(const Vec2Int& vec2Int) const;
+	inline bool operator==(const Vec2Int& vec2Int) const
+	{
+		return (x == vec2Int.x && y == vec2Int.y);
+	}
 
 	/**
 	* Differ operator
 	* @param vec2Int the vector to compare with
 	* @return true if the vectors differ
 	*/
-	bool operator!=(const Vec2Int& vec2Int) const;
+	inline bool operator!=(const Vec2Int& vec2Int) const
+	{
+		return (x != vec2Int.x || y != vec2Int.y);
+	}
 
 	/**
 	* Tests if a vector is less than the specified vector
@@ -72,14 +78,20 @@ typedef struct Vec2Int
 	* @param vec2Int the right-sided vector
 	* @return new difference vector
 	*/
-	Vec2Int operator-(const Vec2Int& vec2Int) const;
+	inline Vec2Int operator-(const Vec2Int& vec2Int) const
+	{
+		return Vec2Int(x - vec2Int.x, y - vec2Int.y);
+	}
 
 	/**
 	* Return the addition between the two vectors as a new vector.
 	* @param vec2Int the right-sided vector
 	* @return new difference vector
 	*/
-	Vec2Int operator+(const Vec2Int& vec2Int) const;
+	inline Vec2Int operator+(const Vec2Int& vec2Int) const
+	{
+		return Vec2Int(x + vec2Int.x, y + vec2Int.y);
+	}
 
 	/**
 	* Bit operator that returns a new vector where the x and y values
@@ -100,35 +112,56 @@ typedef struct Vec2Int
 	* @param value the value to add to the x, and y values.
 	* @return reference to the current vector
 	*/
-	Vec2Int& operator+=(int value);
+	inline Vec2Int& operator+=(int value)
+	{
+		x += value;
+		y += value;
+		return *this;
+	}
 
 	/**
 	* Increments the vector with the specified vector
 	* @param vec2Int the right-sided vector
 	* @return reference to the vector
 	*/
-	Vec2Int& operator+=(const Vec2Int& vec2Int);
+	inline Vec2Int& operator+=(const Vec2Int& vec2Int)
+	{
+		x += vec2Int.x;
+		y += vec2Int.y;
+		return *this;
+	}
 
 	/**
 	* Decrements the vector with the specified vector
 	* @param vec2Int the right-sided vector
 	* @return reference to the vector
 	*/
-	Vec2Int& operator-=(const Vec2Int& vec2Int);
+	inline Vec2Int& operator-=(const Vec2Int& vec2Int)
+	{
+		x -= vec2Int.x;
+		y -= vec2Int.y;
+		return *this;
+	}
 
 	/**
 	* Test if the vector is longer than the specified length
 	* @param length the length to test with
 	* @return true if the vector is longer than 'length'
 	*/
-	bool longerThan(int length) const;
+	inline bool longerThan(int length) const
+	{
+		return (x*x + y*y) > (length*length);
+	}
 
 	/**
 	* Test if the vector is longer than the parameter vector
 	* @param vec2Int the other vector to test with
 	* @return true if the vector is longer than the parameter vector
 	*/
-	bool longerThan(const Vec2Int& vec2Int) const;
+	inline bool longerThan(const Vec2Int& vec2Int) const
+	{
+		return (x*x + y*y) > (vec2Int.x*vec2Int.x + vec2Int.y*vec2Int.y);
+	}
 
 	/**
 	* Test if the vector is shorter than the specified length
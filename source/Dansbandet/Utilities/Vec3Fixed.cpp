@@ -0,0 +1,74 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* A vector with 3 fixed-point values, the deterministic counterpart to Vec3Float.
+*/
+
+#include "Vec3Fixed.h"
+#include "CoordinateConversion.h"
+
+using namespace utilities;
+
+void Vec3Fixed::rotateAroundY(Fixed radian)
+{
+	Fixed sine;
+	Fixed cosine;
+	fixedMath::sinCos(radian, sine, cosine);
+	rotateAroundY(sine, cosine);
+}
+
+void Vec3Fixed::normalize()
+{
+	Fixed length = this->length();
+	if (length != Fixed())
+	{
+		x /= length;
+		y /= length;
+		z /= length;
+	}
+}
+
+Vec2Int Vec3Fixed::convertToMapCoordinates() const
+{
+	return Vec2Int(convertToMapCoordinate(x), convertToMapCoordinate(z));
+}
+
+Vec3Fixed Vec3Fixed::fromMapCoordinates(const Vec2Int& mapCoordinates)
+{
+	return Vec3Fixed(convertToFixedWorldCoordinate(mapCoordinates.x), Fixed(), convertToFixedWorldCoordinate(mapCoordinates.y));
+}
+
+Fixed Vec3Fixed::getXZAngleCounterclockwise() const
+{
+	return fixedMath::atan2(z.getRaw(), x.getRaw()) + fixedMath::PI;
+}
+
+Fixed Vec3Fixed::getZXAngleClockwise() const
+{
+	return fixedMath::atan2(x.getRaw(), z.getRaw()) + fixedMath::PI;
+}
+
+Fixed Vec3Fixed::getAngleBetweenVectors(const Vec3Fixed& vector) const
+{
+	long long cross = static_cast<long long>(x.getRaw()) * vector.z.getRaw() - static_cast<long long>(z.getRaw()) * vector.x.getRaw();
+	long long dot = static_cast<long long>(x.getRaw()) * vector.x.getRaw() + static_cast<long long>(z.getRaw()) * vector.z.getRaw();
+	return fixedMath::atan2(cross < 0 ? -cross : cross, dot);
+}
\ No newline at end of file
@@ -0,0 +1,301 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* A vector with 3 fixed-point values, the deterministic counterpart to Vec3Float.
+*/
+
+#ifndef __VEC3_FIXED_H__
+#define __VEC3_FIXED_H__
+
+#include "Fixed.h"
+#include "Vectors.h"
+
+namespace utilities
+{
+
+/**
+* A vector with 3 Q16.16 fixed-point values that mirrors the Vec3Float API. All
+* operations give bit-exact results on all platforms, use it for the simulation
+* state in lockstep multiplayer and convert to Vec3Float for rendering.
+* @see Vec2Fixed for a vector with 2 fixed-point values
+*/
+struct Vec3Fixed
+{
+	Fixed x;
+	Fixed y;
+	Fixed z;
+
+	/**
+	* Default constructor that takes optional parameters.
+	* @param x Sets the x value, default 0
+	* @param y Sets the y value, default 0
+	* @param z Sets the z value, default 0
+	*/
+	explicit inline Vec3Fixed(Fixed x = Fixed(), Fixed y = Fixed(), Fixed z = Fixed()) : x(x), y(y), z(z) {}
+
+	/**
+	* Converts a Vec3Float, use only when setting up the simulation
+	* @param vec3Float the vector to convert
+	* @return the nearest fixed-point vector
+	*/
+	static inline Vec3Fixed fromVec3Float(const Vec3Float& vec3Float)
+	{
+		return Vec3Fixed(Fixed::fromFloat(vec3Float.x), Fixed::fromFloat(vec3Float.y), Fixed::fromFloat(vec3Float.z));
+	}
+
+	/**
+	* Converts the vector to a Vec3Float, e.g. for rendering
+	* @return the vector as a Vec3Float
+	*/
+	inline Vec3Float toVec3Float() const
+	{
+		return Vec3Float(x.toFloat(), y.toFloat(), z.toFloat());
+	}
+
+	inline bool operator==(const Vec3Fixed& vec3Fixed) const
+	{
+		return x == vec3Fixed.x && y == vec3Fixed.y && z == vec3Fixed.z;
+	}
+
+	inline bool operator!=(const Vec3Fixed& vec3Fixed) const
+	{
+		return !(*this == vec3Fixed);
+	}
+
+	inline Vec3Fixed& operator+=(const Vec3Fixed& vec3Fixed)
+	{
+		x += vec3Fixed.x;
+		y += vec3Fixed.y;
+		z += vec3Fixed.z;
+		return *this;
+	}
+
+	inline Vec3Fixed& operator-=(const Vec3Fixed& vec3Fixed)
+	{
+		x -= vec3Fixed.x;
+		y -= vec3Fixed.y;
+		z -= vec3Fixed.z;
+		return *this;
+	}
+
+	inline Vec3Fixed& operator*=(Fixed value)
+	{
+		x *= value;
+		y *= value;
+		z *= value;
+		return *this;
+	}
+
+	inline Vec3Fixed operator+(const Vec3Fixed& vec3Fixed) const
+	{
+		return Vec3Fixed(x + vec3Fixed.x, y + vec3Fixed.y, z + vec3Fixed.z);
+	}
+
+	inline Vec3Fixed operator-(const Vec3Fixed& vec3Fixed) const
+	{
+		return Vec3Fixed(x - vec3Fixed.x, y - vec3Fixed.y, z - vec3Fixed.z);
+	}
+
+	inline Vec3Fixed operator*(Fixed value) const
+	{
+		return Vec3Fixed(x * value, y * value, z * value);
+	}
+
+	/**
+	* Rotate the vector around y.
+	* @param radian The angle to rotate in radians.
+	*/
+	void rotateAroundY(Fixed radian);
+
+	/**
+	* Rotate the vector around y with a precalculated sine and cosine
+	* @param sine the sine of the angle to rotate
+	* @param cosine the cosine of the angle to rotate
+	*/
+	inline void rotateAroundY(Fixed sine, Fixed cosine)
+	{
+		Fixed tempX = cosine * x - sine * z;
+		z = sine * x + cosine * z;
+		x = tempX;
+	}
+
+	/**
+	* Set the length of the vector to 1, a zero vector is left as it is.
+	*/
+	void normalize();
+
+	/**
+	* Calculate the dot product between this vector and vec3. The products are
+	* summed with 64 bits before the result is rounded.
+	* @param vec3 The vector to calculate dot value of.
+	* @return the dot value of the two vectors.
+	*/
+	inline Fixed dotProduct(const Vec3Fixed& vec3) const
+	{
+		long long dot = static_cast<long long>(x.getRaw()) * vec3.x.getRaw() +
+			static_cast<long long>(y.getRaw()) * vec3.y.getRaw() +
+			static_cast<long long>(z.getRaw()) * vec3.z.getRaw();
+		return Fixed::fromRaw(static_cast<int>(dot >> Fixed::FRACTION_BITS));
+	}
+
+	/**
+	* Returns the squared length with 32 fraction bits, it can't overflow
+	* @param useY if we want to use the y-coordinate or not, default is true
+	* @return the squared length of the raw values
+	*/
+	inline unsigned long long getLengthSquaredRaw(bool useY = true) const
+	{
+		long long lengthSq = static_cast<long long>(x.getRaw()) * x.getRaw() + static_cast<long long>(z.getRaw()) * z.getRaw();
+		if (useY)
+		{
+			return static_cast<unsigned long long>(lengthSq) + static_cast<unsigned long long>(static_cast<long long>(y.getRaw()) * y.getRaw());
+		}
+		return static_cast<unsigned long long>(lengthSq);
+	}
+
+	/**
+	* Returns the length of the vector, the length needs to be less than 32768
+	* @return the length of the vector
+	*/
+	inline Fixed length() const
+	{
+		return Fixed::fromRaw(static_cast<int>(fixedMath::sqrt64(getLengthSquaredRaw())));
+	}
+
+	/**
+	* Test if the vector is longer than the specified length
+	* @param length the length to test with
+	* @param useY if we want to use the y-coordinate or not, default is true
+	* @return true if the vector is longer than 'length'
+	*/
+	inline bool longerThan(Fixed length, bool useY = true) const
+	{
+		long long lengthRaw = length.getRaw();
+		return getLengthSquaredRaw(useY) > static_cast<unsigned long long>(lengthRaw * lengthRaw);
+	}
+
+	/**
+	* Test if the vector is longer than the parameter vector
+	* @param vec3 the other vector to test with
+	* @param useY if we want to use the y-coordinate or not, default is true
+	* @return true if the vector is longer than the parameter vector
+	*/
+	inline bool longerThan(const Vec3Fixed& vec3, bool useY = true) const
+	{
+		return getLengthSquaredRaw(useY) > vec3.getLengthSquaredRaw(useY);
+	}
+
+	/**
+	* Test if the vector is shorter than the specified length
+	* @param length the length to test with
+	* @param useY if we want to use the y-coordinate or not, default is true
+	* @return true if the vector is shorter than 'length'
+	*/
+	inline bool shorterThan(Fixed length, bool useY = true) const
+	{
+		return !longerThan(length, useY);
+	}
+
+	/**
+	* Test if the vector is shorter than the parameter vector
+	* @param vec3 the other vector to test with
+	* @param useY if we want to use the y-coordinate or not, default is true
+	* @return true if the vector is shorter than the parameter vector
+	*/
+	inline bool shorterThan(const Vec3Fixed& vec3, bool useY = true) const
+	{
+		return !longerThan(vec3, useY);
+	}
+
+	/**
+	* Converts the vector to map coordinates, rounded down like Vec3Float::convertToMapCoordinates()
+	* @return map-coordinates
+	*/
+	Vec2Int convertToMapCoordinates() const;
+
+	/**
+	* Creates a vector at the center of a map coordinate, y is set to 0
+	* @param mapCoordinates the map coordinates
+	* @return the world coordinates
+	* @see Vec2Int::convertToWorldCoordinates()
+	*/
+	static Vec3Fixed fromMapCoordinates(const Vec2Int& mapCoordinates);
+
+	/**
+	* Returns the current angle between 1,0 and X,Z in radians in a counterclockwise manner
+	* @return current angle between 1,0 and X,Z in radians, between 0 and 2PI, counterclockwise
+	*/
+	Fixed getXZAngleCounterclockwise() const;
+
+	/**
+	* Returns the current angle between 1,0 and X,Z in radians in a clockwise manner
+	* @return current angle between 1,0 and X,Z in radians, between 0 and 2PI, clockwise
+	*/
+	inline Fixed getXZAngleClockwise() const
+	{
+		return fixedMath::PI_TWO - getXZAngleCounterclockwise();
+	}
+
+	/**
+	* Returns the current angle between 0,1 and X,Z in radians, clockwise
+	* @return current angle between 0,1 and X,Z in radians, between 0 AND 2PI, clockwise
+	*/
+	Fixed getZXAngleClockwise() const;
+
+	/**
+	* Returns the current angle between 0,1 and X,Z in radians, counterclockwise
+	* @return current angle between 0,1 and X,Z in radians, between 0 AND 2PI, counterclockwise
+	*/
+	inline Fixed getZXAngleCounterclockwise() const
+	{
+		return fixedMath::PI_TWO - getZXAngleClockwise();
+	}
+
+	/**
+	* Returns the smallest angle between this vector and an other in the XZ-plane.
+	* @param vector The vector to compare angle with.
+	* @return the smallest angle between the two vectors, between 0 and PI.
+	*/
+	Fixed getAngleBetweenVectors(const Vec3Fixed& vector) const;
+
+	/**
+	* Tests if a vector is counterclockwise from this vector in the XZ-plane
+	* @param vec3 the other vector
+	* @return true if vec3 is less than PI counterclockwise from this vector
+	* @see Vec3Float::isCounterclockwiseXZ()
+	*/
+	inline bool isCounterclockwiseXZ(const Vec3Fixed& vec3) const
+	{
+		return static_cast<long long>(x.getRaw()) * vec3.z.getRaw() > static_cast<long long>(z.getRaw()) * vec3.x.getRaw();
+	}
+
+	/**
+	* Returns a string with information about the vector in a more human readable way.
+	* @return string with the vector information
+	*/
+	inline std::string toString() const
+	{
+		return toVec3Float().toString();
+	}
+};
+}
+
+#endif
\ No newline at end of file
@@ -20,6 +20,8 @@
 */
 
 #include "Vectors.h"
+#include "CoordinateConversion.h"
+#include "FastMath.h"
 #include "Constants.h"
 #include <D3DX10MATH.h>
 #include <cmath>
@@ -31,137 +33,29 @@ const Vec3Float utilities::INVALID_WORLD_POSITON(FLT_MAX, FLT_MAX, FLT_MAX);
 
 void Vec3Float::rotateAroundY(float radian)
 {
-	float tempX = cos(radian) * x - sin(radian) * z;
-	z = sin(radian) * x + cos(radian) * z;
-	x = tempX;
-}
-
-void Vec3Float::normalize()
-{
-	float length = this->length();
-	if (length != 0.0f)
-	{
-		x /= length;
-		y /= length;
-		z /= length;
-	}
-}
-
-float Vec3Float::dotProduct(float x, float y, float z)
-{
-	return this->x*x + this->y*y + this->z*z;
-}
-
-float Vec3Float::dotProduct(const Vec3Float& vec3) const
-{
-	return x*vec3.x + y*vec3.y + z*vec3.z;
-}
-
-float Vec3Float::length() const
-{
-	return sqrtf(x*x + y*y + z*z);
-}
-
-bool Vec3Float::longerThan(float length, bool useY) const
-{
-	if(useY)
-	{
-		return x*x + y*y + z*z > length * length;
-	}
-	else
-	{
-		return  x*x + z*z > length * length;
-	}
-}
-
-bool Vec3Float::longerThan(const Vec3Float& vec3, bool useY) const
-{
-	if(useY)
-	{
-		return (x*x + y*y + z*z) > (vec3.x*vec3.x + vec3.y*vec3.y + vec3.z*vec3.z);
-	}
-	else
-	{
-		return  x*x + z*z > (vec3.x*vec3.x + vec3.z*vec3.z);
-	}
-}
-
-Vec3Float Vec3Float::operator-(const Vec3Float& vec3) const
-{
-	Vec3Float diffVector = *this;
-	diffVector.x -= vec3.x;
-	diffVector.y -= vec3.y;
-	diffVector.z -= vec3.z;
-	return diffVector;
-}
-
-Vec3Float Vec3Float::operator +(const Vec3Float &vec3Float) const
-{
-	Vec3Float sumVec = *this;
-	sumVec.x += vec3Float.x;
-	sumVec.y += vec3Float.y;
-	sumVec.z += vec3Float.z;
-	return sumVec;
-}
-
-Vec3Float Vec3Float::operator *(float fValue) const
-{
-	Vec3Float productVec = *this;
-	productVec.x *= fValue;
-	productVec.y *= fValue;
-	productVec.z *= fValue;
-	return productVec;
+	float sine = 0.0f;
+	float cosine = 0.0f;
+	math::fastSinCos(radian, sine, cosine);
+	rotateAroundY(sine, cosine);
 }
 
 Vec2Int Vec3Float::convertToMapCoordinates() const
 {
-	Vec2Int newVector(static_cast<int>(x*WORLD_IN_MAP_COORDS), static_cast<int>(z*WORLD_IN_MAP_COORDS));
-	// Fix negative offset
-	if (x < 0.0f)
-	{
-		newVector.x--;
-	}
-	if (z < 0.0f)
-	{
-		newVector.y--;
-	}
-	return newVector;
+	return Vec2Int(convertToMapCoordinate(x), convertToMapCoordinate(z));
 }
 
 float Vec3Float::getXZAngleCounterclockwise() const
 {
-	// Because we compare with the (1,0) vector we don't have to multiply
-	// the y coordinate for the dot product and thus the x value will be the
-	// dot-product
-	float angle = 0.0f;
-	if (z < 0.0f)
-	{
-		angle = acosf(-x);
-	}
-	else
-	{
-		angle = acosf(x) + math::PI;
-	}
-
-	return angle;
+	// Same angles as the old acosf(-x) for z < 0 and acosf(x) + PI otherwise,
+	// but the vector doesn't have to be normalized.
+	return math::fastAtan2(z, x) + math::PI;
 }
 
 float Vec3Float::getZXAngleClockwise() const
 {
-	// Because we compare with the (0,1) vector we don't have to multiply
-	// the x coordinate for the dot product and thus the z value will be the
-	// dot-product
-	float angle = 0.0f;
-	if (x < 0.0f)
-	{
-		angle = acosf(-z);
-	}
-	else
-	{
-		angle = acosf(z) + math::PI;
-	}
-
-	return angle;
+	// Same angles as the old acosf(-z) for x < 0 and acosf(z) + PI otherwise,
+	// but the vector doesn't have to be normalized.
+	return math::fastAtan2(x, z) + math::PI;
 }
 
 D3DXVECTOR3 Vec3Float::convertToD3DXVECTOR3() const
@@ -171,12 +65,9 @@ D3DXVECTOR3 Vec3Float::convertToD3DXVECTOR3() const
 
 float Vec3Float::getAngleBetweenVectors(Vec3Float vector) const
 {
-	float angle = fabsf(this->getXZAngleClockwise() - vector.getXZAngleClockwise());
-	if(angle > math::PI)
-	{
-		angle -= math::PI;
-	}
-	return angle;
+	// atan2(|a x b|, a . b) is the smallest angle and is precise for both small
+	// and large angles, unlike the difference between two absolute angles.
+	return math::fastAtan2(fabsf(getXZCrossProduct(vector)), x*vector.x + z*vector.z);
 }
 
 std::istream& operator>>(std::istream &in, utilities::Vec3Float& vec3Float)
@@ -188,13 +79,4 @@ std::ostream& operator<<(std::ostream &out, const utilities::Vec3Float& vec3Floa
 {
 	out << vec3Float.x << " " << vec3Float.y << " " << vec3Float.z << " ";
 	return out;
-}
-
-utilities::Vec3Float operator*(float fValue, const utilities::Vec3Float& vec3Float)
-{
-	Vec3Float productVec = vec3Float;
-	productVec.x *= fValue;
-	productVec.y *= fValue;
-	productVec.z *= fValue;
-	return productVec;
 }
\ No newline at end of file
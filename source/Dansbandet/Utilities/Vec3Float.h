@@ -25,6 +25,7 @@
 #include "Macros.h"
 #include "Constants.h"
 #include <sstream>
+#include <cmath>
 
 // Forward declaration
 struct D3DXVECTOR3;
@@ -104,32 +105,64 @@ typedef struct Vec3Float
 	* @param vec3 the vector to subtract from the original vector
 	* @return difference vector between right - left
 	*/
-	Vec3Float operator-(const Vec3Float& vec3) const;
+	inline Vec3Float operator-(const Vec3Float& vec3) const
+	{
+		return Vec3Float(x - vec3.x, y - vec3.y, z - vec3.z);
+	}
 
 	/**
 	* Returns a new Vec3Float with the sum of the two vectors
 	* @param vec3Float the vector to add from the original vector
 	* @return new Vec3Float with the sum of the two vectors
 	*/
-	Vec3Float operator+(const Vec3Float& vec3Float) const;
+	inline Vec3Float operator+(const Vec3Float& vec3Float) const
+	{
+		return Vec3Float(x + vec3Float.x, y + vec3Float.y, z + vec3Float.z);
+	}
 
 	/**
 	* Returns a new Vec3Float with the multiplied value of the float
 	* @param fValue the value to multiply with the elements in the vector
 	* @return new Vec3Float with the multiplied value of the float
 	*/
-	Vec3Float operator*(float fValue) const;
+	inline Vec3Float operator*(float fValue) const
+	{
+		return Vec3Float(x * fValue, y * fValue, z * fValue);
+	}
 
 	/**
 	* Rotate the vector around y.
 	* @param radian The angle to rotate in radians.
+	* @note uses math::fastSinCos(), see FastMath.h for the error bounds
 	*/
 	void rotateAroundY(float radian);
 
+	/**
+	* Rotate the vector around y with a precalculated sine and cosine, use this
+	* when rotating several vectors with the same angle.
+	* @param sine the sine of the angle to rotate
+	* @param cosine the cosine of the angle to rotate
+	*/
+	inline void rotateAroundY(float sine, float cosine)
+	{
+		float tempX = cosine * x - sine * z;
+		z = sine * x + cosine * z;
+		x = tempX;
+	}
+
 	/**
 	* Set the length of the vector to 1.
 	*/
-	void normalize();
+	inline void normalize()
+	{
+		float length = this->length();
+		if (length != 0.0f)
+		{
+			x /= length;
+			y /= length;
+			z /= length;
+		}
+	}
 
 	/**
 	* Calculate the dot product between this vector and the parameter vector.
@@ -138,20 +171,29 @@ typedef struct Vec3Float
 	* @param z The z value of the vector.
 	* @return the dot value of the two vectors.
 	*/
-	float dotProduct(float x, float y, float z);
+	inline float dotProduct(float x, float y, float z) const
+	{
+		return this->x*x + this->y*y + this->z*z;
+	}
 
 	/**
 	* Calculate the dot product between this vector and vec.
 	* @param vec3 The vector to calculate dot value of.
 	* @return the dot value of the two vectors.
 	*/
-	float dotProduct(const Vec3Float& vec3) const;
+	inline float dotProduct(const Vec3Float& vec3) const
+	{
+		return x*vec3.x + y*vec3.y + z*vec3.z;
+	}
 
 	/**
 	* Returns the length of the vector
 	* @return the length of the vector
 	*/
-	float length() const;
+	inline float length() const
+	{
+		return sqrtf(x*x + y*y + z*z);
+	}
 
 	/**
 	* Test if the vector is longer than the specified length
@@ -159,7 +201,17 @@ typedef struct Vec3Float
 	* @param useY if we want to use the y-coordinate or not, default is true
 	* @return true if the vector is longer than 'length'
 	*/
-	bool longerThan(float length, bool useY = true) const;
+	inline bool longerThan(float length, bool useY = true) const
+	{
+		if (useY)
+		{
+			return x*x + y*y + z*z > length * length;
+		}
+		else
+		{
+			return x*x + z*z > length * length;
+		}
+	}
 
 	/**
 	* Test if the vector is longer than the parameter vector
@@ -167,7 +219,17 @@ typedef struct Vec3Float
 	* @param useY if we want to use the y-coordinate or not, default is true
 	* @return true if the vector is longer than the parameter vector
 	*/
-	bool longerThan(const Vec3Float& vec3, bool useY = true) const;
+	inline bool longerThan(const Vec3Float& vec3, bool useY = true) const
+	{
+		if (useY)
+		{
+			return (x*x + y*y + z*z) > (vec3.x*vec3.x + vec3.y*vec3.y + vec3.z*vec3.z);
+		}
+		else
+		{
+			return x*x + z*z > (vec3.x*vec3.x + vec3.z*vec3.z);
+		}
+	}
 
 	/**
 	* Test if the vector is shorter than the specified length
@@ -194,12 +256,15 @@ typedef struct Vec3Float
 	/**
 	* Converts the vector to map coordinates
 	* @return map-coordinates
+	* @see convertToMapCoordinates() in CoordinateConversion.h for batches
 	*/
 	Vec2Int convertToMapCoordinates() const;
 
 	/**
 	* Returns the current angle between 1,0 and X,Z in radians in a counterclockwise manner
 	* @return current angle between 1,0 and X,Z in radians, between 0 and 2PI, counterclockwise
+	* @note uses math::fastAtan2(), see FastMath.h for the error bounds. Prefer the
+	* direction comparisons, e.g. isCounterclockwiseXZ(), when you only compare angles.
 	*/
 	float getXZAngleCounterclockwise() const;
 
@@ -216,6 +281,7 @@ typedef struct Vec3Float
 	* Returns the current angle between 0,1 and X,Z in radians, clockwise
 	* Used for rotating meshes
 	* @return current angle between 0,1 and X,Z in radians, between 0 AND 2PI, clockwise
+	* @note uses math::fastAtan2(), see FastMath.h for the error bounds
 	*/
 	float getZXAngleClockwise() const;
 
@@ -248,12 +314,91 @@ typedef struct Vec3Float
 	D3DXVECTOR3 convertToD3DXVECTOR3() const;
 
 	/**
-	* Returns the smallest angle between this vector and an other.
+	* Returns the smallest angle between this vector and an other in the XZ-plane.
 	* @param vector The vector to compare angle with.
-	* @return the smallest angle between the two vectors.
+	* @return the smallest angle between the two vectors, between 0 and PI.
+	* @note uses math::fastAtan2(), see FastMath.h for the error bounds
 	*/
 	float getAngleBetweenVectors(Vec3Float vector) const;
 
+	/**
+	* Returns the y-value of the cross product in the XZ-plane, i.e. the sign tells
+	* which side of this vector the other vector is on.
+	* @param vec3 the other vector
+	* @return positive if vec3 is counterclockwise from this vector, negative if
+	* clockwise and 0 if they are parallel
+	*/
+	inline float getXZCrossProduct(const Vec3Float& vec3) const
+	{
+		return x*vec3.z - z*vec3.x;
+	}
+
+	/**
+	* Tests if a vector is counterclockwise from this vector in the XZ-plane,
+	* in the same direction as getXZAngleCounterclockwise(). Doesn't use any
+	* trigonometric functions.
+	* @param vec3 the other vector
+	* @return true if vec3 is less than PI counterclockwise from this vector
+	*/
+	inline bool isCounterclockwiseXZ(const Vec3Float& vec3) const
+	{
+		return getXZCrossProduct(vec3) > 0.0f;
+	}
+
+	/**
+	* Tests if the angle between this vector and a direction in the XZ-plane is
+	* within a maximum angle, e.g. if a target is inside a turret's field of view.
+	* Neither vector needs to be normalized and no trigonometric functions or
+	* square roots are used.
+	* @param direction the direction to test with
+	* @param cosMaxAngle the cosine of the maximum angle, precalculate it once
+	* @return true if the angle is less than or equal to the maximum angle
+	*/
+	inline bool isWithinAngleXZ(const Vec3Float& direction, float cosMaxAngle) const
+	{
+		// dot >= cos * |a| * |b|, squared with the signs taken care of
+		float dot = x*direction.x + z*direction.z;
+		float lengthsSq = (x*x + z*z) * (direction.x*direction.x + direction.z*direction.z);
+		float dotSq = dot * dot;
+		float cosSq = cosMaxAngle * cosMaxAngle;
+		if (cosMaxAngle >= 0.0f)
+		{
+			return dot >= 0.0f && dotSq >= cosSq * lengthsSq;
+		}
+		else
+		{
+			return dot >= 0.0f || dotSq <= cosSq * lengthsSq;
+		}
+	}
+
+	/**
+	* Tests which of two vectors has the smallest angle to this vector in the
+	* XZ-plane, without trigonometric functions or square roots.
+	* @param first the first vector
+	* @param second the second vector
+	* @return true if first has a smaller angle to this vector than second
+	*/
+	inline bool isCloserInAngleXZ(const Vec3Float& first, const Vec3Float& second) const
+	{
+		// cos(first) > cos(second) <=> firstDot * |second| > secondDot * |first|
+		float firstDot = x*first.x + z*first.z;
+		float secondDot = x*second.x + z*second.z;
+		float firstSide = firstDot * firstDot * (second.x*second.x + second.z*second.z);
+		float secondSide = secondDot * secondDot * (first.x*first.x + first.z*first.z);
+		if (firstDot >= 0.0f && secondDot >= 0.0f)
+		{
+			return firstSide > secondSide;
+		}
+		else if (firstDot < 0.0f && secondDot < 0.0f)
+		{
+			return firstSide < secondSide;
+		}
+		else
+		{
+			return firstDot >= 0.0f;
+		}
+	}
+
 } Direction, Position;
 
 }
@@ -280,6 +425,9 @@ std::ostream& operator<<(std::ostream &out, const utilities::Vec3Float& vec3Floa
 * @param vec3Float the vector to multiply with
 * @return a new Vec3Float with the vec3Float's value multiplied with fValue
 */
-utilities::Vec3Float operator*(float fValue, const utilities::Vec3Float& vec3Float);
+inline utilities::Vec3Float operator*(float fValue, const utilities::Vec3Float& vec3Float)
+{
+	return vec3Float * fValue;
+}
 
 #endif
\ No newline at end of file
@@ -0,0 +1,358 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* An array of Vec3Float stored as structure of arrays, i.e. one array with all
+* x-values, one with all y-values and one with all z-values. This makes it
+* possible to operate on four vectors at a time with SSE.
+*/
+
+#include "Vec3FloatArray.h"
+#include "FastMath.h"
+#include <xmmintrin.h>
+#include <cmath>
+#include <new>
+
+using namespace utilities;
+
+Vec3FloatArray::Vec3FloatArray(int size)
+{
+	mpX = NULL;
+	mpY = NULL;
+	mpZ = NULL;
+	mcElements = 0;
+	mCapacity = 0;
+	resize(size);
+}
+
+Vec3FloatArray::Vec3FloatArray(const Vec3Float* pVectors, int cVectors)
+{
+	mpX = NULL;
+	mpY = NULL;
+	mpZ = NULL;
+	mcElements = 0;
+	mCapacity = 0;
+	copyFrom(pVectors, cVectors);
+}
+
+Vec3FloatArray::Vec3FloatArray(const Vec3FloatArray& vec3FloatArray)
+{
+	mpX = NULL;
+	mpY = NULL;
+	mpZ = NULL;
+	mcElements = 0;
+	mCapacity = 0;
+	*this = vec3FloatArray;
+}
+
+Vec3FloatArray::~Vec3FloatArray()
+{
+	if (mpX != NULL)
+	{
+		_mm_free(mpX);
+	}
+}
+
+Vec3FloatArray& Vec3FloatArray::operator=(const Vec3FloatArray& vec3FloatArray)
+{
+	if (this != &vec3FloatArray)
+	{
+		resize(vec3FloatArray.mcElements);
+		for (int i = 0; i < mcElements; i++)
+		{
+			mpX[i] = vec3FloatArray.mpX[i];
+			mpY[i] = vec3FloatArray.mpY[i];
+			mpZ[i] = vec3FloatArray.mpZ[i];
+		}
+	}
+	return *this;
+}
+
+void Vec3FloatArray::resize(int size)
+{
+	if (size > mCapacity)
+	{
+		// Round up to whole SSE registers
+		reallocate((size + 3) & ~3);
+	}
+
+	for (int i = mcElements; i < size; i++)
+	{
+		mpX[i] = 0.0f;
+		mpY[i] = 0.0f;
+		mpZ[i] = 0.0f;
+	}
+	mcElements = size;
+}
+
+Vec3Float Vec3FloatArray::get(int index) const
+{
+	if (index < 0 || index >= mcElements)
+	{
+		throw IndexOutOfBoundsException();
+	}
+	return Vec3Float(mpX[index], mpY[index], mpZ[index]);
+}
+
+void Vec3FloatArray::set(int index, const Vec3Float& vec3Float)
+{
+	if (index < 0 || index >= mcElements)
+	{
+		throw IndexOutOfBoundsException();
+	}
+	mpX[index] = vec3Float.x;
+	mpY[index] = vec3Float.y;
+	mpZ[index] = vec3Float.z;
+}
+
+void Vec3FloatArray::copyFrom(const Vec3Float* pVectors, int cVectors)
+{
+	resize(cVectors);
+	for (int i = 0; i < cVectors; i++)
+	{
+		mpX[i] = pVectors[i].x;
+		mpY[i] = pVectors[i].y;
+		mpZ[i] = pVectors[i].z;
+	}
+}
+
+void Vec3FloatArray::copyTo(Vec3Float* pVectors) const
+{
+	for (int i = 0; i < mcElements; i++)
+	{
+		pVectors[i].x = mpX[i];
+		pVectors[i].y = mpY[i];
+		pVectors[i].z = mpZ[i];
+	}
+}
+
+void Vec3FloatArray::add(const Vec3FloatArray& vec3FloatArray)
+{
+	if (vec3FloatArray.mcElements != mcElements)
+	{
+		throw SizeMismatchException();
+	}
+
+	// Whole SSE registers first, then the rest one by one
+	int cSimd = mcElements & ~3;
+	for (int i = 0; i < cSimd; i += 4)
+	{
+		_mm_store_ps(mpX + i, _mm_add_ps(_mm_load_ps(mpX + i), _mm_load_ps(vec3FloatArray.mpX + i)));
+		_mm_store_ps(mpY + i, _mm_add_ps(_mm_load_ps(mpY + i), _mm_load_ps(vec3FloatArray.mpY + i)));
+		_mm_store_ps(mpZ + i, _mm_add_ps(_mm_load_ps(mpZ + i), _mm_load_ps(vec3FloatArray.mpZ + i)));
+	}
+	for (int i = cSimd; i < mcElements; i++)
+	{
+		mpX[i] += vec3FloatArray.mpX[i];
+		mpY[i] += vec3FloatArray.mpY[i];
+		mpZ[i] += vec3FloatArray.mpZ[i];
+	}
+}
+
+void Vec3FloatArray::scale(float value)
+{
+	__m128 values = _mm_set1_ps(value);
+	int cSimd = mcElements & ~3;
+	for (int i = 0; i < cSimd; i += 4)
+	{
+		_mm_store_ps(mpX + i, _mm_mul_ps(_mm_load_ps(mpX + i), values));
+		_mm_store_ps(mpY + i, _mm_mul_ps(_mm_load_ps(mpY + i), values));
+		_mm_store_ps(mpZ + i, _mm_mul_ps(_mm_load_ps(mpZ + i), values));
+	}
+	for (int i = cSimd; i < mcElements; i++)
+	{
+		mpX[i] *= value;
+		mpY[i] *= value;
+		mpZ[i] *= value;
+	}
+}
+
+void Vec3FloatArray::multiplyAdd(const Vec3FloatArray& vec3FloatArray, float value)
+{
+	if (vec3FloatArray.mcElements != mcElements)
+	{
+		throw SizeMismatchException();
+	}
+
+	__m128 values = _mm_set1_ps(value);
+	int cSimd = mcElements & ~3;
+	for (int i = 0; i < cSimd; i += 4)
+	{
+		_mm_store_ps(mpX + i, _mm_add_ps(_mm_load_ps(mpX + i), _mm_mul_ps(_mm_load_ps(vec3FloatArray.mpX + i), values)));
+		_mm_store_ps(mpY + i, _mm_add_ps(_mm_load_ps(mpY + i), _mm_mul_ps(_mm_load_ps(vec3FloatArray.mpY + i), values)));
+		_mm_store_ps(mpZ + i, _mm_add_ps(_mm_load_ps(mpZ + i), _mm_mul_ps(_mm_load_ps(vec3FloatArray.mpZ + i), values)));
+	}
+	for (int i = cSimd; i < mcElements; i++)
+	{
+		mpX[i] += vec3FloatArray.mpX[i] * value;
+		mpY[i] += vec3FloatArray.mpY[i] * value;
+		mpZ[i] += vec3FloatArray.mpZ[i] * value;
+	}
+}
+
+void Vec3FloatArray::getLengths(float* pLengths) const
+{
+	// pLengths isn't necessarily aligned
+	int cSimd = mcElements & ~3;
+	for (int i = 0; i < cSimd; i += 4)
+	{
+		__m128 x = _mm_load_ps(mpX + i);
+		__m128 y = _mm_load_ps(mpY + i);
+		__m128 z = _mm_load_ps(mpZ + i);
+		__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		_mm_storeu_ps(pLengths + i, _mm_sqrt_ps(lengthSq));
+	}
+	for (int i = cSimd; i < mcElements; i++)
+	{
+		pLengths[i] = sqrtf(mpX[i]*mpX[i] + mpY[i]*mpY[i] + mpZ[i]*mpZ[i]);
+	}
+}
+
+void Vec3FloatArray::normalize()
+{
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+	int cSimd = mcElements & ~3;
+	for (int i = 0; i < cSimd; i += 4)
+	{
+		__m128 x = _mm_load_ps(mpX + i);
+		__m128 y = _mm_load_ps(mpY + i);
+		__m128 z = _mm_load_ps(mpZ + i);
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+
+		// Divide zero length vectors with 1 instead so they stay zero, like Vec3Float::normalize()
+		__m128 zeroMask = _mm_cmpeq_ps(length, zero);
+		length = _mm_or_ps(_mm_andnot_ps(zeroMask, length), _mm_and_ps(zeroMask, one));
+
+		_mm_store_ps(mpX + i, _mm_div_ps(x, length));
+		_mm_store_ps(mpY + i, _mm_div_ps(y, length));
+		_mm_store_ps(mpZ + i, _mm_div_ps(z, length));
+	}
+	for (int i = cSimd; i < mcElements; i++)
+	{
+		float length = sqrtf(mpX[i]*mpX[i] + mpY[i]*mpY[i] + mpZ[i]*mpZ[i]);
+		if (length != 0.0f)
+		{
+			mpX[i] /= length;
+			mpY[i] /= length;
+			mpZ[i] /= length;
+		}
+	}
+}
+
+void Vec3FloatArray::rotateAroundY(float radian)
+{
+	float sine = 0.0f;
+	float cosine = 0.0f;
+	math::fastSinCos(radian, sine, cosine);
+
+	__m128 sines = _mm_set1_ps(sine);
+	__m128 cosines = _mm_set1_ps(cosine);
+	int cSimd = mcElements & ~3;
+	for (int i = 0; i < cSimd; i += 4)
+	{
+		__m128 x = _mm_load_ps(mpX + i);
+		__m128 z = _mm_load_ps(mpZ + i);
+		_mm_store_ps(mpX + i, _mm_sub_ps(_mm_mul_ps(cosines, x), _mm_mul_ps(sines, z)));
+		_mm_store_ps(mpZ + i, _mm_add_ps(_mm_mul_ps(sines, x), _mm_mul_ps(cosines, z)));
+	}
+	for (int i = cSimd; i < mcElements; i++)
+	{
+		float tempX = cosine * mpX[i] - sine * mpZ[i];
+		mpZ[i] = sine * mpX[i] + cosine * mpZ[i];
+		mpX[i] = tempX;
+	}
+}
+
+void Vec3FloatArray::rotateAroundY(const float* pRadians)
+{
+	int cSimd = mcElements & ~3;
+	for (int i = 0; i < cSimd; i += 4)
+	{
+		__m128 sines;
+		__m128 cosines;
+		math::fastSinCos4(_mm_loadu_ps(pRadians + i), sines, cosines);
+
+		__m128 x = _mm_load_ps(mpX + i);
+		__m128 z = _mm_load_ps(mpZ + i);
+		_mm_store_ps(mpX + i, _mm_sub_ps(_mm_mul_ps(cosines, x), _mm_mul_ps(sines, z)));
+		_mm_store_ps(mpZ + i, _mm_add_ps(_mm_mul_ps(sines, x), _mm_mul_ps(cosines, z)));
+	}
+	for (int i = cSimd; i < mcElements; i++)
+	{
+		float sine = 0.0f;
+		float cosine = 0.0f;
+		math::fastSinCos(pRadians[i], sine, cosine);
+
+		float tempX = cosine * mpX[i] - sine * mpZ[i];
+		mpZ[i] = sine * mpX[i] + cosine * mpZ[i];
+		mpX[i] = tempX;
+	}
+}
+
+void Vec3FloatArray::getDistancesTo(const Vec3Float& point, float* pDistances) const
+{
+	__m128 pointX = _mm_set1_ps(point.x);
+	__m128 pointY = _mm_set1_ps(point.y);
+	__m128 pointZ = _mm_set1_ps(point.z);
+	int cSimd = mcElements & ~3;
+	for (int i = 0; i < cSimd; i += 4)
+	{
+		__m128 diffX = _mm_sub_ps(_mm_load_ps(mpX + i), pointX);
+		__m128 diffY = _mm_sub_ps(_mm_load_ps(mpY + i), pointY);
+		__m128 diffZ = _mm_sub_ps(_mm_load_ps(mpZ + i), pointZ);
+		__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(diffX, diffX), _mm_mul_ps(diffY, diffY)), _mm_mul_ps(diffZ, diffZ));
+		_mm_storeu_ps(pDistances + i, _mm_sqrt_ps(lengthSq));
+	}
+	for (int i = cSimd; i < mcElements; i++)
+	{
+		float diffX = mpX[i] - point.x;
+		float diffY = mpY[i] - point.y;
+		float diffZ = mpZ[i] - point.z;
+		pDistances[i] = sqrtf(diffX*diffX + diffY*diffY + diffZ*diffZ);
+	}
+}
+
+void Vec3FloatArray::reallocate(int capacity)
+{
+	// All three lanes in one block, each lane starts on a 16 byte boundary
+	// since the capacity is a multiple of 4.
+	float* pLanes = static_cast<float*>(_mm_malloc(3 * capacity * sizeof(float), 16));
+	if (pLanes == NULL)
+	{
+		throw std::bad_alloc();
+	}
+
+	for (int i = 0; i < mcElements; i++)
+	{
+		pLanes[i] = mpX[i];
+		pLanes[capacity + i] = mpY[i];
+		pLanes[2 * capacity + i] = mpZ[i];
+	}
+
+	if (mpX != NULL)
+	{
+		_mm_free(mpX);
+	}
+	mpX = pLanes;
+	mpY = pLanes + capacity;
+	mpZ = pLanes + 2 * capacity;
+	mCapacity = capacity;
+}
\ No newline at end of file
@@ -0,0 +1,263 @@
+/**
+* @file
+* @author Matteus Magnusson <senth.wallace@gmail.com>
+* @version 1.0
+* Copyright () A-Team.
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; either version 2 of
+* the License, or (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details at
+* http://www.gnu.org/copyleft/gpl.html
+* 
+* @section DESCRIPTION
+*
+* An array of Vec3Float stored as structure of arrays, i.e. one array with all
+* x-values, one with all y-values and one with all z-values. This makes it
+* possible to operate on four vectors at a time with SSE.
+*/
+
+#ifndef __VEC3_FLOAT_ARRAY_H__
+#define __VEC3_FLOAT_ARRAY_H__
+
+#include "Vectors.h"
+#include "Exception.h"
+
+namespace utilities
+{
+
+/**
+* Structure of arrays version of Vec3Float arrays. Each lane is 16 byte aligned
+* so the batch operations can process four vectors per instruction. Use it for
+* data that is updated in bulk every frame, e.g. positions and velocities:
+* @code
+* positions.multiplyAdd(velocities, deltaTime);
+* @endcode
+* The lanes can be accessed directly with getX(), getY() and getZ() for loops
+* that don't have a batch operation.
+*/
+class Vec3FloatArray
+{
+public:
+	/**
+	* Thrown when a batch operation is used on two arrays of different size
+	*/
+	class SizeMismatchException : public Exception
+	{
+	public:
+		SizeMismatchException() : Exception("Vec3FloatArraySizeMismatchException: The arrays have different sizes!", 70009) {}
+	};
+
+	/**
+	* Thrown when trying to access an element outside the array
+	*/
+	class IndexOutOfBoundsException : public Exception
+	{
+	public:
+		IndexOutOfBoundsException() : Exception("Vec3FloatArrayIndexOutOfBoundsException: Index is out of bounds!", 70010) {}
+	};
+
+	/**
+	* Constructor, all vectors are set to 0
+	* @param size number of vectors in the array
+	*/
+	explicit Vec3FloatArray(int size = 0);
+
+	/**
+	* Constructor that converts an array of Vec3Float
+	* @param pVectors the vectors to copy
+	* @param cVectors number of vectors in pVectors
+	*/
+	Vec3FloatArray(const Vec3Float* pVectors, int cVectors);
+
+	/**
+	* Copy constructor
+	* @param vec3FloatArray the array to copy
+	*/
+	Vec3FloatArray(const Vec3FloatArray& vec3FloatArray);
+
+	/**
+	* Destructor
+	*/
+	~Vec3FloatArray();
+
+	/**
+	* Assignment operator
+	* @param vec3FloatArray the array to copy
+	* @return reference to this array
+	*/
+	Vec3FloatArray& operator=(const Vec3FloatArray& vec3FloatArray);
+
+	/**
+	* Changes the number of vectors in the array, new vectors are set to 0
+	* @param size the new number of vectors
+	*/
+	void resize(int size);
+
+	/**
+	* Returns the number of vectors in the array
+	* @return number of vectors
+	*/
+	inline int size() const
+	{
+		return mcElements;
+	}
+
+	/**
+	* Returns the vector at the specified index
+	* @param index the index of the vector
+	* @return the vector at index
+	* @throws IndexOutOfBoundsException if the index is out of bounds
+	*/
+	Vec3Float get(int index) const;
+
+	/**
+	* Sets the vector at the specified index
+	* @param index the index of the vector
+	* @param vec3Float the new value
+	* @throws IndexOutOfBoundsException if the index is out of bounds
+	*/
+	void set(int index, const Vec3Float& vec3Float);
+
+	/**
+	* Copies Vec3Floats into the array, the array is resized to cVectors
+	* @param pVectors the vectors to copy
+	* @param cVectors number of vectors in pVectors
+	*/
+	void copyFrom(const Vec3Float* pVectors, int cVectors);
+
+	/**
+	* Copies the array to Vec3Floats
+	* @param pVectors array with room for size() vectors
+	*/
+	void copyTo(Vec3Float* pVectors) const;
+
+	/**
+	* Adds the vectors of another array, this[i] += vec3FloatArray[i]
+	* @param vec3FloatArray the array to add, needs to have the same size
+	* @throws SizeMismatchException if the arrays have different sizes
+	*/
+	void add(const Vec3FloatArray& vec3FloatArray);
+
+	/**
+	* Multiplies all vectors with a value, this[i] *= value
+	* @param value the value to multiply with
+	*/
+	void scale(float value);
+
+	/**
+	* Adds the scaled vectors of another array, this[i] += vec3FloatArray[i] * value.
+	* Typically used to integrate positions with velocities.
+	* @param vec3FloatArray the array to add, needs to have the same size
+	* @param value the value to multiply vec3FloatArray with
+	* @throws SizeMismatchException if the arrays have different sizes
+	*/
+	void multiplyAdd(const Vec3FloatArray& vec3FloatArray, float value);
+
+	/**
+	* Calculates the length of all vectors
+	* @param pLengths array with room for size() floats
+	*/
+	void getLengths(float* pLengths) const;
+
+	/**
+	* Sets the length of all vectors to 1, vectors with length 0 are left as they are
+	*/
+	void normalize();
+
+	/**
+	* Rotates all vectors around y with the same angle
+	* @param radian the angle to rotate in radians
+	* @see Vec3Float::rotateAroundY()
+	*/
+	void rotateAroundY(float radian);
+
+	/**
+	* Rotates each vector around y with its own angle, e.g. the turn rate of each
+	* bug this frame. The sines and cosines are calculated four at a time with
+	* math::fastSinCos4(), see FastMath.h for the error bounds.
+	* @param pRadians array with size() angles in radians
+	*/
+	void rotateAroundY(const float* pRadians);
+
+	/**
+	* Calculates the distance from all vectors to a point
+	* @param point the point to measure to
+	* @param pDistances array with room for size() floats
+	*/
+	void getDistancesTo(const Vec3Float& point, float* pDistances) const;
+
+	/**
+	* Returns the x-values, the lane is 16 byte aligned
+	* @return pointer to the x-values
+	*/
+	inline float* getX()
+	{
+		return mpX;
+	}
+
+	/**
+	* Returns the y-values, the lane is 16 byte aligned
+	* @return pointer to the y-values
+	*/
+	inline float* getY()
+	{
+		return mpY;
+	}
+
+	/**
+	* Returns the z-values, the lane is 16 byte aligned
+	* @return pointer to the z-values
+	*/
+	inline float* getZ()
+	{
+		return mpZ;
+	}
+
+	/**
+	* @see getX()
+	*/
+	inline const float* getX() const
+	{
+		return mpX;
+	}
+
+	/**
+	* @see getY()
+	*/
+	inline const float* getY() const
+	{
+		return mpY;
+	}
+
+	/**
+	* @see getZ()
+	*/
+	inline const float* getZ() const
+	{
+		return mpZ;
+	}
+
+private:
+	/**
+	* Allocates new lanes, the old ones are copied and freed
+	* @param capacity the new capacity, needs to be a multiple of 4
+	*/
+	void reallocate(int capacity);
+
+	float*	mpX;
+	float*	mpY;
+	float*	mpZ;
+	int		mcElements;
+	int		mCapacity;	/**< Number of floats in each lane, always a multiple of 4 */
+};
+}
+
+#endif
\ No newline at end of file
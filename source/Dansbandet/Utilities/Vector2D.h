@@ -43,6 +43,15 @@ public:
 		IndexOutOfBoundsException() : Exception("Vector2DIndexOutOfBoundsException: Index is out of bounds!", 70003) {}
 	};
 
+	/**
+	* Thrown when trying to modify a read-only vector, i.e. a view of external data.
+	*/
+	class ReadOnlyException : public Exception
+	{
+	public:
+		ReadOnlyException() : Exception("Vector2DReadOnlyException: Can't modify a read-only Vector2D!", 70004) {}
+	};
+
 	/**
 	* Constructor.
 	* @param width the width of the vector
@@ -54,6 +63,7 @@ public:
 	{
 		mWidthOffset = 0;
 		mHeightOffset = 0;
+		mOwnsArray = true;
 
 		// Calculate the size
 		mSize = mWidth * mHeight;
@@ -68,12 +78,35 @@ public:
 		}
 	}
 
+	/**
+	* Constructor for a read-only view of already existing data, e.g. a memory mapped
+	* map file. The data is neither copied nor initialized and the vector doesn't take
+	* ownership of it, thus the data has to outlive the vector.
+	* @param width the width of the vector
+	* @param height the height of the vector
+	* @param pData the row-major data with width * height elements
+	* @note the vector can't be shifted and the non-const version of get() throws
+	* ReadOnlyException, access it through a const reference.
+	*/
+	Vector2D(int width, int height, const T* pData)
+		: mWidth(width), mHeight(height), mDefaultValue(T())
+	{
+		mWidthOffset = 0;
+		mHeightOffset = 0;
+		mOwnsArray = false;
+		mSize = mWidth * mHeight;
+		mpArray = const_cast<T*>(pData);
+	}
+
 	/**
 	* Destructor
 	*/
 	~Vector2D()
 	{
-		SAFE_DELETE_ARRAY(mpArray);
+		if (mOwnsArray)
+		{
+			SAFE_DELETE_ARRAY(mpArray);
+		}
 	}
 
 	/**
@@ -82,28 +115,12 @@ public:
 	* @param y the y-coordinate
 	* @return reference to the element at the specified location
 	* @throws Vector2DIndexOutOfBoundsException
+	* @throws ReadOnlyException if the vector is read-only
 	*/
-	T& get(int x, int y)
+	inline T& get(int x, int y)
 	{
-		if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
-		{
-			throw IndexOutOfBoundsException();
-		}
-
-		int actualX = x + mWidthOffset;
-		int actualY = y + mHeightOffset;
-
-		// wrap the actual coordinates
-		if (actualX >= mWidth)
-		{
-			actualX -= mWidth;
-		}
-		if (actualY >= mHeight)
-		{
-			actualY -= mHeight;
-		}
-
-		return mpArray[actualY*mWidth + actualX];
+		checkWritable();
+		return mpArray[getIndex(x, y)];
 	}
 
 	/**
@@ -115,16 +132,105 @@ public:
 	*/
 	inline const T& get(int x, int y) const
 	{
-		return get(x, y);
+		return mpArray[getIndex(x, y)];
+	}
+
+	/**
+	* Returns the element at the specified location together with the number of
+	* elements to the right of it that are stored contiguously, i.e. until the
+	* end of the row or where the row wraps because of the shifting.
+	* @param x the x-coordinate
+	* @param y the y-coordinate
+	* @param[out] cContiguous set to the number of contiguous elements
+	* @return pointer to the element at the specified location
+	* @throws Vector2DIndexOutOfBoundsException
+	* @throws ReadOnlyException if the vector is read-only
+	*/
+	inline T* getRowSegment(int x, int y, int& cContiguous)
+	{
+		checkWritable();
+		return const_cast<T*>(static_cast<const Vector2D&>(*this).getRowSegment(x, y, cContiguous));
+	}
+
+	/**
+	* @see getRowSegment(int, int, int&)
+	*/
+	inline const T* getRowSegment(int x, int y, int& cContiguous) const
+	{
+		int index = getIndex(x, y);
+		int actualX = index % mWidth;
+		cContiguous = mWidth - (x > actualX ? x : actualX);
+		return mpArray + index;
+	}
+
+	/**
+	* Returns the width of the vector
+	* @return width of the vector
+	*/
+	inline int getWidth() const
+	{
+		return mWidth;
+	}
+
+	/**
+	* Returns the height of the vector
+	* @return height of the vector
+	*/
+	inline int getHeight() const
+	{
+		return mHeight;
+	}
+
+	/**
+	* Checks if the vector is a read-only view of external data
+	* @return true if the vector is read-only
+	*/
+	inline bool isReadOnly() const
+	{
+		return !mOwnsArray;
+	}
+
+	/**
+	* Copies all elements, in row-major order with the shifting applied, to the
+	* specified array. I.e. pDestination[y*width + x] will be equal to get(x, y).
+	* @param pDestination the array to copy to, needs to hold width * height elements
+	*/
+	void copyTo(T* pDestination) const
+	{
+		for (int y = 0; y < mHeight; y++)
+		{
+			int actualY = y + mHeightOffset;
+			if (actualY >= mHeight)
+			{
+				actualY -= mHeight;
+			}
+
+			const T* pRow = mpArray + actualY*mWidth;
+			T* pDestinationRow = pDestination + y*mWidth;
+
+			// The row is split in two parts when we have a width offset
+			int cFirstPart = mWidth - mWidthOffset;
+			for (int x = 0; x < cFirstPart; x++)
+			{
+				pDestinationRow[x] = pRow[mWidthOffset + x];
+			}
+			for (int x = cFirstPart; x < mWidth; x++)
+			{
+				pDestinationRow[x] = pRow[x - cFirstPart];
+			}
+		}
 	}
 
 	/**
 	* Shifts the whole array to the left. If we don't wrap the vector's elements
 	* are set to the default value.
 	* @param wrap if we should wrap the values.
+	* @throws ReadOnlyException if the vector is read-only
 	*/
 	void shiftLeft(bool wrap)
 	{
+		checkWritable();
+
 		mWidthOffset++;
 		if (mWidthOffset >= mWidth)
 		{
@@ -154,9 +260,12 @@ public:
 	* Shifts the whole array to the right. If we don't wrap the vector's elements
 	* are set to the default value.
 	* @param wrap if we should wrap the values.
+	* @throws ReadOnlyException if the vector is read-only
 	*/
 	void shiftRight(bool wrap)
 	{
+		checkWritable();
+
 		mWidthOffset--;
 		if (mWidthOffset < 0)
 		{
@@ -177,9 +286,12 @@ public:
 	* Shifts the whole array upwards. If we don't wrap the vector's elements
 	* are set to the default value.
 	* @param wrap if we should wrap the values.
+	* @throws ReadOnlyException if the vector is read-only
 	*/
 	void shiftUp(bool wrap)
 	{
+		checkWritable();
+
 		mHeightOffset++;
 		if (mHeightOffset >= mHeight)
 		{
@@ -211,9 +323,12 @@ public:
 	* Shifts the whole array downwards. If we don't wrap the vector's elements
 	* are set to the default value.
 	* @param wrap if we should wrap the values.
+	* @throws ReadOnlyException if the vector is read-only
 	*/
 	void shiftDown(bool wrap)
 	{
+		checkWritable();
+
 		mHeightOffset--;
 		if (mHeightOffset < 0)
 		{
@@ -234,6 +349,48 @@ public:
 	}
 
 private:
+	/**
+	* Returns the index in the array for the specified location
+	* @param x the x-coordinate
+	* @param y the y-coordinate
+	* @return index in mpArray for the specified location
+	* @throws Vector2DIndexOutOfBoundsException
+	*/
+	int getIndex(int x, int y) const
+	{
+		if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
+		{
+			throw IndexOutOfBoundsException();
+		}
+
+		int actualX = x + mWidthOffset;
+		int actualY = y + mHeightOffset;
+
+		// wrap the actual coordinates
+		if (actualX >= mWidth)
+		{
+			actualX -= mWidth;
+		}
+		if (actualY >= mHeight)
+		{
+			actualY -= mHeight;
+		}
+
+		return actualY*mWidth + actualX;
+	}
+
+	/**
+	* Checks that we're allowed to modify the vector
+	* @throws ReadOnlyException if the vector is read-only
+	*/
+	inline void checkWritable() const
+	{
+		if (!mOwnsArray)
+		{
+			throw ReadOnlyException();
+		}
+	}
+
 	T	mDefaultValue;	/**< The default value that all elements in the vector will have */
 	T*	mpArray;		/**< The 2D array we're simulating */
 	int mHeight;		/**< The height of the array */
@@ -241,6 +398,7 @@ private:
 	int mHeightOffset;	/**< The height offset that is the actual start y-position */
 	int mWidthOffset;	/**< The width offset that is the actual start x-position */
 	int mSize;			/**< The size/elements the vector contains */
+	bool mOwnsArray;	/**< If we have allocated mpArray ourselves, false for read-only views */
 };
 }
 
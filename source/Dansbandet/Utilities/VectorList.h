@@ -203,6 +203,44 @@ public:
 		return mpArray[arrayIndex];
 	}
 
+	/**
+	* Returns the element at the specified index together with the number of
+	* elements after it that are stored contiguously, i.e. until the end of the
+	* list or where the list wraps around the end of the array.
+	* @throws IndexOutOfBoundsException
+	* @param index the index of the first element
+	* @param[out] cContiguous set to the number of contiguous elements
+	* @return pointer to the element at the specified index
+	*/
+	T* getSegment(int index, int& cContiguous)
+	{
+		return const_cast<T*>(static_cast<const VectorList&>(*this).getSegment(index, cContiguous));
+	}
+
+	/**
+	* @see getSegment(int, int&)
+	*/
+	const T* getSegment(int index, int& cContiguous) const
+	{
+		if (index < 0 || index >= mcElements)
+		{
+			throw IndexOutOfBoundsException();
+		}
+
+		int arrayIndex = mBegin + index;
+		if (arrayIndex >= mArraySize)
+		{
+			arrayIndex -= mArraySize;
+		}
+
+		cContiguous = mcElements - index;
+		if (cContiguous > mArraySize - arrayIndex)
+		{
+			cContiguous = mArraySize - arrayIndex;
+		}
+		return mpArray + arrayIndex;
+	}
+
 	/**
 	* Returns the size of the VectorList
 	* @return the number of elements in the vectorlist